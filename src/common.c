@@ -1395,12 +1395,12 @@ lyb_hash(struct lys_node *sibling, uint8_t collision_id)
 
     mod = lys_node_module(sibling);
 
-    full_hash = dict_hash_multi(0, mod->name, strlen(mod->name));
-    full_hash = dict_hash_multi(full_hash, sibling->name, strlen(sibling->name));
+    full_hash = dict_hash_multi(0, mod->name, lydict_len(mod->name));
+    full_hash = dict_hash_multi(full_hash, sibling->name, lydict_len(sibling->name));
     if (collision_id) {
-        if (collision_id > strlen(mod->name)) {
+        if (collision_id > lydict_len(mod->name)) {
             /* fine, we will not hash more bytes, just use more bits from the hash than previously */
-            ext_len = strlen(mod->name);
+            ext_len = lydict_len(mod->name);
         } else {
             /* use one more byte from the module name than before */
             ext_len = collision_id;
@@ -1439,6 +1439,149 @@ lyb_has_schema_model(struct lys_node *sibling, const struct lys_module **models,
     return 0;
 }
 
+/**
+ * @brief Context cache of LYB sibling hash tables.
+ *
+ * The hashes of schema node siblings depend only on the siblings themselves, so the tables are built
+ * once for each parent, module, and user (printer or parser) and shared by all the LYB printers and parsers
+ * of the context until its module set changes.
+ */
+struct lyb_sib_cache {
+    struct hash_table *tables;   /* struct lyb_sib_cache_rec */
+    uint16_t built_set_id;       /* module set ID the tables were built for */
+    pthread_rwlock_t lock;
+};
+
+struct lyb_sib_cache_rec {
+    const struct lys_node *parent;
+    const struct lys_module *mod;
+    int parser;
+    struct hash_table *ht;
+};
+
+static int
+lyb_sib_cache_rec_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lyb_sib_cache_rec *rec1 = val1_p, *rec2 = val2_p;
+
+    return (rec1->parent == rec2->parent) && (rec1->mod == rec2->mod) && (rec1->parser == rec2->parser);
+}
+
+static void
+lyb_sib_cache_clear(struct lyb_sib_cache *cache)
+{
+    struct ht_rec *rec;
+    uint32_t i;
+
+    if (!cache->tables) {
+        return;
+    }
+
+    for (i = 0; i < cache->tables->size; ++i) {
+        rec = lyht_get_rec(cache->tables->recs, cache->tables->rec_size, i);
+        if (rec->hits > 0) {
+            lyht_free(((struct lyb_sib_cache_rec *)&rec->val)->ht);
+        }
+    }
+    lyht_free(cache->tables);
+    cache->tables = NULL;
+}
+
+struct lyb_sib_cache *
+lyb_sib_cache_new(void)
+{
+    struct lyb_sib_cache *cache;
+
+    cache = calloc(1, sizeof *cache);
+    LY_CHECK_ERR_RETURN(!cache, LOGMEM(NULL), NULL);
+    pthread_rwlock_init(&cache->lock, NULL);
+
+    return cache;
+}
+
+void
+lyb_sib_cache_free(struct lyb_sib_cache *cache)
+{
+    if (!cache) {
+        return;
+    }
+
+    lyb_sib_cache_clear(cache);
+    pthread_rwlock_destroy(&cache->lock);
+    free(cache);
+}
+
+struct hash_table *
+lyb_sib_cache_get(struct ly_ctx *ctx, const struct lys_node *parent, const struct lys_module *mod, int parser,
+                  lyb_sib_build_clb build, int *dynamic)
+{
+    struct lyb_sib_cache *cache = ctx->lyb_sib_cache;
+    struct lyb_sib_cache_rec rec, *match;
+    struct hash_table *ht;
+    uint32_t hash;
+
+    *dynamic = 1;
+    if (!cache || ctx->models.parsing_sub_modules_count) {
+        /* the schema is being changed */
+        return build(parent, mod);
+    }
+
+    rec.parent = parent;
+    rec.mod = mod;
+    rec.parser = parser;
+    hash = dict_hash_multi(0, (const char *)&parent, sizeof parent);
+    hash = dict_hash_multi(hash, (const char *)&mod, sizeof mod);
+    hash = dict_hash_multi(hash, (const char *)&parser, sizeof parser);
+    hash = dict_hash_multi(hash, NULL, 0);
+
+    pthread_rwlock_rdlock(&cache->lock);
+    if (cache->tables && (cache->built_set_id == ctx->models.module_set_id)
+            && !lyht_find(cache->tables, &rec, hash, (void **)&match)) {
+        ht = match->ht;
+        pthread_rwlock_unlock(&cache->lock);
+        *dynamic = 0;
+        return ht;
+    }
+    pthread_rwlock_unlock(&cache->lock);
+
+    rec.ht = build(parent, mod);
+    if (!rec.ht) {
+        return NULL;
+    }
+
+    pthread_rwlock_wrlock(&cache->lock);
+    if (cache->built_set_id != ctx->models.module_set_id) {
+        /* the module set changed, all the tables may be invalid */
+        lyb_sib_cache_clear(cache);
+        cache->built_set_id = ctx->models.module_set_id;
+    }
+    if (!cache->tables) {
+        cache->tables = lyht_new(16, sizeof(struct lyb_sib_cache_rec), lyb_sib_cache_rec_equal, NULL, 1);
+        if (!cache->tables) {
+            pthread_rwlock_unlock(&cache->lock);
+            LOGMEM(ctx);
+            return rec.ht;
+        }
+    }
+    switch (lyht_insert(cache->tables, &rec, hash, (void **)&match)) {
+    case 0:
+        *dynamic = 0;
+        break;
+    case 1:
+        /* built by another thread in the meantime */
+        lyht_free(rec.ht);
+        rec.ht = match->ht;
+        *dynamic = 0;
+        break;
+    default:
+        /* keep the table only for the caller */
+        break;
+    }
+    pthread_rwlock_unlock(&cache->lock);
+
+    return rec.ht;
+}
+
 /**
  * @brief Static table of the UTF8 characters lengths according to their first byte.
  */
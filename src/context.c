@@ -13,6 +13,7 @@
  */
 
 #define _GNU_SOURCE
+#include <ctype.h>
 #include <pthread.h>
 #include <stddef.h>
 #include <stdlib.h>
@@ -30,6 +31,7 @@
 #include "parser.h"
 #include "tree_internal.h"
 #include "resolve.h"
+#include "xpath.h"
 
 /*
  * counter for references to the extensions plugins (for the number of contexts)
@@ -80,6 +82,176 @@ ly_ctx_internal_modules_count(struct ly_ctx *ctx)
     return ctx->internal_module_count;
 }
 
+/**
+ * @brief Record of a module in the context indexes.
+ */
+struct ly_ctx_mod_rec {
+    struct lys_module *mod;  /* indexed module, NULL in a lookup record */
+    uint32_t seq;            /* order of the module in the context list of modules */
+    const char *key;         /* lookup key (name or namespace) */
+    size_t key_len;          /* lookup key length */
+};
+
+static int
+ly_ctx_mod_rec_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *cb_data)
+{
+    struct ly_ctx_mod_rec *rec1 = val1_p, *rec2 = val2_p, *tmp;
+    const char *val;
+
+    if (rec1->mod && rec2->mod) {
+        return rec1->mod == rec2->mod;
+    } else if (!rec1->mod) {
+        /* rec1 is the indexed module, rec2 the lookup record */
+        tmp = rec1;
+        rec1 = rec2;
+        rec2 = tmp;
+    }
+
+    /* cb_data is the offset of the indexed string in the module */
+    val = *(char **)(((char *)rec1->mod) + (size_t)cb_data);
+    return !strncmp(rec2->key, val, rec2->key_len) && !val[rec2->key_len];
+}
+
+static uint32_t
+ly_ctx_mod_hash(const char *key, size_t key_len)
+{
+    return dict_hash_multi(dict_hash_multi(0, key, key_len), NULL, 0);
+}
+
+int
+ly_ctx_mod_index_add(struct lys_module *module)
+{
+    struct ly_modules_list *models = &module->ctx->models;
+    struct ly_ctx_mod_rec rec;
+
+    memset(&rec, 0, sizeof rec);
+    rec.mod = module;
+    rec.seq = ++models->last_seq;
+    if (lyht_insert(models->by_name, &rec, ly_ctx_mod_hash(module->name, strlen(module->name)), NULL) == -1) {
+        return -1;
+    }
+    if (lyht_insert(models->by_ns, &rec, ly_ctx_mod_hash(module->ns, strlen(module->ns)), NULL) == -1) {
+        lyht_remove(models->by_name, &rec, ly_ctx_mod_hash(module->name, strlen(module->name)));
+        return -1;
+    }
+
+    return 0;
+}
+
+void
+ly_ctx_mod_index_remove(struct lys_module *module)
+{
+    struct ly_modules_list *models = &module->ctx->models;
+    struct ly_ctx_mod_rec rec;
+
+    if (!models->by_name || !module->name || !module->ns) {
+        return;
+    }
+
+    memset(&rec, 0, sizeof rec);
+    rec.mod = module;
+    lyht_remove(models->by_name, &rec, ly_ctx_mod_hash(module->name, strlen(module->name)));
+    lyht_remove(models->by_ns, &rec, ly_ctx_mod_hash(module->ns, strlen(module->ns)));
+}
+
+/**
+ * @brief Kept source of a (sub)module.
+ */
+struct ly_ctx_mod_src {
+    const struct lys_module *mod; /* parsed (sub)module */
+    char *src;                    /* its source */
+    LYS_INFORMAT format;          /* format of the source */
+};
+
+static int
+ly_ctx_mod_src_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    return ((struct ly_ctx_mod_src *)val1_p)->mod == ((struct ly_ctx_mod_src *)val2_p)->mod;
+}
+
+static uint32_t
+ly_ctx_mod_src_hash(const struct lys_module *module)
+{
+    return ly_ctx_mod_hash((const char *)&module, sizeof module);
+}
+
+void
+ly_ctx_mod_src_add(const struct lys_module *module, const char *data, LYS_INFORMAT format)
+{
+    struct ly_modules_list *models = &module->ctx->models;
+    struct ly_ctx_mod_src rec;
+    int i, r;
+
+    if (!(models->flags & LY_CTX_KEEP_SOURCES)) {
+        /* the bundles print the parsed (sub)modules instead */
+        return;
+    }
+
+    if (!module->type) {
+        for (i = 0; i < module->ctx->internal_module_count && i < models->used; ++i) {
+            if (models->list[i] == module) {
+                /* internal modules are not stored in the bundles */
+                return;
+            }
+        }
+    }
+
+    if (!models->sources) {
+        models->sources = lyht_new(16, sizeof rec, ly_ctx_mod_src_equal, NULL, 1);
+        LY_CHECK_ERR_RETURN(!models->sources, LOGMEM(module->ctx), );
+    }
+
+    rec.mod = module;
+    rec.format = format;
+    rec.src = strdup(data);
+    LY_CHECK_ERR_RETURN(!rec.src, LOGMEM(module->ctx), );
+
+    r = lyht_insert(models->sources, &rec, ly_ctx_mod_src_hash(module), NULL);
+    if (r) {
+        /* already kept (the module was in the context before) or an error */
+        free(rec.src);
+        if (r == -1) {
+            LOGMEM(module->ctx);
+        }
+    }
+}
+
+/**
+ * @brief Get the kept source of a (sub)module.
+ *
+ * @param[in] module (Sub)module to get the source of.
+ * @return Kept source record, NULL if there is none.
+ */
+static const struct ly_ctx_mod_src *
+ly_ctx_mod_src_get(const struct lys_module *module)
+{
+    struct ly_ctx_mod_src rec, *match;
+
+    if (!module->ctx->models.sources) {
+        return NULL;
+    }
+
+    rec.mod = module;
+    if (lyht_find(module->ctx->models.sources, &rec, ly_ctx_mod_src_hash(module), (void **)&match)) {
+        return NULL;
+    }
+    return match;
+}
+
+void
+ly_ctx_mod_src_remove(const struct lys_module *module)
+{
+    const struct ly_ctx_mod_src *match;
+    struct ly_ctx_mod_src rec;
+
+    match = ly_ctx_mod_src_get(module);
+    if (match) {
+        rec = *match;
+        lyht_remove(module->ctx->models.sources, &rec, ly_ctx_mod_src_hash(module));
+        free(rec.src);
+    }
+}
+
 API struct ly_ctx *
 ly_ctx_new(const char *search_dir, int options)
 {
@@ -97,6 +269,7 @@ ly_ctx_new(const char *search_dir, int options)
 
     /* dictionary */
     lydict_init(&ctx->dict);
+    pthread_mutex_init(&ctx->compile_lock, NULL);
 
     /* plugins */
     ly_load_plugins();
@@ -113,6 +286,11 @@ ly_ctx_new(const char *search_dir, int options)
     ctx->models.flags = options;
     ctx->models.used = 0;
     ctx->models.size = 16;
+    ctx->models.by_name = lyht_new(16, sizeof(struct ly_ctx_mod_rec), ly_ctx_mod_rec_equal,
+                                   (void *)offsetof(struct lys_module, name), 1);
+    ctx->models.by_ns = lyht_new(16, sizeof(struct ly_ctx_mod_rec), ly_ctx_mod_rec_equal,
+                                 (void *)offsetof(struct lys_module, ns), 1);
+    LY_CHECK_ERR_GOTO(!ctx->models.by_name || !ctx->models.by_ns, LOGMEM(NULL), error);
     if (search_dir) {
         search_dir_list = strdup(search_dir);
         LY_CHECK_ERR_GOTO(!search_dir_list, LOGMEM(NULL), error);
@@ -131,6 +309,18 @@ ly_ctx_new(const char *search_dir, int options)
         }
     }
     ctx->models.module_set_id = 1;
+    ctx->xpath_cache = lyxp_expr_cache_new();
+    ctx->child_index = lys_child_index_new();
+    ctx->lyb_sib_cache = lyb_sib_cache_new();
+    if (!ctx->xpath_cache || !ctx->child_index || !ctx->lyb_sib_cache) {
+        goto error;
+    }
+#ifdef LY_ENABLED_CACHE
+    ctx->pattern_cache = lyp_pattern_cache_new();
+    if (!ctx->pattern_cache) {
+        goto error;
+    }
+#endif
 
     /* load internal modules */
     if (options & LY_CTX_NOYANGLIBRARY) {
@@ -157,69 +347,66 @@ error:
 static int
 ly_ctx_new_yl_legacy(struct ly_ctx *ctx, struct lyd_node *yltree)
 {
-    unsigned int i, u;
-    struct lyd_node *module, *node;
+    unsigned int i;
+    struct lyd_node *node;
     struct ly_set *set;
-    const char *name, *revision;
-    struct ly_set features = {0, 0, {NULL}};
-    const struct lys_module *mod;
+    const char **names = NULL, **revisions = NULL;
+    const struct lys_module **mods = NULL;
+    int ret = 1;
 
     set = lyd_find_path(yltree, "/ietf-yang-library:yang-library/modules-state/module");
     if (!set) {
         return 1;
     }
 
+    names = calloc(set->number, sizeof *names);
+    revisions = calloc(set->number, sizeof *revisions);
+    mods = calloc(set->number, sizeof *mods);
+    LY_CHECK_ERR_GOTO(set->number && (!names || !revisions || !mods), LOGMEM(ctx), cleanup);
+
     /* process the data tree */
     for (i = 0; i < set->number; ++i) {
-        module = set->set.d[i];
-
-        /* initiate */
-        name = NULL;
-        revision = NULL;
-        ly_set_clean(&features);
-
-        LY_TREE_FOR(module->child, node) {
+        LY_TREE_FOR(set->set.d[i]->child, node) {
             if (!strcmp(node->schema->name, "name")) {
-                name = ((struct lyd_node_leaf_list*)node)->value_str;
+                names[i] = ((struct lyd_node_leaf_list*)node)->value_str;
             } else if (!strcmp(node->schema->name, "revision")) {
-                revision = ((struct lyd_node_leaf_list*)node)->value_str;
-            } else if (!strcmp(node->schema->name, "feature")) {
-                ly_set_add(&features, node, LY_SET_OPT_USEASLIST);
-            } else if (!strcmp(node->schema->name, "conformance-type") &&
-                    ((struct lyd_node_leaf_list*)node)->value.enm->value) {
-                /* imported module - skip it, it will be loaded as a side effect
-                 * of loading another module */
-                continue;
+                revisions[i] = ((struct lyd_node_leaf_list*)node)->value_str;
             }
         }
+    }
 
-        /* use the gathered data to load the module */
-        mod = ly_ctx_load_module(ctx, name, revision);
-        if (!mod) {
-            LOGERR(ctx, LY_EINVAL, "Unable to load module specified by yang library data.");
-            ly_set_free(set);
-            return 1;
-        }
+    /* use the gathered data to load all the modules at once */
+    if (ly_ctx_load_modules(ctx, names, revisions, set->number, mods)) {
+        LOGERR(ctx, LY_EINVAL, "Unable to load module specified by yang library data.");
+        goto cleanup;
+    }
 
-        /* set features */
-        for (u = 0; u < features.number; u++) {
-            lys_features_enable(mod, ((struct lyd_node_leaf_list*)features.set.d[u])->value_str);
+    /* set features */
+    for (i = 0; i < set->number; ++i) {
+        LY_TREE_FOR(set->set.d[i]->child, node) {
+            if (!strcmp(node->schema->name, "feature")) {
+                lys_features_enable(mods[i], ((struct lyd_node_leaf_list*)node)->value_str);
+            }
         }
     }
+    ret = 0;
 
+cleanup:
+    free(names);
+    free(revisions);
+    free(mods);
     ly_set_free(set);
-    return 0;
+    return ret;
 }
 
 static struct ly_ctx *
 ly_ctx_new_yl_common(const char *search_dir, const char *input, LYD_FORMAT format, int options,
                      struct lyd_node* (*parser_func)(struct ly_ctx*, const char*, LYD_FORMAT, int,...))
 {
-    unsigned int i, u;
-    struct lyd_node *module, *node;
-    const char *name, *revision;
-    struct ly_set features = {0, 0, {NULL}};
-    const struct lys_module *mod;
+    unsigned int i;
+    struct lyd_node *node;
+    const char **names = NULL, **revisions = NULL;
+    const struct lys_module **mods = NULL;
     struct lyd_node *yltree = NULL;
     struct ly_ctx *ctx = NULL;
     struct ly_set *set = NULL;
@@ -248,35 +435,34 @@ ly_ctx_new_yl_common(const char *search_dir, const char *input, LYD_FORMAT forma
             goto error;
         }
     } else {
+        names = calloc(set->number, sizeof *names);
+        revisions = calloc(set->number, sizeof *revisions);
+        mods = calloc(set->number, sizeof *mods);
+        LY_CHECK_ERR_GOTO(!names || !revisions || !mods, LOGMEM(ctx), error);
+
         /* process the data tree */
         for (i = 0; i < set->number; ++i) {
-            module = set->set.d[i];
-
-            /* initiate */
-            name = NULL;
-            revision = NULL;
-            ly_set_clean(&features);
-
-            LY_TREE_FOR(module->child, node) {
+            LY_TREE_FOR(set->set.d[i]->child, node) {
                 if (!strcmp(node->schema->name, "name")) {
-                    name = ((struct lyd_node_leaf_list*)node)->value_str;
+                    names[i] = ((struct lyd_node_leaf_list*)node)->value_str;
                 } else if (!strcmp(node->schema->name, "revision")) {
-                    revision = ((struct lyd_node_leaf_list*)node)->value_str;
-                } else if (!strcmp(node->schema->name, "feature")) {
-                    ly_set_add(&features, node, LY_SET_OPT_USEASLIST);
+                    revisions[i] = ((struct lyd_node_leaf_list*)node)->value_str;
                 }
             }
+        }
 
-            /* use the gathered data to load the module */
-            mod = ly_ctx_load_module(ctx, name, revision);
-            if (!mod) {
-                LOGERR(NULL, LY_EINVAL, "Unable to load module specified by yang library data.");
-                goto error;
-            }
+        /* use the gathered data to load all the modules at once */
+        if (ly_ctx_load_modules(ctx, names, revisions, set->number, mods)) {
+            LOGERR(NULL, LY_EINVAL, "Unable to load module specified by yang library data.");
+            goto error;
+        }
 
-            /* set features */
-            for (u = 0; u < features.number; u++) {
-                lys_features_enable(mod, ((struct lyd_node_leaf_list*)features.set.d[u])->value_str);
+        /* set features */
+        for (i = 0; i < set->number; ++i) {
+            LY_TREE_FOR(set->set.d[i]->child, node) {
+                if (!strcmp(node->schema->name, "feature")) {
+                    lys_features_enable(mods[i], ((struct lyd_node_leaf_list*)node)->value_str);
+                }
             }
         }
     }
@@ -295,6 +481,9 @@ error:
     if (set) {
         ly_set_free(set);
     }
+    free(names);
+    free(revisions);
+    free(mods);
     if (err) {
         ly_ctx_destroy(ctx, NULL);
         ctx = NULL;
@@ -308,15 +497,712 @@ ly_ctx_new_ylpath(const char *search_dir, const char *path, LYD_FORMAT format, i
 {
     FUN_IN;
 
-    return ly_ctx_new_yl_common(search_dir, path, format, options, lyd_parse_path);
-}
+    return ly_ctx_new_yl_common(search_dir, path, format, options, lyd_parse_path);
+}
+
+API struct ly_ctx *
+ly_ctx_new_ylmem(const char *search_dir, const char *data, LYD_FORMAT format, int options)
+{
+    FUN_IN;
+
+    return ly_ctx_new_yl_common(search_dir, data, format, options, lyd_parse_mem);
+}
+
+#define LY_CTX_BUNDLE_MAGIC "LYCTXSRC"
+#define LY_CTX_BUNDLE_VERSION 1
+
+#define LY_CTX_BUNDLE_SUBMODULE   0x01 /**< record of a submodule */
+#define LY_CTX_BUNDLE_IMPLEMENTED 0x02 /**< module is implemented */
+#define LY_CTX_BUNDLE_DISABLED    0x04 /**< module is disabled */
+
+/**
+ * @brief Buffer the source bundle is printed into.
+ */
+struct ly_ctx_bundle_out {
+    char *buf;
+    size_t used;
+    size_t size;
+};
+
+/**
+ * @brief Module or submodule record of a loaded source bundle.
+ */
+struct ly_ctx_bundle_rec {
+    uint8_t flags;
+    uint8_t format;
+    const char *name;
+    const char *rev;             /**< NULL if the module has no revision */
+    const char *belongsto;       /**< name of the main module of a submodule */
+    uint32_t feat_count;
+    const char *feats;           /**< feat_count enabled feature names, each as a string record */
+    const char *src;             /**< NULL for internal modules */
+};
+
+/**
+ * @brief Loaded source bundle.
+ */
+struct ly_ctx_bundle {
+    uint32_t count;
+    struct ly_ctx_bundle_rec *recs;
+};
+
+static int
+ly_ctx_bundle_write(struct ly_ctx_bundle_out *out, const void *data, size_t len)
+{
+    char *new;
+
+    if (out->size - out->used < len) {
+        out->size = (out->size ? out->size : 4096);
+        while (out->size - out->used < len) {
+            out->size <<= 1;
+        }
+        new = realloc(out->buf, out->size);
+        LY_CHECK_ERR_RETURN(!new, LOGMEM(NULL), -1);
+        out->buf = new;
+    }
+
+    memcpy(out->buf + out->used, data, len);
+    out->used += len;
+    return 0;
+}
+
+/**
+ * @brief Write a string record - its length followed by the string and two terminating NULL bytes,
+ * so that even YANG sources can be parsed directly from the mapped bundle.
+ */
+static int
+ly_ctx_bundle_write_str(struct ly_ctx_bundle_out *out, const char *str)
+{
+    uint32_t len;
+
+    len = str ? strlen(str) : 0;
+    if (ly_ctx_bundle_write(out, &len, sizeof len) || ly_ctx_bundle_write(out, str ? str : "", len)
+            || ly_ctx_bundle_write(out, "\0\0", 2)) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Get the source of a (sub)module to be stored in the source bundle.
+ *
+ * @param[in] module (Sub)module to get the source of.
+ * @param[out] src Source, to be freed by the caller.
+ * @param[out] format Format of the source.
+ * @return 0 on success, -1 on error.
+ */
+static int
+ly_ctx_bundle_module_src(const struct lys_module *module, char **src, LYS_INFORMAT *format)
+{
+    const struct ly_ctx_mod_src *rec;
+
+    rec = ly_ctx_mod_src_get(module);
+    if (rec) {
+        /* the source the (sub)module was parsed from */
+        *src = strdup(rec->src);
+        LY_CHECK_ERR_RETURN(!*src, LOGMEM(module->ctx), -1);
+        *format = rec->format;
+        return 0;
+    }
+
+    if (!module->type && module->deviated) {
+        /* the printed module would include the deviations applied again when loading the deviating module */
+        LOGERR(module->ctx, LY_EINVAL, "Source of the deviated module \"%s\" is not available, the context must be"
+               " created with LY_CTX_KEEP_SOURCES.", module->name);
+        return -1;
+    }
+
+    /* no source was kept (no LY_CTX_KEEP_SOURCES or a module defined inside an extension instance),
+     * print the parsed (sub)module, the nodes from other modules are skipped */
+    if (lys_print_mem(src, module, LYS_OUT_YANG, NULL, 0, 0)) {
+        free(*src);
+        return -1;
+    }
+    *format = LYS_IN_YANG;
+    return 0;
+}
+
+static int
+ly_ctx_bundle_write_module(struct ly_ctx_bundle_out *out, const struct lys_module *module, int internal)
+{
+    const struct lys_module *mainmod;
+    struct lys_feature *f;
+    uint32_t count;
+    uint8_t flags, format;
+    LYS_INFORMAT src_format = LYS_IN_UNKNOWN;
+    char *src = NULL;
+    int i, j, ret = -1;
+
+    mainmod = lys_main_module(module);
+
+    flags = 0;
+    if (module->type) {
+        flags |= LY_CTX_BUNDLE_SUBMODULE;
+    } else {
+        if (module->implemented) {
+            flags |= LY_CTX_BUNDLE_IMPLEMENTED;
+        }
+        if (module->disabled) {
+            flags |= LY_CTX_BUNDLE_DISABLED;
+        }
+    }
+    if (!internal && ly_ctx_bundle_module_src(module, &src, &src_format)) {
+        return -1;
+    }
+    format = src_format;
+
+    if (ly_ctx_bundle_write(out, &flags, sizeof flags) || ly_ctx_bundle_write(out, &format, sizeof format)
+            || ly_ctx_bundle_write_str(out, module->name)
+            || ly_ctx_bundle_write_str(out, module->rev_size ? module->rev[0].date : NULL)
+            || ly_ctx_bundle_write_str(out, mainmod->name)) {
+        goto cleanup;
+    }
+
+    /* enabled features of the module and all its submodules */
+    count = 0;
+    for (i = -1; !module->type && (i < module->inc_size); ++i) {
+        for (j = 0; j < (i == -1 ? module->features_size : module->inc[i].submodule->features_size); ++j) {
+            f = (i == -1 ? &module->features[j] : &module->inc[i].submodule->features[j]);
+            if (f->flags & LYS_FENABLED) {
+                ++count;
+            }
+        }
+    }
+    if (ly_ctx_bundle_write(out, &count, sizeof count)) {
+        goto cleanup;
+    }
+    for (i = -1; !module->type && (i < module->inc_size); ++i) {
+        for (j = 0; j < (i == -1 ? module->features_size : module->inc[i].submodule->features_size); ++j) {
+            f = (i == -1 ? &module->features[j] : &module->inc[i].submodule->features[j]);
+            if ((f->flags & LYS_FENABLED) && ly_ctx_bundle_write_str(out, f->name)) {
+                goto cleanup;
+            }
+        }
+    }
+
+    /* source, empty for the internal modules */
+    if (ly_ctx_bundle_write_str(out, src)) {
+        goto cleanup;
+    }
+
+    ret = 0;
+
+cleanup:
+    free(src);
+    return ret;
+}
+
+/**
+ * @brief Print the source bundle into a memory buffer.
+ *
+ * @param[in] ctx Context to print.
+ * @param[out] out Buffer with the printed bundle, to be freed by the caller even on error.
+ * @return 0 on success, -1 on error.
+ */
+static int
+ly_ctx_bundle_print(const struct ly_ctx *ctx, struct ly_ctx_bundle_out *out)
+{
+    struct lys_module *mod;
+    uint32_t count, version;
+    int i, j;
+
+    memset(out, 0, sizeof *out);
+
+    count = 0;
+    for (i = 0; i < ctx->models.used; ++i) {
+        count += 1 + ctx->models.list[i]->inc_size;
+    }
+    version = LY_CTX_BUNDLE_VERSION;
+    if (ly_ctx_bundle_write(out, LY_CTX_BUNDLE_MAGIC, strlen(LY_CTX_BUNDLE_MAGIC))
+            || ly_ctx_bundle_write(out, &version, sizeof version) || ly_ctx_bundle_write(out, &count, sizeof count)) {
+        return -1;
+    }
+
+    /* modules in the order they were added into the context, so the imports precede the modules importing them */
+    for (i = 0; i < ctx->models.used; ++i) {
+        mod = ctx->models.list[i];
+        if (ly_ctx_bundle_write_module(out, mod, i < ctx->internal_module_count)) {
+            return -1;
+        }
+        for (j = 0; j < mod->inc_size; ++j) {
+            if (ly_ctx_bundle_write_module(out, (struct lys_module *)mod->inc[j].submodule, 0)) {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+API int
+ly_ctx_print_bundle(const struct ly_ctx *ctx, const char *path)
+{
+    FUN_IN;
+
+    struct ly_ctx_bundle_out out;
+    FILE *f;
+    int ret = EXIT_FAILURE;
+
+    if (!ctx || !path) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    if (ly_ctx_bundle_print(ctx, &out)) {
+        goto cleanup;
+    }
+
+    f = fopen(path, "w");
+    if (!f) {
+        LOGERR(ctx, LY_ESYS, "Opening file \"%s\" failed (%s).", path, strerror(errno));
+        goto cleanup;
+    }
+    if (fwrite(out.buf, 1, out.used, f) != out.used) {
+        LOGERR(ctx, LY_ESYS, "Writing file \"%s\" failed (%s).", path, strerror(errno));
+        fclose(f);
+        goto cleanup;
+    }
+    if (fclose(f)) {
+        LOGERR(ctx, LY_ESYS, "Writing file \"%s\" failed (%s).", path, strerror(errno));
+        goto cleanup;
+    }
+
+    ret = EXIT_SUCCESS;
+
+cleanup:
+    free(out.buf);
+    return ret;
+}
+
+/**
+ * @brief Read a string record from the source bundle.
+ *
+ * @param[in,out] p Current position in the bundle, moved behind the record.
+ * @param[in] end End of the bundle.
+ * @return Read string, NULL if the bundle is malformed.
+ */
+static const char *
+ly_ctx_bundle_read_str(const char **p, const char *end)
+{
+    const char *str;
+    uint32_t len;
+
+    if ((size_t)(end - *p) < sizeof len) {
+        return NULL;
+    }
+    memcpy(&len, *p, sizeof len);
+    *p += sizeof len;
+
+    if ((size_t)(end - *p) < (size_t)len + 2) {
+        return NULL;
+    }
+    str = *p;
+    *p += len + 2;
+    if (str[len] || str[len + 1] || (strlen(str) != len)) {
+        return NULL;
+    }
+
+    return str;
+}
+
+/**
+ * @brief Parse all the records of a mapped source bundle.
+ *
+ * @param[in] addr Mapped bundle.
+ * @param[in] size Size of the bundle.
+ * @param[out] bundle Parsed bundle records pointing into \p addr.
+ * @return 0 on success, -1 on error.
+ */
+static int
+ly_ctx_bundle_parse(const char *addr, size_t size, struct ly_ctx_bundle *bundle)
+{
+    const char *p, *end, *str;
+    struct ly_ctx_bundle_rec *rec;
+    uint32_t version, i, j;
+
+    p = addr;
+    end = addr + size;
+
+    if ((size < strlen(LY_CTX_BUNDLE_MAGIC) + 2 * sizeof(uint32_t)) || memcmp(p, LY_CTX_BUNDLE_MAGIC, strlen(LY_CTX_BUNDLE_MAGIC))) {
+        LOGERR(NULL, LY_EINVAL, "Invalid source bundle.");
+        return -1;
+    }
+    p += strlen(LY_CTX_BUNDLE_MAGIC);
+    memcpy(&version, p, sizeof version);
+    p += sizeof version;
+    if (version != LY_CTX_BUNDLE_VERSION) {
+        LOGERR(NULL, LY_EINVAL, "Unsupported source bundle version %u.", version);
+        return -1;
+    }
+    memcpy(&bundle->count, p, sizeof bundle->count);
+    p += sizeof bundle->count;
+
+    /* every record takes at least the flags, format and 4 empty strings */
+    if (bundle->count > size / (2 + 4 * (sizeof(uint32_t) + 2))) {
+        goto malformed;
+    }
+    bundle->recs = calloc(bundle->count, sizeof *bundle->recs);
+    LY_CHECK_ERR_RETURN(!bundle->recs && bundle->count, LOGMEM(NULL), -1);
+
+    for (i = 0; i < bundle->count; ++i) {
+        rec = &bundle->recs[i];
+
+        if (end - p < 2) {
+            goto malformed;
+        }
+        rec->flags = (uint8_t)p[0];
+        rec->format = (uint8_t)p[1];
+        p += 2;
+
+        if (!(rec->name = ly_ctx_bundle_read_str(&p, end)) || !(rec->rev = ly_ctx_bundle_read_str(&p, end))
+                || !(rec->belongsto = ly_ctx_bundle_read_str(&p, end))) {
+            goto malformed;
+        }
+        if (!rec->rev[0]) {
+            rec->rev = NULL;
+        }
+
+        if ((size_t)(end - p) < sizeof rec->feat_count) {
+            goto malformed;
+        }
+        memcpy(&rec->feat_count, p, sizeof rec->feat_count);
+        p += sizeof rec->feat_count;
+        rec->feats = p;
+        for (j = 0; j < rec->feat_count; ++j) {
+            if (!ly_ctx_bundle_read_str(&p, end)) {
+                goto malformed;
+            }
+        }
+
+        if (!(str = ly_ctx_bundle_read_str(&p, end))) {
+            goto malformed;
+        }
+        if (str[0]) {
+            if ((rec->format != LYS_IN_YANG) && (rec->format != LYS_IN_YIN)) {
+                goto malformed;
+            }
+            rec->src = str;
+        } else if (rec->flags & LY_CTX_BUNDLE_SUBMODULE) {
+            goto malformed;
+        }
+    }
+
+    return 0;
+
+malformed:
+    LOGERR(NULL, LY_EINVAL, "Malformed source bundle.");
+    free(bundle->recs);
+    bundle->recs = NULL;
+    return -1;
+}
+
+/**
+ * @brief Module import callback serving the (sub)modules from a source bundle.
+ */
+static const char *
+ly_ctx_bundle_imp_clb(const char *mod_name, const char *mod_rev, const char *submod_name, const char *sub_rev,
+                     void *user_data, LYS_INFORMAT *format, void (**free_module_data)(void *model_data, void *user_data))
+{
+    struct ly_ctx_bundle *bundle = (struct ly_ctx_bundle *)user_data;
+    struct ly_ctx_bundle_rec *rec, *match = NULL;
+    const char *name, *rev;
+    uint32_t i;
+
+    (void)free_module_data;
+
+    name = submod_name ? submod_name : mod_name;
+    rev = submod_name ? sub_rev : mod_rev;
+
+    for (i = 0; i < bundle->count; ++i) {
+        rec = &bundle->recs[i];
+        if (!rec->src || (!submod_name != !(rec->flags & LY_CTX_BUNDLE_SUBMODULE)) || strcmp(rec->name, name)
+                || (submod_name && strcmp(rec->belongsto, mod_name))) {
+            continue;
+        }
+
+        if (rev) {
+            if (rec->rev && !strcmp(rec->rev, rev)) {
+                match = rec;
+                break;
+            }
+        } else if (!match || (rec->rev && (!match->rev || (strcmp(rec->rev, match->rev) > 0)))) {
+            /* the newest revision */
+            match = rec;
+        }
+    }
+
+    if (!match) {
+        return NULL;
+    }
+    *format = match->format;
+    return match->src;
+}
+
+/**
+ * @brief Find a feature of a module or its submodules.
+ */
+static struct lys_feature *
+ly_ctx_bundle_feature(const struct lys_module *module, const char *name)
+{
+    int i, j;
+
+    for (i = -1; i < module->inc_size; ++i) {
+        for (j = 0; j < (i == -1 ? module->features_size : module->inc[i].submodule->features_size); ++j) {
+            if (ly_strequal(i == -1 ? module->features[j].name : module->inc[i].submodule->features[j].name, name, 0)) {
+                return (i == -1 ? &module->features[j] : &module->inc[i].submodule->features[j]);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Enable the features of a module stored in its source bundle record. They are enabled by
+ * lys_features_enable(), so their if-feature conditions are checked, the features depending on the features
+ * declared after them are enabled in the next pass.
+ *
+ * @param[in] module Module loaded from the record.
+ * @param[in] rec Context bundle record of \p module.
+ * @param[in] end End of the source bundle.
+ * @return 0 on success, -1 on error.
+ */
+static int
+ly_ctx_bundle_features(const struct lys_module *module, const struct ly_ctx_bundle_rec *rec, const char *end)
+{
+    struct lys_feature *f;
+    const char **feats, *p;
+    uint32_t i, pending;
+    int k, progress, ret = -1;
+
+    if (!rec->feat_count) {
+        return 0;
+    }
+
+    feats = malloc(rec->feat_count * sizeof *feats);
+    LY_CHECK_ERR_RETURN(!feats, LOGMEM(module->ctx), -1);
+    for (i = 0, p = rec->feats; i < rec->feat_count; ++i) {
+        feats[i] = ly_ctx_bundle_read_str(&p, end);
+        if (!ly_ctx_bundle_feature(module, feats[i])) {
+            LOGERR(module->ctx, LY_EINVAL, "Feature \"%s\" from the source bundle not found in module \"%s\".",
+                   feats[i], rec->name);
+            goto cleanup;
+        }
+    }
+
+    pending = rec->feat_count;
+    do {
+        progress = 0;
+        for (i = 0; i < rec->feat_count; ++i) {
+            if (!feats[i]) {
+                continue;
+            }
+
+            f = ly_ctx_bundle_feature(module, feats[i]);
+            for (k = 0; (k < f->iffeature_size) && resolve_iffeature(&f->iffeature[k]); ++k);
+            if (k < f->iffeature_size) {
+                /* depends on a feature not enabled yet */
+                continue;
+            }
+
+            if (lys_features_enable(module, feats[i])) {
+                goto cleanup;
+            }
+            feats[i] = NULL;
+            --pending;
+            progress = 1;
+        }
+    } while (pending && progress);
+
+    for (i = 0; pending && (i < rec->feat_count); ++i) {
+        if (feats[i]) {
+            /* cannot be enabled, let the error be printed */
+            lys_features_enable(module, feats[i]);
+            goto cleanup;
+        }
+    }
+
+    ret = 0;
+
+cleanup:
+    free(feats);
+    return ret;
+}
+
+/**
+ * @brief Load all the modules of a source bundle into a new context and restore their state.
+ *
+ * @param[in] ctx New context to load into.
+ * @param[in] addr Context bundle.
+ * @param[in] length Size of \p addr.
+ * @return 0 on success, -1 on error.
+ */
+static int
+ly_ctx_bundle_load(struct ly_ctx *ctx, const char *addr, size_t length)
+{
+    struct ly_ctx_bundle bundle;
+    struct ly_ctx_bundle_rec *rec;
+    const struct lys_module **mods = NULL;
+    uint32_t i;
+    int flags, ret = -1;
+
+    memset(&bundle, 0, sizeof bundle);
+    if (ly_ctx_bundle_parse(addr, length, &bundle)) {
+        return -1;
+    }
+
+    mods = calloc(bundle.count, sizeof *mods);
+    LY_CHECK_ERR_GOTO(!mods && bundle.count, LOGMEM(ctx), cleanup);
+
+    /* the bundle was created from a valid context, so all the modules are taken from it and trusted */
+    flags = ctx->models.flags;
+    ctx->models.flags |= LY_CTX_TRUSTED | LY_CTX_DISABLE_SEARCHDIRS;
+    ctx->models.flags &= ~LY_CTX_PREFER_SEARCHDIRS;
+    ly_ctx_set_module_imp_clb(ctx, ly_ctx_bundle_imp_clb, &bundle);
+
+    for (i = 0; i < bundle.count; ++i) {
+        rec = &bundle.recs[i];
+        if (rec->flags & LY_CTX_BUNDLE_SUBMODULE) {
+            /* loaded with their main modules */
+            continue;
+        }
+
+        mods[i] = ly_ctx_get_module(ctx, rec->name, rec->rev, 0);
+        if (mods[i] && !rec->rev && mods[i]->rev_size) {
+            mods[i] = NULL;
+        }
+        if (!mods[i]) {
+            if (!rec->src) {
+                LOGERR(ctx, LY_EINVAL, "Internal module \"%s\" from the source bundle not found.", rec->name);
+                break;
+            }
+            /* the source is terminated by 2 NULL bytes, so it can be parsed directly from the bundle */
+            mods[i] = lys_parse_mem_(ctx, rec->src, rec->format, NULL, 1, (rec->flags & LY_CTX_BUNDLE_IMPLEMENTED) ? 1 : 0);
+            if (!mods[i]) {
+                break;
+            }
+        }
+        if ((rec->flags & LY_CTX_BUNDLE_IMPLEMENTED) && !mods[i]->implemented
+                && lys_set_implemented(mods[i])) {
+            break;
+        }
+    }
+
+    ly_ctx_set_module_imp_clb(ctx, NULL, NULL);
+    ctx->models.flags = flags;
+    if (i < bundle.count) {
+        goto cleanup;
+    }
+
+    /* restore the state of the modules, the imported modules precede the modules importing them */
+    for (i = 0; i < bundle.count; ++i) {
+        if (mods[i] && ly_ctx_bundle_features(mods[i], &bundle.recs[i], addr + length)) {
+            goto cleanup;
+        }
+    }
+    for (i = 0; i < bundle.count; ++i) {
+        if (mods[i] && (bundle.recs[i].flags & LY_CTX_BUNDLE_DISABLED) && lys_set_disabled(mods[i])) {
+            goto cleanup;
+        }
+    }
+
+    ret = 0;
+
+cleanup:
+    free(mods);
+    free(bundle.recs);
+    return ret;
+}
+
+API struct ly_ctx *
+ly_ctx_new_bundle(const char *search_dir, const char *path, int options)
+{
+    FUN_IN;
+
+    struct ly_ctx *ctx = NULL;
+    char *addr = NULL;
+    size_t length = 0;
+    int fd;
+
+    if (!path) {
+        LOGARG;
+        return NULL;
+    }
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        LOGERR(NULL, LY_ESYS, "Opening file \"%s\" failed (%s).", path, strerror(errno));
+        return NULL;
+    }
+    if (lyp_mmap(NULL, fd, 0, &length, (void **)&addr)) {
+        close(fd);
+        return NULL;
+    }
+    close(fd);
+    if (!addr) {
+        LOGERR(NULL, LY_EINVAL, "Invalid source bundle.");
+        return NULL;
+    }
+
+    ctx = ly_ctx_new(search_dir, options);
+    if (!ctx || ly_ctx_bundle_load(ctx, addr, length)) {
+        ly_ctx_destroy(ctx, NULL);
+        ctx = NULL;
+    }
+
+    lyp_munmap(addr, length);
+    return ctx;
+}
+
+API struct ly_ctx *
+ly_ctx_clone(const struct ly_ctx *ctx)
+{
+    FUN_IN;
+
+    struct ly_ctx *clone = NULL;
+    struct ly_ctx_bundle_out out;
+    int i;
+
+    if (!ctx) {
+        LOGARG;
+        return NULL;
+    }
+
+    /* the bundle keeps the sources of all the modules together with their state */
+    if (ly_ctx_bundle_print(ctx, &out)) {
+        goto error;
+    }
+
+    clone = ly_ctx_new(NULL, ctx->models.flags);
+    if (!clone) {
+        goto error;
+    }
+    for (i = 0; ctx->models.search_paths && ctx->models.search_paths[i]; ++i) {
+        if (ly_ctx_set_searchdir(clone, ctx->models.search_paths[i])) {
+            goto error;
+        }
+    }
+
+    if (ly_ctx_bundle_load(clone, out.buf, out.used)) {
+        goto error;
+    }
 
-API struct ly_ctx *
-ly_ctx_new_ylmem(const char *search_dir, const char *data, LYD_FORMAT format, int options)
-{
-    FUN_IN;
+    /* the callbacks are set only now so that they are not used for loading the modules */
+    clone->imp_clb = ctx->imp_clb;
+    clone->imp_clb_data = ctx->imp_clb_data;
+    clone->data_clb = ctx->data_clb;
+    clone->data_clb_data = ctx->data_clb_data;
+#ifdef LY_ENABLED_LYD_PRIV
+    clone->priv_dup_clb = ctx->priv_dup_clb;
+#endif
 
-    return ly_ctx_new_yl_common(search_dir, data, format, options, lyd_parse_mem);
+    free(out.buf);
+    return clone;
+
+error:
+    free(out.buf);
+    ly_ctx_destroy(clone, NULL);
+    return NULL;
 }
 
 static void
@@ -419,6 +1305,30 @@ ly_ctx_unset_trusted(struct ly_ctx *ctx)
     ly_ctx_unset_option(ctx, LY_CTX_TRUSTED);
 }
 
+API int
+ly_ctx_freeze(struct ly_ctx *ctx)
+{
+    FUN_IN;
+
+    int i;
+
+    if (!ctx) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    /* build the schema caches now, working with data then only reads them (except the LYB sibling tables) */
+    for (i = 0; i < ctx->models.used; ++i) {
+        if (lys_precompute(ctx->models.list[i])) {
+            return EXIT_FAILURE;
+        }
+    }
+    lys_child_index_update(ctx);
+
+    ctx->frozen = 1;
+    return EXIT_SUCCESS;
+}
+
 API int
 ly_ctx_get_options(struct ly_ctx *ctx)
 {
@@ -546,6 +1456,25 @@ ly_ctx_destroy(struct ly_ctx *ctx, void (*private_destructor)(const struct lys_n
         free(ctx->models.search_paths);
     }
     free(ctx->models.list);
+    lyht_free(ctx->models.by_name);
+    lyht_free(ctx->models.by_ns);
+    /* the sources were removed with their (sub)modules */
+    lyht_free(ctx->models.sources);
+
+    /* compiled XPath expressions */
+    lyxp_expr_cache_free(ctx->xpath_cache);
+
+    /* schema children index */
+    lys_child_index_free(ctx->child_index);
+    pthread_mutex_destroy(&ctx->compile_lock);
+
+    /* LYB sibling hash tables */
+    lyb_sib_cache_free(ctx->lyb_sib_cache);
+
+#ifdef LY_ENABLED_CACHE
+    /* compiled patterns, after all the types using them were freed */
+    lyp_pattern_cache_free(ctx->pattern_cache);
+#endif
 
     /* clean the error list */
     ly_err_clean(ctx, 0);
@@ -647,66 +1576,63 @@ static const struct lys_module *
 ly_ctx_get_module_by(const struct ly_ctx *ctx, const char *key, size_t key_len, int offset, const char *revision,
                      int with_disabled, int implemented)
 {
-    int i;
-    char *val;
-    struct lys_module *result = NULL;
+    struct hash_table *ht;
+    struct ly_ctx_mod_rec krec, *rec;
+    struct lys_module *mod, *result = NULL;
+    uint32_t hash, result_seq = 0;
+    int r, cmp;
 
     if (!ctx || !key) {
         LOGARG;
         return NULL;
     }
 
-    for (i = 0; i < ctx->models.used; i++) {
-        if (!with_disabled && ctx->models.list[i]->disabled) {
-            /* skip the disabled modules */
+    ht = (offset == offsetof(struct lys_module, name)) ? ctx->models.by_name : ctx->models.by_ns;
+
+    memset(&krec, 0, sizeof krec);
+    krec.key = key;
+    krec.key_len = key_len ? key_len : strlen(key);
+    hash = ly_ctx_mod_hash(key, krec.key_len);
+
+    /* all the revisions of the module, pick the same one as going through the context list in order would */
+    for (r = lyht_find(ht, &krec, hash, (void **)&rec); !r; r = lyht_find_next(ht, rec, hash, (void **)&rec)) {
+        if (!ly_ctx_mod_rec_equal(rec, &krec, 0, ht->cb_data)) {
+            /* only the same hash */
             continue;
         }
-        /* use offset to get address of the pointer to string (char**), remember that offset is in
-         * bytes, so we have to cast the pointer to the module to (char*), finally, we want to have
-         * string not the pointer to string
-         */
-        val = *(char **)(((char *)ctx->models.list[i]) + offset);
-        if (!ctx->models.list[i] || (!key_len && strcmp(key, val)) || (key_len && (strncmp(key, val, key_len) || val[key_len]))) {
+        mod = rec->mod;
+        if (!with_disabled && mod->disabled) {
+            /* skip the disabled modules */
             continue;
         }
 
-        if (!revision) {
-            /* compare revisons and remember the newest one */
-            if (result) {
-                if (!ctx->models.list[i]->rev_size) {
-                    /* the current have no revision, keep the previous with some revision */
-                    continue;
-                }
-                if (result->rev_size && strcmp(ctx->models.list[i]->rev[0].date, result->rev[0].date) < 0) {
-                    /* the previous found matching module has a newer revision */
-                    continue;
-                }
+        if (revision) {
+            /* the first matching revision */
+            if (!mod->rev_size || strcmp(revision, mod->rev[0].date) || (result && (result_seq < rec->seq))) {
+                continue;
             }
-            if (implemented) {
-                if (ctx->models.list[i]->implemented) {
-                    /* we have the implemented revision */
-                    result = ctx->models.list[i];
-                    break;
-                } else {
-                    /* do not remember the result, we are supposed to return the implemented revision
-                     * not the newest one */
+        } else if (implemented) {
+            /* the implemented revision */
+            if (!mod->implemented || (result && (result_seq < rec->seq))) {
+                continue;
+            }
+        } else if (result) {
+            /* the newest revision, the last one of the same revisions, the first one without any revision */
+            if (mod->rev_size) {
+                cmp = result->rev_size ? strcmp(mod->rev[0].date, result->rev[0].date) : 1;
+                if ((cmp < 0) || (!cmp && (rec->seq < result_seq))) {
                     continue;
                 }
-            }
-
-            /* remember the current match and search for newer version */
-            result = ctx->models.list[i];
-        } else {
-            if (ctx->models.list[i]->rev_size && !strcmp(revision, ctx->models.list[i]->rev[0].date)) {
-                /* matching revision */
-                result = ctx->models.list[i];
-                break;
+            } else if (result->rev_size || (result_seq < rec->seq)) {
+                continue;
             }
         }
+
+        result = mod;
+        result_seq = rec->seq;
     }
 
     return result;
-
 }
 
 API const struct lys_module *
@@ -847,6 +1773,404 @@ ly_ctx_set_priv_dup_clb(struct ly_ctx *ctx, void *(*priv_dup_clb)(const void *pr
 
 #endif
 
+/** maximum number of threads reading the schema files in ly_ctx_load_modules() */
+#define LY_CTX_PREFETCH_THREADS 8
+
+/**
+ * @brief Schema file read in advance by ly_ctx_load_modules().
+ */
+struct ly_ctx_prefetch_rec {
+    char *name;              /* requested (sub)module name */
+    char *revision;          /* requested revision, NULL for the latest one */
+    char *path;              /* path of the found file, NULL if not found */
+    LYS_INFORMAT format;     /* format of the found file */
+    char *data;              /* file content terminated by 2 NULL bytes (for flex), NULL if not read */
+};
+
+/**
+ * @brief Shared state of the threads reading the schema files.
+ */
+struct ly_ctx_prefetch {
+    const struct ly_ctx *ctx;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct ly_ctx_prefetch_rec **recs;
+    unsigned int count;
+    unsigned int size;
+    unsigned int next;       /* first record not yet taken by any thread */
+    unsigned int busy;       /* number of threads currently reading a record */
+    struct hash_table *ht;   /* records by name and revision */
+};
+
+static int
+ly_ctx_prefetch_rec_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct ly_ctx_prefetch_rec *rec1 = *(struct ly_ctx_prefetch_rec **)val1_p;
+    struct ly_ctx_prefetch_rec *rec2 = *(struct ly_ctx_prefetch_rec **)val2_p;
+
+    if (strcmp(rec1->name, rec2->name)) {
+        return 0;
+    }
+    if (!rec1->revision || !rec2->revision) {
+        return rec1->revision == rec2->revision;
+    }
+    return !strcmp(rec1->revision, rec2->revision);
+}
+
+static struct ly_ctx_prefetch_rec *
+ly_ctx_prefetch_find(struct ly_ctx_prefetch *pf, const char *name, const char *revision)
+{
+    struct ly_ctx_prefetch_rec rec, *rec_p = &rec, **match_p;
+
+    rec.name = (char *)name;
+    rec.revision = (char *)revision;
+    if (lyht_find(pf->ht, &rec_p, ly_ctx_mod_hash(name, strlen(name)), (void **)&match_p)) {
+        return NULL;
+    }
+    return *match_p;
+}
+
+/* must be called with pf->lock held (or before the threads are started) */
+static int
+ly_ctx_prefetch_add(struct ly_ctx_prefetch *pf, const char *name, size_t name_len, const char *revision, size_t rev_len)
+{
+    struct ly_ctx_prefetch_rec *rec, **recs;
+    struct lys_module *mod;
+    int i;
+
+    /* modules already in the context are not searched for */
+    for (i = 0; i < pf->ctx->models.used; ++i) {
+        mod = pf->ctx->models.list[i];
+        if (!strncmp(mod->name, name, name_len) && !mod->name[name_len] && (!revision
+                || (mod->rev_size && !strncmp(mod->rev[0].date, revision, rev_len) && !mod->rev[0].date[rev_len]))) {
+            return 0;
+        }
+    }
+
+    rec = calloc(1, sizeof *rec);
+    LY_CHECK_ERR_RETURN(!rec, LOGMEM(NULL), -1);
+    rec->name = strndup(name, name_len);
+    if (revision) {
+        rec->revision = strndup(revision, rev_len);
+    }
+    LY_CHECK_ERR_GOTO(!rec->name || (revision && !rec->revision), LOGMEM(NULL), error);
+
+    if (ly_ctx_prefetch_find(pf, rec->name, rec->revision)) {
+        /* already requested */
+        free(rec->name);
+        free(rec->revision);
+        free(rec);
+        return 0;
+    }
+
+    if (pf->count == pf->size) {
+        recs = realloc(pf->recs, (pf->size ? pf->size * 2 : 16) * sizeof *recs);
+        LY_CHECK_ERR_GOTO(!recs, LOGMEM(NULL), error);
+        pf->recs = recs;
+        pf->size = pf->size ? pf->size * 2 : 16;
+    }
+    if (lyht_insert(pf->ht, &rec, ly_ctx_mod_hash(rec->name, strlen(rec->name)), NULL)) {
+        goto error;
+    }
+    pf->recs[pf->count++] = rec;
+
+    /* wake up the waiting threads */
+    pthread_cond_broadcast(&pf->cond);
+    return 0;
+
+error:
+    free(rec->name);
+    free(rec->revision);
+    free(rec);
+    return -1;
+}
+
+/**
+ * @brief Get the next token of a YANG schema, only as precise as needed by ly_ctx_prefetch_scan_yang().
+ *
+ * @param[in] p Current position in the schema.
+ * @param[out] tok Start of the token (without quotes), NULL at the end of the schema.
+ * @param[out] len Length of the token.
+ * @return Position following the token.
+ */
+static const char *
+ly_ctx_prefetch_token(const char *p, const char **tok, size_t *len)
+{
+    char quot;
+
+    while (1) {
+        while (isspace(*p)) {
+            ++p;
+        }
+        if ((p[0] == '/') && (p[1] == '/')) {
+            p += strcspn(p, "\n");
+        } else if ((p[0] == '/') && (p[1] == '*')) {
+            p = strstr(p + 2, "*/");
+            if (!p) {
+                *tok = NULL;
+                return NULL;
+            }
+            p += 2;
+        } else {
+            break;
+        }
+    }
+
+    if (!*p) {
+        *tok = NULL;
+        return p;
+    }
+
+    if ((*p == '"') || (*p == '\'')) {
+        quot = *p;
+        *tok = ++p;
+        while (*p && (*p != quot)) {
+            if ((quot == '"') && (*p == '\\') && p[1]) {
+                ++p;
+            }
+            ++p;
+        }
+        *len = p - *tok;
+        return *p ? p + 1 : p;
+    }
+
+    *tok = p;
+    if ((*p == '{') || (*p == '}') || (*p == ';')) {
+        *len = 1;
+        return p + 1;
+    }
+    while (*p && !isspace(*p) && !strchr("{};\"'", *p)) {
+        ++p;
+    }
+    *len = p - *tok;
+    return p;
+}
+
+#define LY_CTX_PREFETCH_KW(TOK, LEN, KW) (((LEN) == sizeof KW - 1) && !strncmp(TOK, KW, LEN))
+
+/**
+ * @brief Request reading of all the modules and submodules imported and included by a YANG (sub)module.
+ * Only the header and linkage statements are scanned, they must precede all the other statements.
+ */
+static void
+ly_ctx_prefetch_scan_yang(struct ly_ctx_prefetch *pf, const char *data)
+{
+    const char *p = data, *tok, *name = NULL, *rev = NULL;
+    size_t len, name_len = 0, rev_len = 0;
+    int depth = 0;
+    enum {KW, ARG, NAME, REV} next = KW;
+
+    while ((p = ly_ctx_prefetch_token(p, &tok, &len)) && tok) {
+        if ((len == 1) && ((tok[0] == '{') || (tok[0] == '}') || (tok[0] == ';'))) {
+            if (tok[0] == '{') {
+                ++depth;
+            } else if (tok[0] == '}') {
+                --depth;
+            }
+            if (name && (depth == 1) && (tok[0] != '{')) {
+                /* end of an import/include statement */
+                pthread_mutex_lock(&pf->lock);
+                ly_ctx_prefetch_add(pf, name, name_len, rev, rev_len);
+                pthread_mutex_unlock(&pf->lock);
+                name = rev = NULL;
+            }
+            if (depth < 1) {
+                break;
+            }
+            next = KW;
+            continue;
+        }
+
+        switch (next) {
+        case KW:
+            next = ARG;
+            if (depth == 1) {
+                if (LY_CTX_PREFETCH_KW(tok, len, "import") || LY_CTX_PREFETCH_KW(tok, len, "include")) {
+                    next = NAME;
+                } else if (!memchr(tok, ':', len) && !LY_CTX_PREFETCH_KW(tok, len, "yang-version")
+                        && !LY_CTX_PREFETCH_KW(tok, len, "namespace") && !LY_CTX_PREFETCH_KW(tok, len, "prefix")
+                        && !LY_CTX_PREFETCH_KW(tok, len, "belongs-to")) {
+                    /* end of the linkage statements */
+                    return;
+                }
+            } else if ((depth == 2) && name && LY_CTX_PREFETCH_KW(tok, len, "revision-date")) {
+                next = REV;
+            }
+            break;
+        case NAME:
+            name = tok;
+            name_len = len;
+            next = ARG;
+            break;
+        case REV:
+            rev = tok;
+            rev_len = len;
+            next = ARG;
+            break;
+        case ARG:
+            break;
+        }
+    }
+}
+
+static void
+ly_ctx_prefetch_read(struct ly_ctx_prefetch *pf, struct ly_ctx_prefetch_rec *rec)
+{
+    struct stat st;
+    size_t len = 0;
+    ssize_t r;
+    char *data;
+    int fd;
+
+    if (lys_search_localfile((const char * const *)pf->ctx->models.search_paths,
+                             !(pf->ctx->models.flags & LY_CTX_DISABLE_SEARCHDIR_CWD), rec->name, rec->revision,
+                             &rec->path, &rec->format) || !rec->path) {
+        /* not found, it will be reported when loading the schema */
+        return;
+    }
+
+    fd = open(rec->path, O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    if (fstat(fd, &st) || !S_ISREG(st.st_mode) || !st.st_size) {
+        close(fd);
+        return;
+    }
+    data = malloc(st.st_size + 2);
+    if (!data) {
+        close(fd);
+        return;
+    }
+    while (len < (size_t)st.st_size) {
+        r = read(fd, data + len, st.st_size - len);
+        if (r > 0) {
+            len += r;
+        } else if (!r || (errno != EINTR)) {
+            break;
+        }
+    }
+    close(fd);
+    if (len < (size_t)st.st_size) {
+        /* let the regular loading report the error */
+        free(data);
+        return;
+    }
+    data[len] = data[len + 1] = '\0';
+    rec->data = data;
+
+    if (rec->format == LYS_IN_YANG) {
+        ly_ctx_prefetch_scan_yang(pf, data);
+    }
+}
+
+static void *
+ly_ctx_prefetch_thread(void *arg)
+{
+    struct ly_ctx_prefetch *pf = arg;
+    struct ly_ctx_prefetch_rec *rec;
+
+    pthread_mutex_lock(&pf->lock);
+    while (1) {
+        if (pf->next < pf->count) {
+            rec = pf->recs[pf->next++];
+            ++pf->busy;
+            pthread_mutex_unlock(&pf->lock);
+
+            ly_ctx_prefetch_read(pf, rec);
+
+            pthread_mutex_lock(&pf->lock);
+            --pf->busy;
+            if (!pf->busy && (pf->next == pf->count)) {
+                /* all done, wake up the waiting threads so they can finish */
+                pthread_cond_broadcast(&pf->cond);
+            }
+        } else if (!pf->busy) {
+            break;
+        } else {
+            /* another thread may still request some more schemas */
+            pthread_cond_wait(&pf->cond, &pf->lock);
+        }
+    }
+    pthread_mutex_unlock(&pf->lock);
+
+    return NULL;
+}
+
+static void
+ly_ctx_prefetch_free(struct ly_ctx_prefetch *pf)
+{
+    unsigned int u;
+
+    if (!pf) {
+        return;
+    }
+
+    for (u = 0; u < pf->count; ++u) {
+        free(pf->recs[u]->name);
+        free(pf->recs[u]->revision);
+        free(pf->recs[u]->path);
+        free(pf->recs[u]->data);
+        free(pf->recs[u]);
+    }
+    free(pf->recs);
+    lyht_free(pf->ht);
+    pthread_cond_destroy(&pf->cond);
+    pthread_mutex_destroy(&pf->lock);
+    free(pf);
+}
+
+/**
+ * @brief Find and read the schema files of the modules and all their imports and includes in parallel.
+ *
+ * @param[in] ctx Context with the searchpaths.
+ * @param[in] names Names of the modules.
+ * @param[in] revisions Optional revisions of the modules.
+ * @param[in] count Number of the modules.
+ * @return Read schema files, NULL on error.
+ */
+static struct ly_ctx_prefetch *
+ly_ctx_prefetch_new(const struct ly_ctx *ctx, const char **names, const char **revisions, unsigned int count)
+{
+    struct ly_ctx_prefetch *pf;
+    pthread_t threads[LY_CTX_PREFETCH_THREADS - 1];
+    unsigned int u, thread_count = 0;
+    const char *rev;
+    long cpus;
+
+    pf = calloc(1, sizeof *pf);
+    LY_CHECK_ERR_RETURN(!pf, LOGMEM(ctx), NULL);
+    pf->ctx = ctx;
+    pthread_mutex_init(&pf->lock, NULL);
+    pthread_cond_init(&pf->cond, NULL);
+    pf->ht = lyht_new(16, sizeof(struct ly_ctx_prefetch_rec *), ly_ctx_prefetch_rec_equal, NULL, 1);
+    LY_CHECK_ERR_GOTO(!pf->ht, LOGMEM(ctx), error);
+
+    for (u = 0; u < count; ++u) {
+        rev = revisions && revisions[u] && revisions[u][0] ? revisions[u] : NULL;
+        if (ly_ctx_prefetch_add(pf, names[u], strlen(names[u]), rev, rev ? strlen(rev) : 0)) {
+            goto error;
+        }
+    }
+
+    /* this thread reads the schemas as well */
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    while ((thread_count < LY_CTX_PREFETCH_THREADS - 1) && ((long)thread_count + 1 < cpus)
+            && !pthread_create(&threads[thread_count], NULL, ly_ctx_prefetch_thread, pf)) {
+        ++thread_count;
+    }
+    ly_ctx_prefetch_thread(pf);
+    for (u = 0; u < thread_count; ++u) {
+        pthread_join(threads[u], NULL);
+    }
+
+    return pf;
+
+error:
+    ly_ctx_prefetch_free(pf);
+    return NULL;
+}
+
 /* if module is !NULL, then the function searches for submodule */
 static struct lys_module *
 ly_ctx_load_localfile(struct ly_ctx *ctx, struct lys_module *module, const char *name, const char *revision,
@@ -857,8 +2181,21 @@ ly_ctx_load_localfile(struct ly_ctx *ctx, struct lys_module *module, const char
     char *filepath = NULL, *dot, *rev, *filename;
     LYS_INFORMAT format;
     struct lys_module *result = NULL;
+    struct ly_ctx_prefetch_rec *pref = NULL;
+
+    if (ctx->models.prefetch) {
+        /* the file may have been already read by ly_ctx_load_modules() */
+        pref = ly_ctx_prefetch_find(ctx->models.prefetch, name, revision);
+        if (pref && !pref->data) {
+            pref = NULL;
+        }
+    }
 
-    if (lys_search_localfile(ly_ctx_get_searchdirs(ctx), !(ctx->models.flags & LY_CTX_DISABLE_SEARCHDIR_CWD), name, revision,
+    if (pref) {
+        filepath = strdup(pref->path);
+        LY_CHECK_ERR_RETURN(!filepath, LOGMEM(ctx), NULL);
+        format = pref->format;
+    } else if (lys_search_localfile(ly_ctx_get_searchdirs(ctx), !(ctx->models.flags & LY_CTX_DISABLE_SEARCHDIR_CWD), name, revision,
                              &filepath, &format)) {
         goto cleanup;
     } else if (!filepath) {
@@ -902,20 +2239,29 @@ ly_ctx_load_localfile(struct ly_ctx *ctx, struct lys_module *module, const char
     /* add the format back */
     dot[1] = 'y';
 
-    /* open the file */
-    fd = open(filepath, O_RDONLY);
-    if (fd < 0) {
-        LOGERR(ctx, LY_ESYS, "Unable to open data model file \"%s\" (%s).",
-               filepath, strerror(errno));
-        goto cleanup;
-    }
-
-    if (module) {
-        result = (struct lys_module *)lys_sub_parse_fd(module, fd, format, unres);
+    if (pref) {
+        /* parse the already read file */
+        if (module) {
+            result = (struct lys_module *)lys_sub_parse_mem(module, pref->data, format, unres);
+        } else {
+            result = (struct lys_module *)lys_parse_mem_(ctx, pref->data, format, revision, 1, implement);
+        }
     } else {
-        result = (struct lys_module *)lys_parse_fd_(ctx, fd, format, revision, implement);
+        /* open the file */
+        fd = open(filepath, O_RDONLY);
+        if (fd < 0) {
+            LOGERR(ctx, LY_ESYS, "Unable to open data model file \"%s\" (%s).",
+                   filepath, strerror(errno));
+            goto cleanup;
+        }
+
+        if (module) {
+            result = (struct lys_module *)lys_sub_parse_fd(module, fd, format, unres);
+        } else {
+            result = (struct lys_module *)lys_parse_fd_(ctx, fd, format, revision, implement);
+        }
+        close(fd);
     }
-    close(fd);
 
     if (!result) {
         goto cleanup;
@@ -1098,10 +2444,65 @@ ly_ctx_load_module(struct ly_ctx *ctx, const char *name, const char *revision)
         LOGARG;
         return NULL;
     }
+    LY_CTX_CHECK_FROZEN(ctx, NULL);
 
     return ly_ctx_load_sub_module(ctx, NULL, name, revision && revision[0] ? revision : NULL, 1, NULL);
 }
 
+API int
+ly_ctx_load_modules(struct ly_ctx *ctx, const char **names, const char **revisions, unsigned int count,
+                    const struct lys_module **mods)
+{
+    FUN_IN;
+
+    struct ly_ctx_prefetch *pf = NULL;
+    const struct lys_module *mod;
+    const char *rev;
+    unsigned int u;
+    int ret = EXIT_SUCCESS;
+
+    if (!ctx || (count && !names)) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+    for (u = 0; u < count; ++u) {
+        if (!names[u]) {
+            LOGARG;
+            return EXIT_FAILURE;
+        }
+    }
+    LY_CTX_CHECK_FROZEN(ctx, EXIT_FAILURE);
+
+    if (mods) {
+        memset(mods, 0, count * sizeof *mods);
+    }
+
+    if (!(ctx->models.flags & LY_CTX_DISABLE_SEARCHDIRS) && !ctx->models.prefetch) {
+        /* find and read all the needed schema files in parallel, if it fails, they are just read during parsing */
+        pf = ly_ctx_prefetch_new(ctx, names, revisions, count);
+        ctx->models.prefetch = pf;
+    }
+
+    /* parse the modules, imports are loaded before the modules importing them */
+    for (u = 0; u < count; ++u) {
+        rev = revisions && revisions[u] && revisions[u][0] ? revisions[u] : NULL;
+        mod = ly_ctx_load_sub_module(ctx, NULL, names[u], rev, 1, NULL);
+        if (!mod) {
+            ret = EXIT_FAILURE;
+            break;
+        }
+        if (mods) {
+            mods[u] = mod;
+        }
+    }
+
+    if (pf) {
+        ctx->models.prefetch = NULL;
+        ly_ctx_prefetch_free(pf);
+    }
+    return ret;
+}
+
 /*
  * mods - set of removed modules, if NULL all modules are supposed to be removed so any backlink is invalid
  */
@@ -1213,6 +2614,8 @@ lys_set_disabled(const struct lys_module *module)
         /* already disabled module */
         return EXIT_SUCCESS;
     }
+    LY_CTX_CHECK_FROZEN(module->ctx, EXIT_FAILURE);
+
     mod = (struct lys_module *)module;
     ctx = mod->ctx;
 
@@ -1315,6 +2718,7 @@ imported:
 
     /* update the module-set-id */
     ctx->models.module_set_id++;
+    lys_child_index_update(ctx);
 
     return EXIT_SUCCESS;
 }
@@ -1359,6 +2763,8 @@ lys_set_enabled(const struct lys_module *module)
         /* already enabled module */
         return EXIT_SUCCESS;
     }
+    LY_CTX_CHECK_FROZEN(module->ctx, EXIT_FAILURE);
+
     mod = (struct lys_module *)module;
     ctx = mod->ctx;
 
@@ -1443,6 +2849,7 @@ checkdependency:
 
     /* update the module-set-id */
     ctx->models.module_set_id++;
+    lys_child_index_update(ctx);
 
     return EXIT_SUCCESS;
 }
@@ -1464,6 +2871,7 @@ ly_ctx_remove_module(const struct lys_module *module,
         LOGARG;
         return EXIT_FAILURE;
     }
+    LY_CTX_CHECK_FROZEN(module->ctx, EXIT_FAILURE);
 
     mod = (struct lys_module *)module;
     ctx = mod->ctx;
@@ -1560,6 +2968,7 @@ imported:
     }
     ctx->models.used = o + 1;
     ctx->models.module_set_id++;
+    lys_child_index_update(ctx);
 
     /* maintain backlinks (start with internal ietf-yang-library which have leafs as possible targets of leafrefs */
     ctx_modules_undo_backlinks(ctx, mods);
@@ -1584,6 +2993,7 @@ ly_ctx_clean(struct ly_ctx *ctx, void (*private_destructor)(const struct lys_nod
     if (!ctx) {
         return;
     }
+    LY_CTX_CHECK_FROZEN(ctx, );
 
     /* models list */
     for (; ctx->models.used > ctx->internal_module_count; ctx->models.used--) {
@@ -1595,6 +3005,7 @@ ly_ctx_clean(struct ly_ctx *ctx, void (*private_destructor)(const struct lys_nod
         ctx->models.list[ctx->models.used - 1] = NULL;
     }
     ctx->models.module_set_id++;
+    lys_child_index_update(ctx);
 
     /* maintain backlinks (actually done only with ietf-yang-library since its leafs can be target of leafref) */
     ctx_modules_undo_backlinks(ctx, NULL);
@@ -35,6 +35,14 @@ struct ly_modules_list {
     uint8_t parsed_submodules_count;
     uint16_t module_set_id;
     int flags; /* see @ref contextoptions. */
+    /* modules in the list indexed by name and by namespace, see ly_ctx_mod_index_add() */
+    struct hash_table *by_name;
+    struct hash_table *by_ns;
+    uint32_t last_seq;
+    /* schema files read in advance by ly_ctx_load_modules(), NULL otherwise */
+    struct ly_ctx_prefetch *prefetch;
+    /* sources the (sub)modules were parsed from, see ly_ctx_mod_src_add() */
+    struct hash_table *sources;
 };
 
 struct ly_ctx {
@@ -49,6 +57,54 @@ struct ly_ctx {
 #endif
     pthread_key_t errlist_key;
     uint8_t internal_module_count;
+    struct lyxp_expr_cache *xpath_cache; /* compiled XPath expressions */
+    struct lys_child_index *child_index; /* data children of schema nodes, see lys_child_find() */
+    struct lyb_sib_cache *lyb_sib_cache; /* LYB sibling hash tables, see lyb_sib_cache_get() */
+    uint8_t frozen;                      /* schemas cannot be changed anymore, see ly_ctx_freeze() */
+    pthread_mutex_t compile_lock;        /* schema parts compiled on demand, see lyp_precompile_type_patterns() */
+#ifdef LY_ENABLED_CACHE
+    struct lyp_pattern_cache *pattern_cache; /* compiled patterns shared by all the string types */
+#endif
 };
 
+/**
+ * @brief Check that the schemas in a context can be changed, return \p RET if the context was frozen.
+ */
+#define LY_CTX_CHECK_FROZEN(CTX, RET) \
+    LY_CHECK_ERR_RETURN((CTX)->frozen, LOGERR(CTX, LY_EINVAL, "Context is frozen, its schemas cannot be changed."), RET)
+
+/**
+ * @brief Add a module into the context indexes used by ly_ctx_get_module() and ly_ctx_get_module_by_ns(),
+ * must be called whenever the module is appended into the context list of modules.
+ *
+ * @param[in] module Module to add.
+ * @return 0 on success, -1 on error.
+ */
+int ly_ctx_mod_index_add(struct lys_module *module);
+
+/**
+ * @brief Remove a module from the context indexes, if it is there.
+ *
+ * @param[in] module Module to remove.
+ */
+void ly_ctx_mod_index_remove(struct lys_module *module);
+
+/**
+ * @brief Keep the source a (sub)module was parsed from, it is stored in the source bundles
+ * instead of the (sub)module, see ly_ctx_print_bundle(). Nothing is kept without #LY_CTX_KEEP_SOURCES
+ * and for the internal modules, the source kept first for a (sub)module is not replaced.
+ *
+ * @param[in] module Parsed (sub)module.
+ * @param[in] data Source of \p module.
+ * @param[in] format Format of \p data.
+ */
+void ly_ctx_mod_src_add(const struct lys_module *module, const char *data, LYS_INFORMAT format);
+
+/**
+ * @brief Forget the source of a (sub)module, if it is kept.
+ *
+ * @param[in] module (Sub)module being freed.
+ */
+void ly_ctx_mod_src_remove(const struct lys_module *module);
+
 #endif /* LY_CONTEXT_H_ */
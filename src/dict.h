@@ -56,12 +56,14 @@ const char *lydict_insert(struct ly_ctx *ctx, const char *value, size_t len);
  * specified value - it is inserted into the dictionary directly.
  *
  * @param[in] ctx libyang context handler
- * @param[in] value NULL-terminated string to be stored in the dictionary. If
- * the string is not present in dictionary, the pointer is directly used by the
- * dictionary. Otherwise, the reference counter is incremented and the value is
- * freed. So, after calling the function, caller is supposed to not use the
- * value address anymore.
- * @return pointer to the string stored in the dictionary
+ * @param[in] value NULL-terminated string to be stored in the dictionary. The
+ * value is always consumed. If the string is not present in dictionary, its
+ * buffer is reallocated to make room for the string length and hash in front
+ * of it and the string is moved behind them. Otherwise, the reference counter
+ * is incremented and the value is freed. So, after calling the function, caller
+ * is supposed to not use the value address anymore, but only the returned pointer.
+ * @return pointer to the string stored in the dictionary, it may differ from
+ * \p value even if the string was not present in the dictionary before
  */
 const char *lydict_insert_zc(struct ly_ctx *ctx, char *value);
 
@@ -14,6 +14,7 @@
 
 #include <string.h>
 #include <stdint.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <pthread.h>
 #include <assert.h>
@@ -38,13 +39,17 @@ lydict_val_eq(void *val1_p, void *val2_p, int UNUSED(mod), void *cb_data)
         return 0;
     }
 
-    if (strncmp(str1, str2, *(size_t *)cb_data) == 0) {
+    /* the second string is always the stored one */
+    if ((lydict_len(str2) == *(size_t *)cb_data) && !memcmp(str1, str2, *(size_t *)cb_data)) {
         return 1;
     }
 
     return 0;
 }
 
+/* get the dictionary string structure of its value */
+#define DICT_STR(str) ((struct dict_str *)((str) - offsetof(struct dict_str, value)))
+
 void
 lydict_init(struct dict_table *dict)
 {
@@ -73,7 +78,7 @@ lydict_clean(struct dict_table *dict)
     for (i = 0; i < dict->hash_tab->size; i++) {
         /* get ith record */
         rec = (struct ht_rec *)&dict->hash_tab->recs[i * dict->hash_tab->rec_size];
-        if (rec->hits == 1) {
+        if (rec->hits > 0) {
             /*
              * this should not happen, all records inserted into
              * dictionary are supposed to be removed using lydict_remove()
@@ -83,7 +88,7 @@ lydict_clean(struct dict_table *dict)
             LOGWRN(NULL, "String \"%s\" not freed from the dictionary, refcount %d", dict_rec->value, dict_rec->refcount);
             /* if record wasn't removed before free string allocated for that record */
 #ifdef NDEBUG
-            free(dict_rec->value);
+            free(DICT_STR(dict_rec->value));
 #endif
         }
     }
@@ -141,36 +146,61 @@ dict_hash_multi(uint32_t hash, const char *key_part, size_t len)
     return hash;
 }
 
-API void
-lydict_remove(struct ly_ctx *ctx, const char *value)
+uint32_t
+lydict_hash(const char *value)
 {
-    FUN_IN;
+    return DICT_STR(value)->hash;
+}
 
-    size_t len;
+size_t
+lydict_len(const char *value)
+{
+    return DICT_STR(value)->len;
+}
+
+uint32_t
+lydict_hash_multi(uint32_t hash, const char *value)
+{
+    uint32_t str_hash = DICT_STR(value)->hash;
+
+    return dict_hash_multi(hash, (const char *)&str_hash, sizeof str_hash);
+}
+
+uint32_t
+dict_hash_multi_str(uint32_t hash, const char *str, size_t len)
+{
+    uint32_t str_hash = dict_hash(str, len);
+
+    return dict_hash_multi(hash, (const char *)&str_hash, sizeof str_hash);
+}
+
+/* the outermost batch of this thread */
+static THREAD_LOCAL struct dict_batch *dict_batch;
+
+/* dictionary must be locked */
+static void
+dict_ref_change(struct ly_ctx *ctx, const char *value, uint32_t hash, size_t len, int inc)
+{
     int ret;
-    uint32_t hash;
     struct dict_rec rec, *match = NULL;
     char *val_p;
 
-    if (!value || !ctx) {
-        return;
-    }
-
-    len = strlen(value);
-    hash = dict_hash(value, len);
-
     /* create record for lyht_find call */
     rec.value = (char *)value;
     rec.refcount = 0;
 
-    pthread_mutex_lock(&ctx->dict.lock);
     /* set len as data for compare callback */
     lyht_set_cb_data(ctx->dict.hash_tab, (void *)&len);
     /* check if value is already inserted */
     ret = lyht_find(ctx->dict.hash_tab, &rec, hash, (void **)&match);
 
     if (ret == 0) {
-        LY_CHECK_ERR_GOTO(!match, LOGINT(ctx), finish);
+        LY_CHECK_ERR_RETURN(!match, LOGINT(ctx), );
+
+        if (inc) {
+            match->refcount++;
+            return;
+        }
 
         /* if value is already in dictionary, decrement reference counter */
         match->refcount--;
@@ -182,48 +212,220 @@ lydict_remove(struct ly_ctx *ctx, const char *value)
              */
             val_p = match->value;
             ret = lyht_remove(ctx->dict.hash_tab, &rec, hash);
-            free(val_p);
-            LY_CHECK_ERR_GOTO(ret, LOGINT(ctx), finish);
+            free(DICT_STR(val_p));
+            LY_CHECK_ERR_RETURN(ret, LOGINT(ctx), );
+        }
+    } else if (inc) {
+        /* only strings from the dictionary can be referenced */
+        LOGINT(ctx);
+    }
+}
+
+static void
+dict_batch_flush(struct dict_batch *batch)
+{
+    uint32_t i;
+
+    if (!batch->count) {
+        return;
+    }
+
+    pthread_mutex_lock(&batch->ctx->dict.lock);
+    /* increase first so that no string is freed while still referenced */
+    for (i = 0; i < batch->count; ++i) {
+        if (batch->recs[i].inc) {
+            dict_ref_change(batch->ctx, batch->recs[i].value, batch->recs[i].hash, batch->recs[i].len, 1);
         }
     }
+    for (i = 0; i < batch->count; ++i) {
+        if (!batch->recs[i].inc) {
+            dict_ref_change(batch->ctx, batch->recs[i].value, batch->recs[i].hash, batch->recs[i].len, 0);
+        }
+    }
+    pthread_mutex_unlock(&batch->ctx->dict.lock);
+
+    batch->count = 0;
+}
+
+/* return: 0 - change postponed, 1 - the change must be applied now */
+static int
+dict_batch_add(struct ly_ctx *ctx, const char *value, uint32_t hash, size_t len, int inc)
+{
+    struct dict_batch *batch = dict_batch;
+    struct dict_batch_rec *rec;
+
+    if (!batch || (batch->ctx != ctx)) {
+        return 1;
+    }
+
+    if (batch->count == LY_DICT_BATCH_SIZE) {
+        /* the changes so far can be safely applied, they are in order */
+        dict_batch_flush(batch);
+    }
+
+    rec = &batch->recs[batch->count++];
+    rec->value = value;
+    rec->hash = hash;
+    rec->len = len;
+    rec->inc = inc;
+    return 0;
+}
+
+void
+lydict_batch_start(struct ly_ctx *ctx, struct dict_batch *batch)
+{
+    if (!dict_batch) {
+        batch->ctx = ctx;
+        batch->depth = 1;
+        batch->count = 0;
+        dict_batch = batch;
+    } else if (dict_batch->ctx == ctx) {
+        /* nested batch, the outermost one is used */
+        ++dict_batch->depth;
+    }
+    /* else nested operation on another context, it is not batched */
+}
+
+void
+lydict_batch_end(struct ly_ctx *ctx)
+{
+    struct dict_batch *batch = dict_batch;
+
+    if (!batch || (batch->ctx != ctx) || --batch->depth) {
+        /* not the outermost batch */
+        return;
+    }
+
+    dict_batch_flush(batch);
+    dict_batch = NULL;
+}
+
+#ifndef NDEBUG
 
-finish:
+/**
+ * @brief Check that a string is the one stored in the dictionary, not just an equal string. Only such strings
+ * have the length and hash in front of them used by lydict_ref() and lydict_unref().
+ *
+ * @param[in] ctx Context with the dictionary.
+ * @param[in] value String to check.
+ * @return 1 if \p value is stored in the dictionary, 0 otherwise.
+ */
+static int
+dict_is_stored(struct ly_ctx *ctx, const char *value)
+{
+    struct dict_rec rec, *match = NULL;
+    size_t len;
+    int ret;
+
+    len = strlen(value);
+    rec.value = (char *)value;
+    rec.refcount = 1;
+
+    pthread_mutex_lock(&ctx->dict.lock);
+    lyht_set_cb_data(ctx->dict.hash_tab, (void *)&len);
+    ret = !lyht_find(ctx->dict.hash_tab, (void *)&rec, dict_hash(value, len), (void **)&match) && (match->value == value);
     pthread_mutex_unlock(&ctx->dict.lock);
+
+    return ret;
+}
+
+#endif
+
+const char *
+lydict_ref(struct ly_ctx *ctx, const char *value)
+{
+    if (!value) {
+        return NULL;
+    }
+    assert(dict_is_stored(ctx, value));
+
+    if (dict_batch_add(ctx, value, lydict_hash(value), lydict_len(value), 1)) {
+        pthread_mutex_lock(&ctx->dict.lock);
+        dict_ref_change(ctx, value, lydict_hash(value), lydict_len(value), 1);
+        pthread_mutex_unlock(&ctx->dict.lock);
+    }
+
+    return value;
+}
+
+void
+lydict_unref(struct ly_ctx *ctx, const char *value)
+{
+    if (!value || !ctx) {
+        return;
+    }
+    assert(dict_is_stored(ctx, value));
+
+    if (dict_batch_add(ctx, value, lydict_hash(value), lydict_len(value), 0)) {
+        pthread_mutex_lock(&ctx->dict.lock);
+        dict_ref_change(ctx, value, lydict_hash(value), lydict_len(value), 0);
+        pthread_mutex_unlock(&ctx->dict.lock);
+    }
+}
+
+API void
+lydict_remove(struct ly_ctx *ctx, const char *value)
+{
+    FUN_IN;
+
+    size_t len;
+    uint32_t hash;
+
+    if (!value || !ctx) {
+        return;
+    }
+
+    len = strlen(value);
+    hash = dict_hash(value, len);
+
+    if (dict_batch_add(ctx, value, hash, len, 0)) {
+        pthread_mutex_lock(&ctx->dict.lock);
+        dict_ref_change(ctx, value, hash, len, 0);
+        pthread_mutex_unlock(&ctx->dict.lock);
+    }
 }
 
 static char *
 dict_insert(struct ly_ctx *ctx, char *value, size_t len, int zerocopy)
 {
     struct dict_rec *match = NULL, rec;
+    struct dict_str *str;
     int ret = 0;
     uint32_t hash;
 
     hash = dict_hash(value, len);
     /* set len as data for compare callback */
     lyht_set_cb_data(ctx->dict.hash_tab, (void *)&len);
-    /* create record for lyht_insert */
+    /* create record for lyht_find */
     rec.value = value;
     rec.refcount = 1;
 
     LOGDBG(LY_LDGDICT, "inserting \"%s\"", rec.value);
-    ret = lyht_insert(ctx->dict.hash_tab, (void *)&rec, hash, (void **)&match);
-    if (ret == 1) {
+    if (!lyht_find(ctx->dict.hash_tab, (void *)&rec, hash, (void **)&match)) {
         match->refcount++;
         if (zerocopy) {
             free(value);
         }
-    } else if (ret == 0) {
-        if (!zerocopy) {
-            /*
-             * allocate string for new record
-             * record is already inserted in hash table
-             */
-            match->value = malloc(sizeof *match->value * (len + 1));
-            LY_CHECK_ERR_RETURN(!match->value, LOGMEM(ctx), NULL);
-            memcpy(match->value, value, len);
-            match->value[len] = '\0';
-        }
+        return match->value;
+    }
+
+    /* the stored strings (compared with in the table) all need their hash and length */
+    if (zerocopy) {
+        str = realloc(value, offsetof(struct dict_str, value) + len + 1);
+        LY_CHECK_ERR_RETURN(!str, LOGMEM(ctx); free(value), NULL);
+        memmove(str->value, str, len + 1);
     } else {
+        str = malloc(offsetof(struct dict_str, value) + len + 1);
+        LY_CHECK_ERR_RETURN(!str, LOGMEM(ctx), NULL);
+        memcpy(str->value, value, len);
+        str->value[len] = '\0';
+    }
+    str->hash = hash;
+    str->len = len;
+
+    rec.value = str->value;
+    ret = lyht_insert(ctx->dict.hash_tab, (void *)&rec, hash, (void **)&match);
+    if (ret) {
         /* lyht_insert returned error */
         LOGINT(ctx);
         return NULL;
@@ -343,7 +545,7 @@ lyht_dup(const struct hash_table *orig)
         return NULL;
     }
 
-    memcpy(ht->recs, orig->recs, (size_t)orig->used * (size_t)orig->rec_size);
+    memcpy(ht->recs, orig->recs, (size_t)orig->size * (size_t)orig->rec_size);
     ht->used = orig->used;
     return ht;
 }
@@ -397,6 +599,8 @@ lyht_resize(struct hash_table *ht, int enlarge)
     return 0;
 }
 
+#ifndef LY_ENABLED_HT_ROBIN_HOOD
+
 /* return: 0 - hash found, returned its record,
  *         1 - hash not found, returned the record where it would be inserted */
 static int
@@ -606,6 +810,111 @@ lyht_find_next(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p
     return 1;
 }
 
+#else /* LY_ENABLED_HT_ROBIN_HOOD */
+
+/**
+ * @brief Get the index of the record following another one.
+ *
+ * @param[in] ht Hash table.
+ * @param[in] idx Index of a record.
+ * @return Index of the next record, wraps around.
+ */
+static inline uint32_t
+lyht_next_idx(const struct hash_table *ht, uint32_t idx)
+{
+    return (idx + 1) & (ht->size - 1);
+}
+
+/**
+ * @brief Find the record of a value in a Robin Hood hash table.
+ *
+ * @param[in] ht Hash table to search in.
+ * @param[in] val_p Pointer to the value to find.
+ * @param[in] hash Hash of the value.
+ * @param[in] mod Whether the operation modifies the hash table, passed to the value callback.
+ * @param[out] idx_p Index of the record with the value, if found. Otherwise the index
+ * where it would be inserted to keep the records ordered.
+ * @param[out] dist_p Distance + 1 of \p idx_p from the hash record.
+ * @return 0 on success, 1 on not found.
+ */
+static int
+lyht_rh_find(struct hash_table *ht, void *val_p, uint32_t hash, int mod, uint32_t *idx_p, int32_t *dist_p)
+{
+    struct ht_rec *rec;
+    uint32_t idx;
+    int32_t dist;
+
+    idx = hash & (ht->size - 1);
+    for (dist = 1; (uint32_t)dist <= ht->size; ++dist) {
+        rec = lyht_get_rec(ht->recs, ht->rec_size, idx);
+        if (rec->hits < dist) {
+            /* empty record or a record closer to its hash record, the value would have been stored before it */
+            break;
+        }
+
+        if ((rec->hash == hash) && ht->val_equal(val_p, &rec->val, mod, ht->cb_data)) {
+            *idx_p = idx;
+            *dist_p = dist;
+            return 0;
+        }
+        idx = lyht_next_idx(ht, idx);
+    }
+
+    *idx_p = idx;
+    *dist_p = dist;
+    return 1;
+}
+
+int
+lyht_find(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
+{
+    uint32_t idx;
+    int32_t dist;
+
+    if (lyht_rh_find(ht, val_p, hash, 0, &idx, &dist)) {
+        return 1;
+    }
+
+    if (match_p) {
+        *match_p = lyht_get_rec(ht->recs, ht->rec_size, idx)->val;
+    }
+    return 0;
+}
+
+int
+lyht_find_next(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
+{
+    struct ht_rec *rec;
+    uint32_t idx;
+    int32_t dist;
+
+    if (lyht_rh_find(ht, val_p, hash, 1, &idx, &dist)) {
+        /* not found, cannot happen */
+        assert(0);
+        return 1;
+    }
+
+    /* the next value with equal hash can only follow the previous one */
+    for (++dist, idx = lyht_next_idx(ht, idx); (uint32_t)dist <= ht->size; ++dist, idx = lyht_next_idx(ht, idx)) {
+        rec = lyht_get_rec(ht->recs, ht->rec_size, idx);
+        if (rec->hits < dist) {
+            break;
+        }
+
+        if (rec->hash == hash) {
+            if (match_p) {
+                *match_p = rec->val;
+            }
+            return 0;
+        }
+    }
+
+    /* the last equal value was already returned */
+    return 1;
+}
+
+#endif /* LY_ENABLED_HT_ROBIN_HOOD */
+
 #ifndef NDEBUG
 
 /* prints little-endian numbers, will also work on big-endian just the values will look weird */
@@ -689,6 +998,73 @@ lyht_dbgprint_value(void *val_p, uint32_t hash, uint16_t rec_size, const char *o
 #endif
 }
 
+/**
+ * @brief Enlarge a hash table after an insertion, if it is too full.
+ *
+ * @param[in] ht Hash table with the new value.
+ * @param[in] val_p Pointer to the inserted value.
+ * @param[in] hash Hash of the inserted value.
+ * @param[in] resize_val_equal Val equal callback to use for resizing, optional.
+ * @param[in,out] match_p Pointer to the stored value to update, optional.
+ * @return 0 on success, -1 on error.
+ */
+static int
+lyht_insert_resize(struct hash_table *ht, void *val_p, uint32_t hash, values_equal_cb resize_val_equal, void **match_p)
+{
+    values_equal_cb old_val_equal;
+    int r, ret = 0;
+
+    if (ht->resize) {
+        r = (ht->used * 100) / ht->size;
+        if ((ht->resize == 1) && (r >= LYHT_FIRST_SHRINK_PERCENTAGE)) {
+            /* enable shrinking */
+            ht->resize = 2;
+        }
+        if ((ht->resize == 2) && (r >= LYHT_ENLARGE_PERCENTAGE)) {
+            if (resize_val_equal) {
+                old_val_equal = lyht_set_cb(ht, resize_val_equal);
+            }
+
+            /* enlarge */
+            ret = lyht_resize(ht, 1);
+            /* if hash_table was resized, we need to find new matching value */
+            if (ret == 0 && match_p) {
+                lyht_find(ht, val_p, hash, match_p);
+            }
+
+            if (resize_val_equal) {
+                lyht_set_cb(ht, old_val_equal);
+            }
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Shrink a hash table after a removal, if it is too empty.
+ *
+ * @param[in] ht Hash table without the removed value.
+ * @return 0 on success, -1 on error.
+ */
+static int
+lyht_remove_resize(struct hash_table *ht)
+{
+    int r, ret = 0;
+
+    if (ht->resize == 2) {
+        r = (ht->used * 100) / ht->size;
+        if ((r < LYHT_SHRINK_PERCENTAGE) && (ht->size > LYHT_MIN_SIZE)) {
+            /* shrink */
+            ret = lyht_resize(ht, 0);
+        }
+    }
+
+    return ret;
+}
+
+#ifndef LY_ENABLED_HT_ROBIN_HOOD
+
 int
 lyht_insert_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash,
                            values_equal_cb resize_val_equal, void **match_p)
@@ -696,7 +1072,6 @@ lyht_insert_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash,
     struct ht_rec *rec, *crec = NULL;
     int32_t i;
     int r, ret;
-    values_equal_cb old_val_equal;
 
     lyht_dbgprint_ht(ht, "before");
     lyht_dbgprint_value(val_p, hash, ht->rec_size, "inserting");
@@ -749,42 +1124,13 @@ lyht_insert_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash,
     }
 
     /* check size & enlarge if needed */
-    ret = 0;
     ++ht->used;
-    if (ht->resize) {
-        r = (ht->used * 100) / ht->size;
-        if ((ht->resize == 1) && (r >= LYHT_FIRST_SHRINK_PERCENTAGE)) {
-            /* enable shrinking */
-            ht->resize = 2;
-        }
-        if ((ht->resize == 2) && (r >= LYHT_ENLARGE_PERCENTAGE)) {
-            if (resize_val_equal) {
-                old_val_equal = lyht_set_cb(ht, resize_val_equal);
-            }
-
-            /* enlarge */
-            ret = lyht_resize(ht, 1);
-            /* if hash_table was resized, we need to find new matching value */
-            if (ret == 0 && match_p) {
-                lyht_find(ht, val_p, hash, match_p);
-            }
-
-            if (resize_val_equal) {
-                lyht_set_cb(ht, old_val_equal);
-            }
-        }
-    }
+    ret = lyht_insert_resize(ht, val_p, hash, resize_val_equal, match_p);
 
     lyht_dbgprint_ht(ht, "after");
     return ret;
 }
 
-int
-lyht_insert(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
-{
-    return lyht_insert_with_resize_cb(ht, val_p, hash, NULL, match_p);
-}
-
 int
 lyht_remove(struct hash_table *ht, void *val_p, uint32_t hash)
 {
@@ -840,16 +1186,104 @@ lyht_remove(struct hash_table *ht, void *val_p, uint32_t hash)
     }
 
     /* check size & shrink if needed */
-    ret = 0;
     --ht->used;
-    if (ht->resize == 2) {
-        r = (ht->used * 100) / ht->size;
-        if ((r < LYHT_SHRINK_PERCENTAGE) && (ht->size > LYHT_MIN_SIZE)) {
-            /* shrink */
-            ret = lyht_resize(ht, 0);
+    ret = lyht_remove_resize(ht);
+
+    lyht_dbgprint_ht(ht, "after");
+    return ret;
+}
+
+#else /* LY_ENABLED_HT_ROBIN_HOOD */
+
+int
+lyht_insert_with_resize_cb(struct hash_table *ht, void *val_p, uint32_t hash,
+                           values_equal_cb resize_val_equal, void **match_p)
+{
+    struct ht_rec *rec, *prev;
+    uint32_t idx, last;
+    int32_t dist;
+    int ret;
+
+    lyht_dbgprint_ht(ht, "before");
+    lyht_dbgprint_value(val_p, hash, ht->rec_size, "inserting");
+
+    if (!lyht_rh_find(ht, val_p, hash, 1, &idx, &dist)) {
+        /* the value is already there */
+        if (match_p) {
+            *match_p = lyht_get_rec(ht->recs, ht->rec_size, idx)->val;
         }
+        return 1;
+    }
+    if (ht->used == ht->size) {
+        /* full table that cannot be resized */
+        LOGINT(NULL);
+        return -1;
+    }
+
+    /* find the first empty record, all the records from idx to it move one record further */
+    for (last = idx; lyht_get_rec(ht->recs, ht->rec_size, last)->hits; last = lyht_next_idx(ht, last));
+    for (rec = lyht_get_rec(ht->recs, ht->rec_size, last); last != idx; rec = prev) {
+        last = (last - 1) & (ht->size - 1);
+        prev = lyht_get_rec(ht->recs, ht->rec_size, last);
+        memcpy(rec, prev, ht->rec_size);
+        ++rec->hits;
+    }
+
+    /* insert it into the freed record */
+    rec = lyht_get_rec(ht->recs, ht->rec_size, idx);
+    rec->hash = hash;
+    rec->hits = dist;
+    memcpy(&rec->val, val_p, ht->rec_size - (sizeof(struct ht_rec) - 1));
+    if (match_p) {
+        *match_p = (void *)&rec->val;
     }
 
+    /* check size & enlarge if needed */
+    ++ht->used;
+    ret = lyht_insert_resize(ht, val_p, hash, resize_val_equal, match_p);
+
     lyht_dbgprint_ht(ht, "after");
     return ret;
 }
+
+int
+lyht_remove(struct hash_table *ht, void *val_p, uint32_t hash)
+{
+    struct ht_rec *rec, *next;
+    uint32_t idx;
+    int32_t dist;
+    int ret;
+
+    lyht_dbgprint_ht(ht, "before");
+    lyht_dbgprint_value(val_p, hash, ht->rec_size, "removing");
+
+    if (lyht_rh_find(ht, val_p, hash, 1, &idx, &dist)) {
+        LOGDBG(LY_LDGHASH, "remove failed");
+        return 1;
+    }
+
+    /* shift all the following records that are not in their hash record one record back */
+    rec = lyht_get_rec(ht->recs, ht->rec_size, idx);
+    for (idx = lyht_next_idx(ht, idx); (next = lyht_get_rec(ht->recs, ht->rec_size, idx))->hits > 1;
+            idx = lyht_next_idx(ht, idx)) {
+        memcpy(rec, next, ht->rec_size);
+        --rec->hits;
+        rec = next;
+    }
+    rec->hits = 0;
+
+    /* check size & shrink if needed */
+    --ht->used;
+    ret = lyht_remove_resize(ht);
+
+    lyht_dbgprint_ht(ht, "after");
+    return ret;
+}
+
+#endif /* LY_ENABLED_HT_ROBIN_HOOD */
+
+int
+lyht_insert(struct hash_table *ht, void *val_p, uint32_t hash, void **match_p)
+{
+    return lyht_insert_with_resize_cb(ht, val_p, hash, NULL, match_p);
+}
@@ -61,7 +61,8 @@ typedef int (*values_equal_cb)(void *val1_p, void *val2_p, int mod, void *cb_dat
 struct ht_rec {
     uint32_t hash;        /* hash of the value */
     int32_t hits;         /* (collision/overflow value count - 1) (a filled entry has 1 hit),
-                           * special value (-1) means a deleted record) */
+                           * special value (-1) means a deleted record),
+                           * Robin Hood table: (distance from the hash record + 1), never -1 */
     unsigned char val[1]; /* arbitrary-size value */
 } _PACKED;
 
@@ -71,6 +72,11 @@ struct ht_rec {
  * Hash table with open addressing collision resolution and
  * linear probing of interval 1 (next free record is used).
  * Removal is lazy (removed records are only marked).
+ *
+ * With LY_ENABLED_HT_ROBIN_HOOD, records are kept ordered by their hash record (Robin Hood
+ * hashing) so a search can stop at the first record closer to its hash record than
+ * the searched value would be. Removal shifts the following records back instead of marking
+ * the removed one so the probe sequences never get longer with deletions.
  */
 struct hash_table {
     uint32_t used;        /* number of values stored in the hash table (filled records) */
@@ -85,10 +91,20 @@ struct hash_table {
 };
 
 struct dict_rec {
-    char *value;
+    char *value;          /* dict_str::value */
     uint32_t refcount;
 } _PACKED;
 
+/**
+ * @brief Dictionary string stored together with its hash and length so that
+ * they can be learned from the string itself.
+ */
+struct dict_str {
+    uint32_t hash;        /* hash of the string as computed by the dictionary */
+    uint32_t len;         /* length of the string */
+    char value[1];        /* the string itself (the pointer returned by the dictionary) */
+};
+
 /**
  * dictionary to store repeating strings
  */
@@ -111,6 +127,100 @@ void lydict_init(struct dict_table *dict);
  */
 void lydict_clean(struct dict_table *dict);
 
+/**
+ * @brief Get the hash of a dictionary string without computing it.
+ *
+ * @param[in] value String from the dictionary.
+ * @return Hash of \p value.
+ */
+uint32_t lydict_hash(const char *value);
+
+/**
+ * @brief Get the length of a dictionary string without computing it.
+ *
+ * @param[in] value String from the dictionary.
+ * @return Length of \p value.
+ */
+size_t lydict_len(const char *value);
+
+/**
+ * @brief Add a dictionary string into a hash computed by dict_hash_multi(). Its
+ * stored hash is used instead of hashing the string again.
+ *
+ * @param[in] hash Hash from the last call.
+ * @param[in] value String from the dictionary.
+ * @return Updated hash.
+ */
+uint32_t lydict_hash_multi(uint32_t hash, const char *value);
+
+/**
+ * @brief Add any string into a hash computed by dict_hash_multi() the same way
+ * lydict_hash_multi() would add it if it was in the dictionary.
+ *
+ * @param[in] hash Hash from the last call.
+ * @param[in] str String to add, does not need to be terminated.
+ * @param[in] len Length of \p str.
+ * @return Updated hash.
+ */
+uint32_t dict_hash_multi_str(uint32_t hash, const char *str, size_t len);
+
+/* number of dictionary reference count changes applied at once */
+#define LY_DICT_BATCH_SIZE 64
+
+/**
+ * @brief Dictionary reference count changes postponed until the end of an operation.
+ */
+struct dict_batch {
+    struct ly_ctx *ctx;             /* context of the batched dictionary */
+    uint32_t depth;                 /* number of nested batches */
+    uint32_t count;                 /* number of used records */
+    struct dict_batch_rec {
+        const char *value;
+        uint32_t hash;
+        uint32_t len;
+        int inc;                    /* increase or decrease the reference count */
+    } recs[LY_DICT_BATCH_SIZE];
+};
+
+/**
+ * @brief Add a reference to a string already in the dictionary. Unlike lydict_insert(),
+ * the string is not searched for, only its reference count is increased.
+ *
+ * @param[in] ctx Context with the dictionary.
+ * @param[in] value String from the dictionary of \p ctx.
+ * @return \p value.
+ */
+const char *lydict_ref(struct ly_ctx *ctx, const char *value);
+
+/**
+ * @brief Remove a reference to a string from the dictionary. Unlike lydict_remove(), the value
+ * must be the pointer returned by the dictionary, its stored length and hash are used. Meant only for
+ * the hot paths freeing strings that always come from the dictionary (data nodes, XML elements),
+ * which is checked in debug builds.
+ *
+ * @param[in] ctx Context with the dictionary.
+ * @param[in] value String from the dictionary of \p ctx.
+ */
+void lydict_unref(struct ly_ctx *ctx, const char *value);
+
+/**
+ * @brief Start postponing reference count changes of the dictionary strings made by this thread
+ * by lydict_ref(), lydict_unref() and lydict_remove(). They are applied with a single dictionary lock for every
+ * #LY_DICT_BATCH_SIZE changes and by the matching lydict_batch_end(). Batches can be nested,
+ * only changes in \p ctx are batched.
+ *
+ * @param[in] ctx Context with the dictionary.
+ * @param[in] batch Batch storage, used only by the outermost batch and must be valid until it ends.
+ */
+void lydict_batch_start(struct ly_ctx *ctx, struct dict_batch *batch);
+
+/**
+ * @brief End a batch started by lydict_batch_start(), the outermost one applies all the changes.
+ *
+ * @param[in] ctx Context with the dictionary.
+ */
+void lydict_batch_end(struct ly_ctx *ctx);
+
 /**
  * @brief Get a specific record from a hash table.
  *
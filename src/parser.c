@@ -598,9 +598,60 @@ validate_length_range(uint8_t kind, uint64_t unum, int64_t snum, int64_t fnum, u
     return EXIT_SUCCESS;
 }
 
+#ifdef LY_ENABLED_CACHE
+
+static void lyp_precompiled_release(struct ly_ctx *ctx, const char *pattern, void *pcre_cmp);
+
+int
+lyp_precompile_type_patterns(struct ly_ctx *ctx, struct lys_type *type)
+{
+    void **pcres;
+    unsigned int i;
+    int ret = EXIT_SUCCESS;
+
+    assert(type->base == LY_TYPE_STRING);
+
+    if (!type->info.str.pat_count || __atomic_load_n(&type->info.str.patterns_pcre, __ATOMIC_ACQUIRE)) {
+        /* nothing to compile or already compiled */
+        return EXIT_SUCCESS;
+    }
+
+    /* there is no cache, build it, several threads validating data may get here at once */
+    pthread_mutex_lock(&ctx->compile_lock);
+    if (type->info.str.patterns_pcre) {
+        goto cleanup;
+    }
+
+    pcres = calloc(2 * type->info.str.pat_count, sizeof *pcres);
+    LY_CHECK_ERR_GOTO(!pcres, LOGMEM(ctx); ret = EXIT_FAILURE, cleanup);
+
+    for (i = 0; i < type->info.str.pat_count; ++i) {
+        if (lyp_precompile_pattern(ctx, &type->info.str.patterns[i].expr[1], (pcre **)&pcres[i * 2],
+                                   (pcre_extra **)&pcres[i * 2 + 1])) {
+            /* the compiled patterns are owned by the pattern cache */
+            while (i) {
+                --i;
+                lyp_precompiled_release(ctx, &type->info.str.patterns[i].expr[1], pcres[i * 2]);
+            }
+            free(pcres);
+            ret = EXIT_FAILURE;
+            goto cleanup;
+        }
+    }
+
+    /* publish the compiled patterns only when complete */
+    __atomic_store_n(&type->info.str.patterns_pcre, pcres, __ATOMIC_RELEASE);
+
+cleanup:
+    pthread_mutex_unlock(&ctx->compile_lock);
+    return ret;
+}
+
+#endif
+
 /* logs directly */
 static int
-validate_pattern(struct ly_ctx *ctx, const char *val_str, struct lys_type *type, struct lyd_node *node)
+validate_pattern_r(struct ly_ctx *ctx, const char *val_str, struct lys_type *type, struct lyd_node *node)
 {
     int rc;
     unsigned int i;
@@ -614,23 +665,13 @@ validate_pattern(struct ly_ctx *ctx, const char *val_str, struct lys_type *type,
         val_str = "";
     }
 
-    if (type->der && validate_pattern(ctx, val_str, &type->der->type, node)) {
+    if (type->der && validate_pattern_r(ctx, val_str, &type->der->type, node)) {
         return EXIT_FAILURE;
     }
 
 #ifdef LY_ENABLED_CACHE
-    /* there is no cache, build it */
-    if (!type->info.str.patterns_pcre && type->info.str.pat_count) {
-        type->info.str.patterns_pcre = malloc(2 * type->info.str.pat_count * sizeof *type->info.str.patterns_pcre);
-        LY_CHECK_ERR_RETURN(!type->info.str.patterns_pcre, LOGMEM(ctx), -1);
-
-        for (i = 0; i < type->info.str.pat_count; ++i) {
-            if (lyp_precompile_pattern(ctx, &type->info.str.patterns[i].expr[1],
-                                       (pcre**)&type->info.str.patterns_pcre[i * 2],
-                                       (pcre_extra**)&type->info.str.patterns_pcre[i * 2 + 1])) {
-                return EXIT_FAILURE;
-            }
-        }
+    if (lyp_precompile_type_patterns(ctx, type)) {
+        return EXIT_FAILURE;
     }
 #endif
 
@@ -823,20 +864,161 @@ error:
     return ret;
 }
 
+#ifdef LY_ENABLED_CACHE
+
 /**
- * @brief Checks pattern syntax. Logs directly.
+ * @brief Compiled pattern shared by all the string types in a context with the same pattern.
+ */
+struct lyp_pattern {
+    char *expr;               /* pattern in the YANG syntax or a Perl regex, see perl */
+    uint8_t perl;             /* expr is a combined Perl regex, see lyp_multi_pattern() */
+    uint32_t refcount;        /* number of types (and combined pattern records) using the pattern */
+    pcre *pcre_cmp;
+    pcre_extra *pcre_std;
+};
+
+/**
+ * @brief Combined pattern of a type, see #LY_CTX_MULTI_PATTERN.
+ */
+struct lyp_multi_rec {
+    const struct lys_type *type;
+    struct lyp_pattern *pat;     /* pattern from the cache hash_tab, &lyp_multi_none if the type has none */
+};
+
+/* marks types whose patterns are not worth combining */
+static struct lyp_pattern lyp_multi_none;
+
+static int
+lyp_pattern_cache_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lyp_pattern *pat1 = *(struct lyp_pattern **)val1_p, *pat2 = *(struct lyp_pattern **)val2_p;
+
+    return (pat1->perl == pat2->perl) && !strcmp(pat1->expr, pat2->expr);
+}
+
+static int
+lyp_multi_rec_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    return ((struct lyp_multi_rec *)val1_p)->type == ((struct lyp_multi_rec *)val2_p)->type;
+}
+
+static uint32_t
+lyp_pattern_hash(const char *pattern)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, pattern, strlen(pattern));
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+static uint32_t
+lyp_multi_hash(const struct lys_type *type)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, (const char *)&type, sizeof type);
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+static void
+lyp_pattern_free(struct lyp_pattern *pat)
+{
+    pcre_free_study(pat->pcre_std);
+    pcre_free(pat->pcre_cmp);
+    free(pat->expr);
+    free(pat);
+}
+
+struct lyp_pattern_cache *
+lyp_pattern_cache_new(void)
+{
+    struct lyp_pattern_cache *cache;
+
+    cache = calloc(1, sizeof *cache);
+    LY_CHECK_ERR_RETURN(!cache, LOGMEM(NULL), NULL);
+
+    cache->hash_tab = lyht_new(64, sizeof(struct lyp_pattern *), lyp_pattern_cache_equal, NULL, 1);
+    LY_CHECK_ERR_RETURN(!cache->hash_tab, LOGMEM(NULL); free(cache), NULL);
+    cache->multi_tab = lyht_new(8, sizeof(struct lyp_multi_rec), lyp_multi_rec_equal, NULL, 1);
+    LY_CHECK_ERR_RETURN(!cache->multi_tab, LOGMEM(NULL); lyht_free(cache->hash_tab); free(cache), NULL);
+    pthread_mutex_init(&cache->lock, NULL);
+
+    return cache;
+}
+
+void
+lyp_pattern_cache_free(struct lyp_pattern_cache *cache)
+{
+    struct ht_rec *rec;
+    uint32_t i;
+
+    if (!cache) {
+        return;
+    }
+
+    for (i = 0; i < cache->hash_tab->size; ++i) {
+        rec = lyht_get_rec(cache->hash_tab->recs, cache->hash_tab->rec_size, i);
+        if (rec->hits > 0) {
+            lyp_pattern_free(*(struct lyp_pattern **)&rec->val);
+        }
+    }
+    lyht_free(cache->hash_tab);
+    lyht_free(cache->multi_tab);
+    pthread_mutex_destroy(&cache->lock);
+    free(cache);
+}
+
+/**
+ * @brief Find a pattern in the context pattern cache.
  *
- * @param[in] pattern Pattern to check.
- * @param[out] pcre_precomp Precompiled PCRE pattern. Can be NULL.
- * @return EXIT_SUCCESS on success, EXIT_FAILURE otherwise.
+ * @param[in] ctx Context with the cache.
+ * @param[in] pattern Pattern in the YANG syntax or a Perl regex.
+ * @param[in] perl Whether \p pattern is a Perl regex.
+ * @param[in] ref Whether to add a reference to the found pattern, it must be released by lyp_pattern_release().
+ * @param[out] hash Hash of the pattern, optional.
+ * @return Compiled pattern, NULL if not in the cache.
  */
-int
-lyp_check_pattern(struct ly_ctx *ctx, const char *pattern, pcre **pcre_precomp)
+static struct lyp_pattern *
+lyp_pattern_cache_find(struct ly_ctx *ctx, const char *pattern, uint8_t perl, int ref, uint32_t *hash)
+{
+    struct lyp_pattern_cache *cache = ctx->pattern_cache;
+    struct lyp_pattern key, *key_p = &key, **match, *pat = NULL;
+    uint32_t h;
+
+    h = lyp_pattern_hash(pattern);
+    key.expr = (char *)pattern;
+    key.perl = perl;
+
+    pthread_mutex_lock(&cache->lock);
+    if (!lyht_find(cache->hash_tab, &key_p, h, (void **)&match)) {
+        pat = *match;
+        if (ref) {
+            ++pat->refcount;
+        }
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    if (hash) {
+        *hash = h;
+    }
+    return pat;
+}
+
+#endif
+
+/**
+ * @brief Convert a pattern into the equivalent Perl regular expression. Logs directly.
+ *
+ * @param[in] ctx Context for logging.
+ * @param[in] pattern Pattern in the YANG (XML Schema) syntax.
+ * @return Perl regular expression to be freed by the caller, NULL on error.
+ */
+static char *
+lyp_pattern_perl(struct ly_ctx *ctx, const char *pattern)
 {
-    int idx, idx2, start, end, err_offset, count;
+    int idx, idx2, start, end, count;
     char *perl_regex, *ptr;
-    const char *err_msg, *orig_ptr;
-    pcre *precomp;
+    const char *orig_ptr;
 
     /*
      * adjust the expression to a Perl equivalent
@@ -848,7 +1030,7 @@ lyp_check_pattern(struct ly_ctx *ctx, const char *pattern, pcre **pcre_precomp)
     for (count = 0, ptr = strchr(pattern, '$'); ptr; ++count, ptr = strchr(ptr + 1, '$'));
 
     perl_regex = malloc((strlen(pattern) + 4 + count) * sizeof(char));
-    LY_CHECK_ERR_RETURN(!perl_regex, LOGMEM(ctx), EXIT_FAILURE);
+    LY_CHECK_ERR_RETURN(!perl_regex, LOGMEM(ctx), NULL);
     perl_regex[0] = '\0';
 
     ptr = perl_regex;
@@ -883,7 +1065,7 @@ lyp_check_pattern(struct ly_ctx *ctx, const char *pattern, pcre **pcre_precomp)
         if (!ptr) {
             LOGVAL(ctx, LYE_INREGEX, LY_VLOG_NONE, NULL, pattern, perl_regex + start + 2, "unterminated character property");
             free(perl_regex);
-            return EXIT_FAILURE;
+            return NULL;
         }
 
         end = (ptr - perl_regex) + 1;
@@ -891,7 +1073,7 @@ lyp_check_pattern(struct ly_ctx *ctx, const char *pattern, pcre **pcre_precomp)
         /* need more space */
         if (end - start < LYP_URANGE_LEN) {
             perl_regex = ly_realloc(perl_regex, strlen(perl_regex) + (LYP_URANGE_LEN - (end - start)) + 1);
-            LY_CHECK_ERR_RETURN(!perl_regex, LOGMEM(ctx); free(perl_regex), EXIT_FAILURE);
+            LY_CHECK_ERR_RETURN(!perl_regex, LOGMEM(ctx); free(perl_regex), NULL);
         }
 
         /* find our range */
@@ -903,7 +1085,7 @@ lyp_check_pattern(struct ly_ctx *ctx, const char *pattern, pcre **pcre_precomp)
         if (!lyp_ublock2urange[idx][0]) {
             LOGVAL(ctx, LYE_INREGEX, LY_VLOG_NONE, NULL, pattern, perl_regex + start + 5, "unknown block name");
             free(perl_regex);
-            return EXIT_FAILURE;
+            return NULL;
         }
 
         /* make the space in the string and replace the block (but we cannot include brackets if it was already enclosed in them) */
@@ -925,6 +1107,36 @@ lyp_check_pattern(struct ly_ctx *ctx, const char *pattern, pcre **pcre_precomp)
         }
     }
 
+    return perl_regex;
+}
+
+/**
+ * @brief Checks pattern syntax. Logs directly.
+ *
+ * @param[in] pattern Pattern to check.
+ * @param[out] pcre_precomp Precompiled PCRE pattern. Can be NULL.
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE otherwise.
+ */
+int
+lyp_check_pattern(struct ly_ctx *ctx, const char *pattern, pcre **pcre_precomp)
+{
+    int err_offset;
+    char *perl_regex;
+    const char *err_msg;
+    pcre *precomp;
+
+#ifdef LY_ENABLED_CACHE
+    if (!pcre_precomp && lyp_pattern_cache_find(ctx, pattern, 0, 0, NULL)) {
+        /* already compiled, so valid */
+        return EXIT_SUCCESS;
+    }
+#endif
+
+    perl_regex = lyp_pattern_perl(ctx, pattern);
+    if (!perl_regex) {
+        return EXIT_FAILURE;
+    }
+
     /* must return 0, already checked during parsing */
     precomp = pcre_compile(perl_regex, PCRE_ANCHORED | PCRE_DOLLAR_ENDONLY | PCRE_NO_AUTO_CAPTURE,
                            &err_msg, &err_offset, NULL);
@@ -944,25 +1156,625 @@ lyp_check_pattern(struct ly_ctx *ctx, const char *pattern, pcre **pcre_precomp)
     return EXIT_SUCCESS;
 }
 
+#ifdef PCRE_STUDY_JIT_COMPILE
+
+/* initial and maximal size of the per-thread JIT stack */
+#define LYP_JIT_STACK_MIN (32 * 1024)
+#define LYP_JIT_STACK_MAX (1024 * 1024)
+
+static pthread_once_t lyp_jit_once = PTHREAD_ONCE_INIT;
+static pthread_key_t lyp_jit_stack_key;
+static int lyp_jit;
+
+static void
+lyp_jit_stack_free(void *stack)
+{
+    pcre_jit_stack_free(stack);
+}
+
+static void
+lyp_jit_init(void)
+{
+    if (pcre_config(PCRE_CONFIG_JIT, &lyp_jit)) {
+        lyp_jit = 0;
+    }
+    if (lyp_jit && pthread_key_create(&lyp_jit_stack_key, lyp_jit_stack_free)) {
+        lyp_jit = 0;
+    }
+}
+
+/**
+ * @brief PCRE JIT stack callback. A JIT stack cannot be used by several threads at once,
+ * so every thread matching patterns gets its own.
+ */
+static pcre_jit_stack *
+lyp_jit_stack(void *UNUSED(data))
+{
+    pcre_jit_stack *stack;
+
+    stack = pthread_getspecific(lyp_jit_stack_key);
+    if (!stack) {
+        stack = pcre_jit_stack_alloc(LYP_JIT_STACK_MIN, LYP_JIT_STACK_MAX);
+        if (stack && pthread_setspecific(lyp_jit_stack_key, stack)) {
+            pcre_jit_stack_free(stack);
+            stack = NULL;
+        }
+    }
+
+    /* with NULL, PCRE uses its small stack on the machine stack */
+    return stack;
+}
+
+#endif
+
+/**
+ * @brief Study a compiled pattern, JIT-compile it if supported by PCRE.
+ *
+ * @param[in] ctx Context for logging.
+ * @param[in] pattern Pattern in the YANG syntax for logging.
+ * @param[in] pcre_cmp Compiled pattern.
+ * @return Studied pattern, may be NULL also on success.
+ */
+static pcre_extra *
+lyp_study_pattern(struct ly_ctx *ctx, const char *pattern, pcre *pcre_cmp)
+{
+    pcre_extra *pcre_std;
+    const char *err_msg = NULL;
+    int options = 0;
+
+#ifdef PCRE_STUDY_JIT_COMPILE
+    pthread_once(&lyp_jit_once, lyp_jit_init);
+    if (lyp_jit) {
+        options |= PCRE_STUDY_JIT_COMPILE;
+    }
+#endif
+
+    pcre_std = pcre_study(pcre_cmp, options, &err_msg);
+    if (err_msg) {
+        LOGWRN(ctx, "Studying pattern \"%s\" failed (%s).", pattern, err_msg);
+    }
+
+#ifdef PCRE_STUDY_JIT_COMPILE
+    if (pcre_std && lyp_jit) {
+        pcre_assign_jit_stack(pcre_std, lyp_jit_stack, NULL);
+    }
+#endif
+
+    return pcre_std;
+}
+
+#ifdef LY_ENABLED_CACHE
+
+/**
+ * @brief Add a compiled pattern into the context pattern cache.
+ *
+ * @param[in] ctx Context with the cache.
+ * @param[in] pat Compiled pattern, it is spent.
+ * @param[in] hash Hash of the pattern.
+ * @return Cached pattern with a reference added, NULL on error.
+ */
+static struct lyp_pattern *
+lyp_pattern_cache_add(struct ly_ctx *ctx, struct lyp_pattern *pat, uint32_t hash)
+{
+    struct lyp_pattern_cache *cache = ctx->pattern_cache;
+    struct lyp_pattern **match;
+
+    pat->refcount = 1;
+
+    pthread_mutex_lock(&cache->lock);
+    switch (lyht_insert(cache->hash_tab, &pat, hash, (void **)&match)) {
+    case 0:
+        break;
+    case 1:
+        /* compiled by another thread in the meantime */
+        lyp_pattern_free(pat);
+        pat = *match;
+        ++pat->refcount;
+        break;
+    default:
+        pthread_mutex_unlock(&cache->lock);
+        LOGINT(ctx);
+        lyp_pattern_free(pat);
+        return NULL;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    return pat;
+}
+
+/**
+ * @brief Remove a reference to a cached pattern, free it with the last one.
+ *
+ * @param[in] ctx Context with the cache.
+ * @param[in] pat Cached pattern.
+ */
+static void
+lyp_pattern_release(struct ly_ctx *ctx, struct lyp_pattern *pat)
+{
+    struct lyp_pattern_cache *cache = ctx->pattern_cache;
+    int last = 0;
+
+    pthread_mutex_lock(&cache->lock);
+    if (!--pat->refcount) {
+        lyht_remove(cache->hash_tab, &pat, lyp_pattern_hash(pat->expr));
+        last = 1;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    if (last) {
+        lyp_pattern_free(pat);
+    }
+}
+
+/**
+ * @brief Release the cached pattern of a compiled pattern.
+ *
+ * @param[in] ctx Context with the cache.
+ * @param[in] pattern Pattern in the YANG syntax.
+ * @param[in] pcre_cmp Compiled pattern got from lyp_precompile_pattern().
+ */
+static void
+lyp_precompiled_release(struct ly_ctx *ctx, const char *pattern, void *pcre_cmp)
+{
+    struct lyp_pattern *pat;
+
+    pat = lyp_pattern_cache_find(ctx, pattern, 0, 0, NULL);
+    if (!pat || (pat->pcre_cmp != pcre_cmp)) {
+        LOGINT(ctx);
+        return;
+    }
+    lyp_pattern_release(ctx, pat);
+}
+
+void
+lyp_type_patterns_release(struct ly_ctx *ctx, struct lys_type *type)
+{
+    unsigned int i;
+
+    assert(type->base == LY_TYPE_STRING);
+
+    if (!ctx->pattern_cache || !type->info.str.patterns_pcre) {
+        return;
+    }
+
+    /* the patterns are compiled in their order and the expression of a pattern is set only after its compilation,
+     * the parsers may have stopped in the middle */
+    for (i = 0; (i < type->info.str.pat_count) && type->info.str.patterns[i].expr; ++i) {
+        if (type->info.str.patterns_pcre[2 * i]) {
+            lyp_precompiled_release(ctx, &type->info.str.patterns[i].expr[1], type->info.str.patterns_pcre[2 * i]);
+        }
+    }
+}
+
 int
 lyp_precompile_pattern(struct ly_ctx *ctx, const char *pattern, pcre** pcre_cmp, pcre_extra **pcre_std)
 {
-    const char *err_msg = NULL;
+    struct lyp_pattern *pat;
+    uint32_t hash;
+
+    pat = lyp_pattern_cache_find(ctx, pattern, 0, 1, &hash);
+    if (!pat) {
+        pat = calloc(1, sizeof *pat);
+        LY_CHECK_ERR_RETURN(!pat, LOGMEM(ctx), EXIT_FAILURE);
+        pat->expr = strdup(pattern);
+        LY_CHECK_ERR_RETURN(!pat->expr, LOGMEM(ctx); free(pat), EXIT_FAILURE);
+
+        if (lyp_check_pattern(ctx, pattern, &pat->pcre_cmp)) {
+            lyp_pattern_free(pat);
+            return EXIT_FAILURE;
+        }
+        pat->pcre_std = lyp_study_pattern(ctx, pattern, pat->pcre_cmp);
+
+        pat = lyp_pattern_cache_add(ctx, pat, hash);
+        if (!pat) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* the compiled pattern is owned by the cache, the caller holds a reference */
+    *pcre_cmp = pat->pcre_cmp;
+    if (pcre_std) {
+        *pcre_std = pat->pcre_std;
+    }
+    return EXIT_SUCCESS;
+}
+
+/* maximum number of union member types combined into a single pattern */
+#define LYP_MULTI_MEMBERS_MAX 64
+
+/**
+ * @brief Append a string to a dynamic combined pattern.
+ */
+static int
+lyp_multi_append(struct ly_ctx *ctx, char **regex, size_t *len, const char *str)
+{
+    size_t str_len = strlen(str);
+
+    *regex = ly_realloc(*regex, *len + str_len + 1);
+    LY_CHECK_ERR_RETURN(!*regex, LOGMEM(ctx), -1);
+    memcpy(*regex + *len, str, str_len + 1);
+    *len += str_len;
+
+    return 0;
+}
+
+/**
+ * @brief Append all the patterns of a string type and its base types to a combined pattern, each as
+ * a lookahead assertion so that all of them are matched from the beginning of the value.
+ *
+ * @param[in] ctx Context.
+ * @param[in] type String type.
+ * @param[in,out] regex Combined pattern.
+ * @param[in,out] len Length of the combined pattern.
+ * @param[out] count Number of appended patterns, optional.
+ * @return 0 on success, -1 on error.
+ */
+static int
+lyp_multi_append_type(struct ly_ctx *ctx, struct lys_type *type, char **regex, size_t *len, unsigned int *count)
+{
+    unsigned int i;
+    char *perl_regex;
+    int ret;
+
+    assert(type->base == LY_TYPE_STRING);
+
+    while (1) {
+        for (i = 0; i < type->info.str.pat_count; ++i) {
+            perl_regex = lyp_pattern_perl(ctx, &type->info.str.patterns[i].expr[1]);
+            if (!perl_regex) {
+                return -1;
+            }
+            ret = lyp_multi_append(ctx, regex, len, (type->info.str.patterns[i].expr[0] == 0x06) ? "(?=" : "(?!");
+            ret = ret ? ret : lyp_multi_append(ctx, regex, len, perl_regex);
+            ret = ret ? ret : lyp_multi_append(ctx, regex, len, ")");
+            free(perl_regex);
+            if (ret) {
+                return -1;
+            }
+            if (count) {
+                ++(*count);
+            }
+        }
+
+        if (!type->der) {
+            break;
+        }
+        type = &type->der->type;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Create a combined pattern of a type.
+ *
+ * For a string type, it matches all the patterns of the type and its base types at once. For a union,
+ * it is an alternation of all the member types in their order, each marked with an empty capturing
+ * group, so the matched group is the first member whose patterns match the value. Members without
+ * patterns (including other than string types) match any value.
+ *
+ * @param[in] ctx Context.
+ * @param[in] type String or union type.
+ * @return Combined pattern, &lyp_multi_none if not worth it, NULL on error.
+ */
+static struct lyp_pattern *
+lyp_multi_pattern_create(struct ly_ctx *ctx, struct lys_type *type)
+{
+    struct lyp_pattern *pat;
+    struct lys_type *t;
+    char *regex = NULL, marker[16];
+    const char *err_msg;
+    size_t len = 0;
+    unsigned int count = 0, idx;
+    int found = 0, err_offset;
+    uint32_t hash;
+
+    if (type->base == LY_TYPE_STRING) {
+        if (lyp_multi_append_type(ctx, type, &regex, &len, &count)) {
+            goto error;
+        }
+        if (count < 2) {
+            /* nothing to combine */
+            free(regex);
+            return &lyp_multi_none;
+        }
+    } else {
+        assert(type->base == LY_TYPE_UNION);
+
+        if (lyp_multi_append(ctx, &regex, &len, "(?:")) {
+            goto error;
+        }
+        for (t = lyp_get_next_union_type(type, NULL, &found), idx = 0; t; t = lyp_get_next_union_type(type, t, &found), ++idx) {
+            found = 0;
+            if (idx == LYP_MULTI_MEMBERS_MAX) {
+                free(regex);
+                return &lyp_multi_none;
+            }
+
+            count = 0;
+            if ((t->base == LY_TYPE_STRING) && lyp_multi_append_type(ctx, t, &regex, &len, &count)) {
+                goto error;
+            }
+            if (!idx && !count) {
+                /* the first member may always match, nothing to skip */
+                free(regex);
+                return &lyp_multi_none;
+            }
+
+            sprintf(marker, "(?<m%u>)", idx);
+            if (lyp_multi_append(ctx, &regex, &len, marker)) {
+                goto error;
+            }
+            if (!count) {
+                /* this member may always match, the following ones are never reached */
+                break;
+            }
+            if (lyp_multi_append(ctx, &regex, &len, "|")) {
+                goto error;
+            }
+        }
+        if (regex[len - 1] == '|') {
+            regex[--len] = '\0';
+        }
+        if (lyp_multi_append(ctx, &regex, &len, ")")) {
+            goto error;
+        }
+    }
+
+    pat = lyp_pattern_cache_find(ctx, regex, 1, 1, &hash);
+    if (pat) {
+        free(regex);
+        return pat;
+    }
+
+    pat = calloc(1, sizeof *pat);
+    LY_CHECK_ERR_GOTO(!pat, LOGMEM(ctx), error);
+    pat->expr = regex;
+    pat->perl = 1;
+
+    pat->pcre_cmp = pcre_compile(regex, PCRE_ANCHORED | PCRE_DOLLAR_ENDONLY | PCRE_NO_AUTO_CAPTURE, &err_msg, &err_offset, NULL);
+    if (!pat->pcre_cmp) {
+        /* the patterns are valid, but they may be too large together */
+        lyp_pattern_free(pat);
+        return &lyp_multi_none;
+    }
+    pat->pcre_std = lyp_study_pattern(ctx, regex, pat->pcre_cmp);
+
+    return lyp_pattern_cache_add(ctx, pat, hash);
+
+error:
+    free(regex);
+    return NULL;
+}
+
+/**
+ * @brief Find the combined pattern of a type in the cache, the caller must hold the cache lock
+ * unless the context is frozen.
+ *
+ * @param[in] cache Context pattern cache.
+ * @param[in] type String or union type.
+ * @return Combined pattern, NULL if not created yet.
+ */
+static struct lyp_pattern *
+lyp_multi_pattern_find_(struct lyp_pattern_cache *cache, const struct lys_type *type)
+{
+    struct lyp_multi_rec rec, *match;
+
+    rec.type = type;
+    if (!lyht_find(cache->multi_tab, &rec, lyp_multi_hash(type), (void **)&match)) {
+        return match->pat;
+    }
+
+    return NULL;
+}
+
+struct lyp_pattern *
+lyp_multi_pattern_find(struct ly_ctx *ctx, const struct lys_type *type)
+{
+    struct lyp_pattern_cache *cache = ctx->pattern_cache;
+    struct lyp_pattern *pat;
+
+    pthread_mutex_lock(&cache->lock);
+    pat = lyp_multi_pattern_find_(cache, type);
+    pthread_mutex_unlock(&cache->lock);
+
+    return pat;
+}
+
+/**
+ * @brief Get the combined pattern of a type, create it if not yet done.
+ *
+ * @param[in] ctx Context.
+ * @param[in] type String or union type.
+ * @return Combined pattern, NULL if there is none.
+ */
+static struct lyp_pattern *
+lyp_multi_pattern(struct ly_ctx *ctx, struct lys_type *type)
+{
+    struct lyp_pattern_cache *cache = ctx->pattern_cache;
+    struct lyp_multi_rec rec;
+    uint32_t hash;
+    int ret;
+
+    if (ctx->frozen) {
+        /* ly_ctx_freeze() created all the combined patterns and the cache is not changed anymore */
+        rec.pat = lyp_multi_pattern_find_(cache, type);
+        return (rec.pat == &lyp_multi_none) ? NULL : rec.pat;
+    }
+
+    rec.type = type;
+    rec.pat = lyp_multi_pattern_find(ctx, type);
+    if (!rec.pat) {
+        rec.pat = lyp_multi_pattern_create(ctx, type);
+        if (!rec.pat) {
+            return NULL;
+        }
+
+        /* the combined patterns are shared in the cache, any concurrent thread stores the same one */
+        hash = lyp_multi_hash(type);
+        pthread_mutex_lock(&cache->lock);
+        ret = lyht_insert(cache->multi_tab, &rec, hash, NULL);
+        pthread_mutex_unlock(&cache->lock);
+        if (ret && (rec.pat != &lyp_multi_none)) {
+            /* only the records hold references, the one stored by another thread has the same pattern */
+            lyp_pattern_release(ctx, rec.pat);
+        }
+        if (ret == -1) {
+            LOGMEM(ctx);
+            return NULL;
+        }
+    }
+
+    return (rec.pat == &lyp_multi_none) ? NULL : rec.pat;
+}
+
+int
+lyp_multi_pattern_precompile(struct ly_ctx *ctx, struct lys_type *type)
+{
+    assert((type->base == LY_TYPE_STRING) || (type->base == LY_TYPE_UNION));
+
+    if (!(ctx->models.flags & LY_CTX_MULTI_PATTERN) || ctx->frozen) {
+        return EXIT_SUCCESS;
+    }
+
+    lyp_multi_pattern(ctx, type);
+    if (!lyp_multi_pattern_find(ctx, type)) {
+        /* error already logged */
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void
+lyp_multi_pattern_forget(struct ly_ctx *ctx, const struct lys_type *type)
+{
+    struct lyp_pattern_cache *cache = ctx->pattern_cache;
+    struct lyp_multi_rec rec, *match;
+    uint32_t hash;
+    int found = 0;
+
+    if (!cache) {
+        return;
+    }
+
+    hash = lyp_multi_hash(type);
+    rec.type = type;
+
+    pthread_mutex_lock(&cache->lock);
+    if (cache->multi_tab->used && !lyht_find(cache->multi_tab, &rec, hash, (void **)&match)) {
+        rec.pat = match->pat;
+        lyht_remove(cache->multi_tab, &rec, hash);
+        found = 1;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    if (found && (rec.pat != &lyp_multi_none)) {
+        lyp_pattern_release(ctx, rec.pat);
+    }
+}
+
+/**
+ * @brief Match a value against all the patterns of a string type at once.
+ *
+ * @param[in] ctx Context.
+ * @param[in] type String type.
+ * @param[in] val_str Value to match.
+ * @return 1 if all the patterns match, 0 if not or unknown.
+ */
+static int
+lyp_multi_pattern_match(struct ly_ctx *ctx, struct lys_type *type, const char *val_str)
+{
+    struct lyp_pattern *pat;
+
+    pat = lyp_multi_pattern(ctx, type);
+    if (!pat) {
+        return 0;
+    }
 
+    return !pcre_exec(pat->pcre_cmp, pat->pcre_std, val_str, strlen(val_str), 0, 0, NULL, 0);
+}
+
+int
+lyp_multi_pattern_union(struct ly_ctx *ctx, struct lys_type *type, const char *value)
+{
+    struct lyp_pattern *pat;
+    int ovector[3 * (LYP_MULTI_MEMBERS_MAX + 1)];
+    int rc, i;
+
+    assert(type->base == LY_TYPE_UNION);
+
+    if (!(ctx->models.flags & LY_CTX_MULTI_PATTERN)) {
+        return 0;
+    }
+
+    pat = lyp_multi_pattern(ctx, type);
+    if (!pat) {
+        return 0;
+    }
+
+    if (!value) {
+        value = "";
+    }
+    memset(ovector, -1, sizeof ovector);
+    rc = pcre_exec(pat->pcre_cmp, pat->pcre_std, value, strlen(value), 0, 0, ovector, 3 * (LYP_MULTI_MEMBERS_MAX + 1));
+    if (rc == PCRE_ERROR_NOMATCH) {
+        /* no member can match */
+        return -1;
+    } else if (rc < 0) {
+        return 0;
+    }
+
+    /* group i + 1 is the marker of member i */
+    for (i = 1; i <= LYP_MULTI_MEMBERS_MAX; ++i) {
+        if (ovector[2 * i] != -1) {
+            return i - 1;
+        }
+    }
+
+    return 0;
+}
+
+#else
+
+int
+lyp_precompile_pattern(struct ly_ctx *ctx, const char *pattern, pcre** pcre_cmp, pcre_extra **pcre_std)
+{
     if (lyp_check_pattern(ctx, pattern, pcre_cmp)) {
         return EXIT_FAILURE;
     }
 
     if (pcre_std && pcre_cmp) {
-        (*pcre_std) = pcre_study(*pcre_cmp, 0, &err_msg);
-        if (err_msg) {
-            LOGWRN(ctx, "Studying pattern \"%s\" failed (%s).", pattern, err_msg);
-        }
+        (*pcre_std) = lyp_study_pattern(ctx, pattern, *pcre_cmp);
     }
 
     return EXIT_SUCCESS;
 }
 
+int
+lyp_multi_pattern_union(struct ly_ctx *UNUSED(ctx), struct lys_type *UNUSED(type), const char *UNUSED(value))
+{
+    /* the combined patterns are kept in the pattern cache */
+    return 0;
+}
+
+#endif
+
+/* logs directly */
+static int
+validate_pattern(struct ly_ctx *ctx, const char *val_str, struct lys_type *type, struct lyd_node *node)
+{
+#ifdef LY_ENABLED_CACHE
+    if ((ctx->models.flags & LY_CTX_MULTI_PATTERN) && lyp_multi_pattern_match(ctx, type, val_str ? val_str : "")) {
+        /* all the patterns matched at once */
+        return EXIT_SUCCESS;
+    }
+#endif
+
+    /* match the patterns one by one, also to find the one not matching */
+    return validate_pattern_r(ctx, val_str, type, node);
+}
+
 /**
  * @brief Change the value into its canonical form. In libyang, additionally to the RFC,
  * all identities have their module as a prefix in their canonical form.
@@ -1204,7 +2016,8 @@ ident_val_add_module_prefix(const char *value, const struct lyxml_elem *xml, str
  * local_mod - optional if the local module dos not match the module of leaf/attr
  * store - flag for union resolution - we do not want to store the result, we are just learning the type
  * dflt - whether the value is a default value from the schema
- * trusted - whether the value is trusted to be valid (but may not be canonical, so it is canonized)
+ * trusted - whether the value is trusted to be valid (but may not be canonical, so it is canonized),
+ *           2 if only the patterns of a string type are known to match
  */
 struct lys_type *
 lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *xml,
@@ -1214,7 +2027,7 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
     struct lys_type *ret = NULL, *t;
     struct lys_tpdf *tpdf;
     enum int_log_opts prev_ilo;
-    int c, len, found = 0;
+    int c, len, found = 0, first, idx;
     unsigned int i, j;
     int64_t num;
     uint64_t unum, uind, u = 0;
@@ -1724,7 +2537,7 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
         break;
 
     case LY_TYPE_STRING:
-        if (!trusted && validate_length_range(0, (value ? ly_strlen_utf8(value) : 0), 0, 0, 0, type, value, contextnode)) {
+        if ((trusted != 1) && validate_length_range(0, (value ? ly_strlen_utf8(value) : 0), 0, 0, 0, type, value, contextnode)) {
             goto error;
         }
 
@@ -1935,12 +2748,19 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
         t = NULL;
         found = 0;
 
+        /* skip the members whose patterns do not match */
+        first = lyp_multi_pattern_union(ctx, type, value);
+
         /* turn logging off, we are going to try to validate the value with all the types in order */
         ly_ilo_change(NULL, ILO_IGNORE, &prev_ilo, NULL);
 
-        while ((t = lyp_get_next_union_type(type, t, &found))) {
+        for (idx = 0; (t = lyp_get_next_union_type(type, t, &found)); ++idx) {
             found = 0;
-            ret = lyp_parse_value(t, value_, xml, leaf, attr, NULL, store, dflt, 0);
+            if ((first == -1) || (idx < first)) {
+                continue;
+            }
+            ret = lyp_parse_value(t, value_, xml, leaf, attr, NULL, store, dflt,
+                                  ((idx == first) && (t->base == LY_TYPE_STRING)) ? 2 : 0);
             if (ret) {
                 /* we have the result */
                 type = ret;
@@ -3688,6 +4508,10 @@ lyp_ctx_add_module(struct lys_module *module)
         module->ctx->models.size *= 2;
         module->ctx->models.list = newlist;
     }
+    if (ly_ctx_mod_index_add(module)) {
+        LOGMEM(module->ctx);
+        return -1;
+    }
     module->ctx->models.list[module->ctx->models.used++] = module;
     module->ctx->models.module_set_id++;
 
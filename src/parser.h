@@ -16,6 +16,7 @@
 #define LY_PARSER_H_
 
 #include <pcre.h>
+#include <pthread.h>
 #include <sys/mman.h>
 
 #include "libyang.h"
@@ -95,6 +96,18 @@ int lyp_yin_parse_subnode_ext(struct lys_module *mod, void *elem, LYEXT_PAR elem
 
 struct lys_type *lyp_get_next_union_type(struct lys_type *type, struct lys_type *prev_type, int *found);
 
+/**
+ * @brief Find the first member type of a union whose patterns match a value, using a single pattern
+ * combining the patterns of all the members. Used only with #LY_CTX_MULTI_PATTERN.
+ *
+ * @param[in] ctx Context.
+ * @param[in] type Union type.
+ * @param[in] value Value to match.
+ * @return Index of the first member (in the lyp_get_next_union_type() order) that may accept the value,
+ * 0 if not known, -1 if no member can accept it.
+ */
+int lyp_multi_pattern_union(struct ly_ctx *ctx, struct lys_type *type, const char *value);
+
 /* return: 0 - ret set, ok; 1 - ret not set, no log, unknown meta; -1 - ret not set, log, fatal error */
 int lyp_fill_attr(struct ly_ctx *ctx, struct lyd_node *parent, const char *module_ns, const char *module_name,
                   const char *attr_name, const char *attr_value, struct lyxml_elem *xml, int options, struct lyd_attr **ret);
@@ -108,8 +121,101 @@ struct lys_type *lyp_parse_value(struct lys_type *type, const char **value_, str
 int lyp_check_length_range(struct ly_ctx *ctx, const char *expr, struct lys_type *type);
 
 int lyp_check_pattern(struct ly_ctx *ctx, const char *pattern, pcre **pcre_precomp);
+
+/**
+ * @brief Compile and study a pattern, JIT-compile it if supported. Logs directly.
+ *
+ * With the cache enabled, the compiled pattern is taken from the context pattern cache (or added into it)
+ * and it must not be freed by the caller.
+ *
+ * @param[in] ctx Context.
+ * @param[in] pattern Pattern in the YANG syntax.
+ * @param[out] pcre_cmp Compiled pattern.
+ * @param[out] pcre_std Studied pattern, can be NULL.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
 int lyp_precompile_pattern(struct ly_ctx *ctx, const char *pattern, pcre** pcre_cmp, pcre_extra **pcre_std);
 
+#ifdef LY_ENABLED_CACHE
+
+/**
+ * @brief Context cache of compiled patterns.
+ *
+ * The same pattern is usually restricting many types (typedef copies, groupings instantiated by uses,
+ * the common types such as those from ietf-inet-types used by many modules), it is compiled only once.
+ * The invert-match modifier is applied when matching, it does not affect the compiled pattern. Patterns
+ * are reference counted, so those of the freed types (removed modules) do not stay in the cache.
+ */
+struct lyp_pattern_cache {
+    struct hash_table *hash_tab; /* compiled patterns (struct lyp_pattern *) keyed by their string */
+    struct hash_table *multi_tab; /* combined patterns of the types (struct lyp_multi_rec) keyed by the type */
+    pthread_mutex_t lock;
+};
+
+/**
+ * @brief Create a context cache of compiled patterns.
+ *
+ * @return Pattern cache, NULL on error.
+ */
+struct lyp_pattern_cache *lyp_pattern_cache_new(void);
+
+/**
+ * @brief Free a context cache of compiled patterns with all the patterns.
+ *
+ * @param[in] cache Pattern cache to free.
+ */
+void lyp_pattern_cache_free(struct lyp_pattern_cache *cache);
+
+/**
+ * @brief Precompile all the patterns of a string type into its cache, if not yet done.
+ *
+ * The patterns of copied types (groupings instantiated by uses, augments, deviations) and of the trusted schemas
+ * are not compiled when parsing the schema, but only when first needed. The function can be called concurrently.
+ *
+ * @param[in] ctx Context of the type.
+ * @param[in] type String type.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int lyp_precompile_type_patterns(struct ly_ctx *ctx, struct lys_type *type);
+
+/**
+ * @brief Release the compiled patterns of a string type from the context pattern cache.
+ *
+ * @param[in] ctx Context of the type.
+ * @param[in] type String type that is being freed.
+ */
+void lyp_type_patterns_release(struct ly_ctx *ctx, struct lys_type *type);
+
+/**
+ * @brief Get the combined pattern of a type, see #LY_CTX_MULTI_PATTERN.
+ *
+ * @param[in] ctx Context of the type.
+ * @param[in] type String or union type.
+ * @return Combined pattern, NULL if not created yet.
+ */
+struct lyp_pattern *lyp_multi_pattern_find(struct ly_ctx *ctx, const struct lys_type *type);
+
+/**
+ * @brief Create the combined pattern of a type in advance, see ly_ctx_freeze(). Does nothing
+ * without #LY_CTX_MULTI_PATTERN.
+ *
+ * @param[in] ctx Context of the type.
+ * @param[in] type String or union type.
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on error.
+ */
+int lyp_multi_pattern_precompile(struct ly_ctx *ctx, struct lys_type *type);
+
+/**
+ * @brief Drop the combined pattern of a type from the context pattern cache, if created. It must be called
+ * whenever the type is freed or its contents move, the combined patterns are kept by the type address.
+ *
+ * @param[in] ctx Context of the type.
+ * @param[in] type String or union type.
+ */
+void lyp_multi_pattern_forget(struct ly_ctx *ctx, const struct lys_type *type);
+
+#endif
+
 int fill_yin_type(struct lys_module *module, struct lys_node *parent, struct lyxml_elem *yin, struct lys_type *type,
                   int tpdftype, struct unres_schema *unres);
 
@@ -964,7 +964,8 @@ json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *sch
                         }
                     }
                 }
-            } else {
+            } else if (lys_child_find(NULL, module, module->ns, name, strlen(name), 0, (const struct lys_node **)&schema)
+                    || !schema) {
                 /* get the proper schema node */
                 while ((schema = (struct lys_node *) lys_getnext(schema, NULL, module, 0))) {
                     if (!strcmp(schema->name, name)) {
@@ -999,7 +1000,13 @@ json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *sch
             schema = NULL;
         }
 
-        if (schema_parent) {
+        if (!prefix) {
+            module = schema_parent ? lys_node_module(schema_parent) : lyd_node_module(*parent);
+        }
+        if (module && !lys_child_find(schema_parent ? schema_parent : (*parent)->schema, NULL, module->ns, name, strlen(name),
+                                      0, (const struct lys_node **)&schema)) {
+            /* found in the schema index */
+        } else if (schema_parent) {
             while ((schema = (struct lys_node *)lys_getnext(schema, schema_parent, NULL, 0))) {
                 if (!strcmp(schema->name, name)
                         && ((prefix && !strcmp(lys_node_module(schema)->name, prefix))
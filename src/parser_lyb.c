@@ -52,6 +52,31 @@ lyb_read(const char *data, uint8_t *buf, size_t count, struct lyb_state *lybs)
 
     assert(data && lybs);
 
+    if ((lybs->header & LYB_HEADER_STREAM) && lybs->used) {
+        while (count) {
+            if (!lybs->written[lybs->used - 1]) {
+                /* next data segment */
+                if ((data[ret] == (char)LYB_STREAM_END) || (data[ret] == (char)LYB_STREAM_START)) {
+                    LOGERR(lybs->ctx, LY_EINVAL, "Invalid LYB data, unexpected end of a data segment.");
+                    return -1;
+                }
+                lybs->written[lybs->used - 1] = (uint8_t)data[ret];
+                ++ret;
+            }
+
+            to_read = (count < lybs->written[lybs->used - 1]) ? count : lybs->written[lybs->used - 1];
+            if (buf) {
+                memcpy(buf, data + ret, to_read);
+                buf += to_read;
+            }
+            lybs->written[lybs->used - 1] -= to_read;
+            count -= to_read;
+            ret += to_read;
+        }
+
+        return ret;
+    }
+
     while (1) {
         /* check for fully-read (empty) data chunks */
         to_read = count;
@@ -106,6 +131,17 @@ lyb_read(const char *data, uint8_t *buf, size_t count, struct lyb_state *lybs)
     return ret;
 }
 
+/* whether there is anything left in the current subtree */
+static int
+lyb_subtree_left(const char *data, struct lyb_state *lybs)
+{
+    if (lybs->written[lybs->used - 1]) {
+        return 1;
+    }
+
+    return ((lybs->header & LYB_HEADER_STREAM) && (data[0] != (char)LYB_STREAM_END)) ? 1 : 0;
+}
+
 static int
 lyb_read_number(void *num, size_t num_size, size_t bytes, const char *data, struct lyb_state *lybs)
 {
@@ -168,6 +204,25 @@ lyb_read_string(const char *data, char **str, int with_length, struct lyb_state
     if (with_length) {
         ret += (r = lyb_read_number(&len, sizeof len, 2, data, lybs));
         LYB_HAVE_READ_GOTO(r, data, error);
+    } else if (lybs->header & LYB_HEADER_STREAM) {
+        /* read all the data segments until the end of this subtree */
+        *str = malloc(sizeof **str);
+        LY_CHECK_ERR_RETURN(!*str, LOGMEM(lybs->ctx), -1);
+
+        while (lyb_subtree_left(data, lybs)) {
+            cur_len = lybs->written[lybs->used - 1] ? lybs->written[lybs->used - 1] : (uint8_t)data[0];
+
+            *str = ly_realloc(*str, (len + cur_len + 1) * sizeof **str);
+            LY_CHECK_ERR_RETURN(!*str, LOGMEM(lybs->ctx), -1);
+
+            ret += (r = lyb_read(data, ((uint8_t *)*str) + len, cur_len, lybs));
+            LYB_HAVE_READ_GOTO(r, data, error);
+
+            len += cur_len;
+        }
+
+        ((char *)*str)[len] = '\0';
+        return ret;
     } else {
         /* read until the end of this subtree */
         len = lybs->written[lybs->used - 1];
@@ -208,14 +263,53 @@ error:
     return -1;
 }
 
-static void
-lyb_read_stop_subtree(struct lyb_state *lybs)
+/* read a value string, possibly from the string table, and return it in the dictionary */
+static int
+lyb_read_value_str(const char *data, const char **str, struct lyb_state *lybs)
+{
+    int r, ret = 0;
+    uint64_t idx = 0;
+    char *buf;
+
+    if (lybs->header & LYB_HEADER_STRTABLE) {
+        ret += (r = lyb_read_enum(&idx, lybs->str_count + 1, data, lybs));
+        LYB_HAVE_READ_RETURN(r, data, -1);
+
+        if (idx > lybs->str_count) {
+            LOGERR(lybs->ctx, LY_EINVAL, "Invalid LYB string table index %" PRIu64 ".", idx);
+            return -1;
+        } else if (idx) {
+            *str = lydict_insert(lybs->ctx, lybs->strs[idx - 1], 0);
+            return ret;
+        }
+    }
+
+    ret += (r = lyb_read_string(data, &buf, 0, lybs));
+    LYB_HAVE_READ_RETURN(r, data, -1);
+
+    *str = lydict_insert_zc(lybs->ctx, buf);
+    return ret;
+}
+
+static int
+lyb_read_stop_subtree(const char *data, struct lyb_state *lybs)
 {
+    if (lybs->header & LYB_HEADER_STREAM) {
+        if (lybs->written[lybs->used - 1] || (data[0] != (char)LYB_STREAM_END)) {
+            LOGERR(lybs->ctx, LY_EINVAL, "Invalid LYB data, expected the end of a subtree.");
+            return -1;
+        }
+
+        --lybs->used;
+        return 1;
+    }
+
     if (lybs->written[lybs->used - 1]) {
         LOGINT(lybs->ctx);
     }
 
     --lybs->used;
+    return 0;
 }
 
 static int
@@ -223,6 +317,11 @@ lyb_read_start_subtree(const char *data, struct lyb_state *lybs)
 {
     uint8_t meta_buf[LYB_META_BYTES];
 
+    if ((lybs->header & LYB_HEADER_STREAM) && lybs->used && lybs->written[lybs->used - 1]) {
+        LOGERR(lybs->ctx, LY_EINVAL, "Invalid LYB data, unexpected start of a subtree.");
+        return -1;
+    }
+
     if (lybs->used == lybs->size) {
         lybs->size += LYB_STATE_STEP;
         lybs->written = ly_realloc(lybs->written, lybs->size * sizeof *lybs->written);
@@ -231,6 +330,20 @@ lyb_read_start_subtree(const char *data, struct lyb_state *lybs)
         LY_CHECK_ERR_RETURN(!lybs->written || !lybs->position || !lybs->inner_chunks, LOGMEM(lybs->ctx), -1);
     }
 
+    if (lybs->header & LYB_HEADER_STREAM) {
+        if (data[0] != (char)LYB_STREAM_START) {
+            LOGERR(lybs->ctx, LY_EINVAL, "Invalid LYB data, expected the start of a subtree.");
+            return -1;
+        }
+
+        /* nothing known about the subtree yet */
+        ++lybs->used;
+        lybs->written[lybs->used - 1] = 0;
+        lybs->inner_chunks[lybs->used - 1] = 0;
+        lybs->position[lybs->used - 1] = 0;
+        return 1;
+    }
+
     memcpy(meta_buf, data, LYB_META_BYTES);
 
     ++lybs->used;
@@ -374,17 +487,12 @@ lyb_parse_val_1(struct lys_type *type, LY_DATA_TYPE value_type, uint8_t value_fl
 {
     int r, ret;
     size_t i;
-    char *str = NULL;
     uint8_t byte;
     uint64_t num;
 
     if (value_flags & LY_VALUE_USER) {
         /* just read value_str */
-        ret = lyb_read_string(data, &str, 0, lybs);
-        if (ret > -1) {
-            *value_str = lydict_insert_zc(lybs->ctx, str);
-        }
-        return ret;
+        return lyb_read_value_str(data, value_str, lybs);
     }
 
     /* find the correct structure, go through leafrefs and typedefs */
@@ -406,19 +514,13 @@ lyb_parse_val_1(struct lys_type *type, LY_DATA_TYPE value_type, uint8_t value_fl
     case LY_TYPE_IDENT:
     case LY_TYPE_UNION:
         /* we do not actually fill value now, but value_str */
-        ret = lyb_read_string(data, &str, 0, lybs);
-        if (ret > -1) {
-            *value_str = lydict_insert_zc(lybs->ctx, str);
-        }
+        ret = lyb_read_value_str(data, value_str, lybs);
         break;
     case LY_TYPE_BINARY:
     case LY_TYPE_STRING:
     case LY_TYPE_UNKNOWN:
         /* read string */
-        ret = lyb_read_string(data, &str, 0, lybs);
-        if (ret > -1) {
-            value->string = lydict_insert_zc(lybs->ctx, str);
-        }
+        ret = lyb_read_value_str(data, &value->string, lybs);
         break;
     case LY_TYPE_BITS:
         value->bit = calloc(type->info.bits.count, sizeof *value->bit);
@@ -811,6 +913,46 @@ lyb_parse_attr_name(const struct lys_module *mod, const char *data, struct lys_e
     return ret;
 }
 
+static int
+lyb_skip_subtree(const char *data, struct lyb_state *lybs)
+{
+    int r, ret = 0, depth = 0;
+    uint8_t token;
+
+    if (lybs->header & LYB_HEADER_STREAM) {
+        /* skip the rest of the current segment */
+        ret = lybs->written[lybs->used - 1];
+        lybs->written[lybs->used - 1] = 0;
+
+        /* and everything up to the end token of this subtree, which is left to be read */
+        while (depth || (data[ret] != (char)LYB_STREAM_END)) {
+            token = data[ret++];
+            if (token == LYB_STREAM_START) {
+                ++depth;
+            } else if (token == LYB_STREAM_END) {
+                --depth;
+            } else {
+                ret += token;
+            }
+        }
+
+        return ret;
+    }
+
+    do {
+        /* first skip any meta information inside */
+        r = lybs->inner_chunks[lybs->used - 1] * LYB_META_BYTES;
+        data += r;
+        ret += r;
+
+        /* then read data */
+        ret += (r = lyb_read(data, NULL, lybs->written[lybs->used - 1], lybs));
+        LYB_HAVE_READ_RETURN(r, data, -1);
+    } while (lybs->written[lybs->used - 1]);
+
+    return ret;
+}
+
 static int
 lyb_parse_attributes(struct lyd_node *node, const char *data, int options, struct unres_data *unres, struct lyb_state *lybs)
 {
@@ -842,10 +984,8 @@ lyb_parse_attributes(struct lyd_node *node, const char *data, int options, struc
 
         if (!mod || !ext) {
             /* unknown attribute, skip it */
-            do {
-                ret += (r = lyb_read(data, NULL, lybs->written[lybs->used - 1], lybs));
-                LYB_HAVE_READ_GOTO(r, data, error);
-            } while (lybs->written[lybs->used - 1]);
+            ret += (r = lyb_skip_subtree(data, lybs));
+            LYB_HAVE_READ_GOTO(r, data, error);
             goto stop_subtree;
         }
 
@@ -881,7 +1021,8 @@ lyb_parse_attributes(struct lyd_node *node, const char *data, int options, struc
         LYB_HAVE_READ_GOTO(r, data, error);
 
 stop_subtree:
-        lyb_read_stop_subtree(lybs);
+        ret += (r = lyb_read_stop_subtree(data, lybs));
+        LYB_HAVE_READ_GOTO(r, data, error);
     }
 
     return ret;
@@ -908,13 +1049,106 @@ lyb_is_schema_hash_match(struct lys_node *sibling, LYB_HASH *hash, uint8_t hash_
     return 1;
 }
 
+/**
+ * @brief Record of the parser sibling hash table.
+ */
+struct lyb_sib_rec {
+    struct lys_node *node;
+    uint32_t pos;                /* position of the node in lys_getnext() order */
+};
+
+static int
+lyb_sib_rec_equal(void *val1_p, void *val2_p, int mod, void *UNUSED(cb_data))
+{
+    if (mod) {
+        /* exactly this record */
+        return ((struct lyb_sib_rec *)val1_p)->node == ((struct lyb_sib_rec *)val2_p)->node;
+    }
+
+    /* any node with the same collision ID 0 hash */
+    return 1;
+}
+
+/* builds the sibling hash table used by the parser, see lyb_sib_cache_get() */
+static struct hash_table *
+lyb_parse_siblings(const struct lys_node *parent, const struct lys_module *mod)
+{
+    struct hash_table *ht;
+    struct lyb_sib_rec rec;
+
+    ht = lyht_new(8, sizeof rec, lyb_sib_rec_equal, NULL, 1);
+    LY_CHECK_ERR_RETURN(!ht, LOGMEM(mod ? mod->ctx : parent->module->ctx), NULL);
+
+    rec.node = NULL;
+    rec.pos = 0;
+    /* the state is checked when the node is found */
+    while ((rec.node = (struct lys_node *)lys_getnext(rec.node, parent, mod, LYS_GETNEXT_NOSTATECHECK))) {
+        if (lyht_insert(ht, &rec, lyb_hash(rec.node, 0), NULL)) {
+            LOGINT(rec.node->module->ctx);
+            lyht_free(ht);
+            return NULL;
+        }
+        ++rec.pos;
+    }
+
+    return ht;
+}
+
+/**
+ * @brief Find the first sibling in lys_getnext() order with the given hashes using the parser sibling hash table.
+ *
+ * @param[in] ht Parser sibling hash table.
+ * @param[in] sparent Schema parent of the siblings.
+ * @param[in] mod Module of the siblings.
+ * @param[in] hash Read hashes starting with collision ID 0.
+ * @param[in] hash_count Number of hashes.
+ * @param[in] lybs LYB state.
+ * @return Matching sibling, NULL if there is none.
+ */
+static struct lys_node *
+lyb_find_sibling(struct hash_table *ht, const struct lys_node *sparent, const struct lys_module *mod, LYB_HASH *hash,
+                 uint8_t hash_count, struct lyb_state *lybs)
+{
+    struct lyb_sib_rec key, *rec, *found = NULL;
+    struct lys_node *iter;
+
+    if (!sparent && (mod->disabled || !mod->implemented)) {
+        /* lys_getnext() returns nothing from such a module */
+        return NULL;
+    }
+
+    key.node = NULL;
+    if (lyht_find(ht, &key, hash[0], (void **)&rec)) {
+        return NULL;
+    }
+
+    do {
+        /* skip schema nodes from models not present during printing */
+        if ((!found || (rec->pos < found->pos)) && lyb_has_schema_model(rec->node, lybs->models, lybs->mod_count)
+                && lyb_is_schema_hash_match(rec->node, hash, hash_count)) {
+            /* lys_getnext() skips disabled nodes including the transparent ones on the way */
+            for (iter = rec->node; iter && (iter != sparent); iter = lys_parent(iter)) {
+                if (lys_is_disabled(iter, 0)) {
+                    break;
+                }
+            }
+            if (!iter || (iter == sparent)) {
+                found = rec;
+            }
+        }
+    } while (!lyht_find_next(ht, rec, hash[0], (void **)&rec));
+
+    return found ? found->node : NULL;
+}
+
 static int
 lyb_parse_schema_hash(const struct lys_node *sparent, const struct lys_module *mod, const char *data, const char *yang_data_name,
                       int options, struct lys_node **snode, struct lyb_state *lybs)
 {
-    int r, ret = 0;
+    int r, ret = 0, dynamic;
     uint8_t i, j;
     struct lys_node *sibling;
+    struct hash_table *sibling_ht;
     LYB_HASH hash[LYB_HASH_BITS - 1];
 
     assert((sparent || mod) && (!sparent || !mod));
@@ -974,13 +1208,13 @@ lyb_parse_schema_hash(const struct lys_node *sparent, const struct lys_module *m
     }
 
     /* find our node with matching hashes */
-    sibling = NULL;
-    while ((sibling = (struct lys_node *)lys_getnext(sibling, sparent, mod, 0))) {
-        /* skip schema nodes from models not present during printing */
-        if (lyb_has_schema_model(sibling, lybs->models, lybs->mod_count) && lyb_is_schema_hash_match(sibling, hash, i + 1)) {
-            /* match found */
-            break;
-        }
+    sibling_ht = lyb_sib_cache_get(lybs->ctx, sparent, mod ? mod : lys_node_module(sparent), 1, lyb_parse_siblings, &dynamic);
+    if (!sibling_ht) {
+        return -1;
+    }
+    sibling = lyb_find_sibling(sibling_ht, sparent, mod, hash, i + 1, lybs);
+    if (dynamic) {
+        lyht_free(sibling_ht);
     }
 
 finish:
@@ -999,25 +1233,6 @@ finish:
     return ret;
 }
 
-static int
-lyb_skip_subtree(const char *data, struct lyb_state *lybs)
-{
-    int r, ret = 0;
-
-    do {
-        /* first skip any meta information inside */
-        r = lybs->inner_chunks[lybs->used - 1] * LYB_META_BYTES;
-        data += r;
-        ret += r;
-
-        /* then read data */
-        ret += (r = lyb_read(data, NULL, lybs->written[lybs->used - 1], lybs));
-        LYB_HAVE_READ_RETURN(r, data, -1);
-    } while (lybs->written[lybs->used - 1]);
-
-    return ret;
-}
-
 static int
 lyb_parse_subtree(const char *data, struct lyd_node *parent, struct lyd_node **first_sibling, const char *yang_data_name,
         int options, struct unres_data *unres, struct lyb_state *lybs)
@@ -1116,7 +1331,7 @@ lyb_parse_subtree(const char *data, struct lyd_node *parent, struct lyd_node **f
     }
 
     /* read all descendants */
-    while (lybs->written[lybs->used - 1]) {
+    while (lyb_subtree_left(data, lybs)) {
         ret += (r = lyb_parse_subtree(data, node, NULL, NULL, options, unres, lybs));
         LYB_HAVE_READ_GOTO(r, data, error);
     }
@@ -1144,7 +1359,8 @@ lyb_parse_subtree(const char *data, struct lyd_node *parent, struct lyd_node **f
 
 stop_subtree:
     /* end the subtree */
-    lyb_read_stop_subtree(lybs);
+    ret += (r = lyb_read_stop_subtree(data, lybs));
+    LYB_HAVE_READ_GOTO(r, data, error);
 
     return ret;
 
@@ -1179,6 +1395,50 @@ lyb_parse_data_models(const char *data, int options, struct lyb_state *lybs)
     return ret;
 }
 
+static int
+lyb_parse_str_table(const char *data, struct lyb_state *lybs)
+{
+    int r, ret = 0;
+    uint32_t i;
+    char *str;
+
+    /* read string count */
+    ret += (r = lyb_read_number(&lybs->str_count, sizeof lybs->str_count, 4, data, lybs));
+    LYB_HAVE_READ_RETURN(r, data, -1);
+
+    if (lybs->str_count) {
+        lybs->strs = calloc(lybs->str_count, sizeof *lybs->strs);
+        LY_CHECK_ERR_RETURN(!lybs->strs, LOGMEM(lybs->ctx), -1);
+
+        /* read strings, only skip them if there is no context */
+        for (i = 0; i < lybs->str_count; ++i) {
+            ret += (r = lyb_read_string(data, &str, 1, lybs));
+            LYB_HAVE_READ_RETURN(r, data, -1);
+
+            if (lybs->ctx) {
+                lybs->strs[i] = lydict_insert_zc(lybs->ctx, str);
+            } else {
+                free(str);
+            }
+        }
+    }
+
+    return ret;
+}
+
+static void
+lyb_free_str_table(struct lyb_state *lybs)
+{
+    uint32_t i;
+
+    if (lybs->ctx) {
+        for (i = 0; i < lybs->str_count; ++i) {
+            lydict_unref(lybs->ctx, lybs->strs[i]);
+        }
+    }
+    free(lybs->strs);
+}
+
 static int
 lyb_parse_magic_number(const char *data, struct lyb_state *lybs)
 {
@@ -1215,9 +1475,15 @@ lyb_parse_header(const char *data, struct lyb_state *lybs)
     int ret = 0;
     uint8_t byte = 0;
 
-    /* TODO version, any flags? */
+    /* TODO version? */
     ret += lyb_read(data, (uint8_t *)&byte, sizeof byte, lybs);
 
+    if (byte & ~(LYB_HEADER_STREAM | LYB_HEADER_STRTABLE)) {
+        LOGERR(lybs->ctx, LY_EINVAL, "Invalid LYB header flags \"0x%02x\".", byte);
+        return -1;
+    }
+    lybs->header = byte;
+
     return ret;
 }
 
@@ -1244,6 +1510,9 @@ lyd_parse_lyb(struct ly_ctx *ctx, const char *data, int options, const struct ly
     lybs.models = NULL;
     lybs.mod_count = 0;
     lybs.ctx = ctx;
+    lybs.header = 0;
+    lybs.strs = NULL;
+    lybs.str_count = 0;
 
     unres = calloc(1, sizeof *unres);
     LY_CHECK_ERR_GOTO(!unres, LOGMEM(ctx), finish);
@@ -1260,6 +1529,12 @@ lyd_parse_lyb(struct ly_ctx *ctx, const char *data, int options, const struct ly
     ret += (r = lyb_parse_data_models(data, options, &lybs));
     LYB_HAVE_READ_GOTO(r, data, finish);
 
+    if (lybs.header & LYB_HEADER_STRTABLE) {
+        /* read string table */
+        ret += (r = lyb_parse_str_table(data, &lybs));
+        LYB_HAVE_READ_GOTO(r, data, finish);
+    }
+
     /* read subtree(s) */
     while (data[0]) {
         ret += (r = lyb_parse_subtree(data, NULL, &node, yang_data_name, options, unres, &lybs));
@@ -1306,6 +1581,7 @@ finish:
     free(lybs.position);
     free(lybs.inner_chunks);
     free(lybs.models);
+    lyb_free_str_table(&lybs);
     if (unres) {
         free(unres->node);
         free(unres->type);
@@ -1341,6 +1617,9 @@ lyd_lyb_data_length(const char *data)
     lybs.models = NULL;
     lybs.mod_count = 0;
     lybs.ctx = NULL;
+    lybs.header = 0;
+    lybs.strs = NULL;
+    lybs.str_count = 0;
 
     /* read magic number */
     ret += (r = lyb_parse_magic_number(data, &lybs));
@@ -1370,6 +1649,12 @@ lyd_lyb_data_length(const char *data)
         LYB_HAVE_READ_GOTO(r, data, finish);
     }
 
+    if (lybs.header & LYB_HEADER_STRTABLE) {
+        /* skip string table */
+        ret += (r = lyb_parse_str_table(data, &lybs));
+        LYB_HAVE_READ_GOTO(r, data, finish);
+    }
+
     while (data[0]) {
         /* register a new subtree */
         ret += (r = lyb_read_start_subtree(data, &lybs));
@@ -1380,7 +1665,8 @@ lyd_lyb_data_length(const char *data)
         LYB_HAVE_READ_GOTO(r, data, finish);
 
         /* subtree finished */
-        lyb_read_stop_subtree(&lybs);
+        ret += (r = lyb_read_stop_subtree(data, &lybs));
+        LYB_HAVE_READ_GOTO(r, data, finish);
     }
 
     /* read the last zero, parsing finished */
@@ -1391,5 +1677,6 @@ finish:
     free(lybs.position);
     free(lybs.inner_chunks);
     free(lybs.models);
+    lyb_free_str_table(&lybs);
     return ret;
 }
@@ -73,6 +73,19 @@ xml_data_search_schemanode(struct lyxml_elem *xml, struct lys_node *start, int o
     return NULL;
 }
 
+/* does not log, finds the schema node among the children of parent or the top-level nodes of module */
+static struct lys_node *
+xml_data_find_schemanode(struct lyxml_elem *xml, const struct lys_node *parent, const struct lys_module *module, int options)
+{
+    const struct lys_node *snode;
+
+    if (!lys_child_find(parent, module, xml->ns->value, xml->name, strlen(xml->name), LYS_GETNEXT_NOSTATECHECK, &snode)) {
+        return (struct lys_node *)snode;
+    }
+
+    return xml_data_search_schemanode(xml, parent ? parent->child : module->data, options);
+}
+
 /* logs directly */
 static int
 xml_get_value(struct lyd_node *node, struct lyxml_elem *xml, int editbits, int trusted)
@@ -163,7 +176,7 @@ xml_parse_data(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *pare
                     }
                 }
             } else {
-                schema = xml_data_search_schemanode(xml, mod->data, options);
+                schema = xml_data_find_schemanode(xml, NULL, mod, options);
                 if (!schema) {
                     /* it still can be the specific case of this module containing an augment of another module
                     * top-level choice or top-level choice's case, bleh */
@@ -195,7 +208,7 @@ xml_parse_data(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *pare
         }
     } else {
         /* parsing some internal node, we start with parent's schema pointer */
-        schema = xml_data_search_schemanode(xml, parent->schema->child, options);
+        schema = xml_data_find_schemanode(xml, parent->schema, NULL, options);
 
         if (ctx->data_clb) {
             if (schema && !lys_node_module(schema)->implemented) {
@@ -204,7 +217,7 @@ xml_parse_data(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *pare
             } else if (!schema) {
                 if (ctx->data_clb(ctx, NULL, xml->ns->value, 0, ctx->data_clb_data)) {
                     /* context was updated, so try to find the schema node again */
-                    schema = xml_data_search_schemanode(xml, parent->schema->child, options);
+                    schema = xml_data_find_schemanode(xml, parent->schema, NULL, options);
                 }
             }
         }
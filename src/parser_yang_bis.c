@@ -4478,6 +4478,7 @@ yyreduce:
                                                                         actual = NULL;
 #ifdef LY_ENABLED_CACHE
                                                                         if ((yyvsp[-2].backup_token).token != EXTENSION_INSTANCE &&
+                                                                            !(trg->ctx->models.flags & LY_CTX_TRUSTED) &&
                                                                             !(data_node && data_node->nodetype != LYS_GROUPING && lys_ingrouping(data_node))) {
                                                                           unsigned int c = 2 * (((struct yang_type *)(yyvsp[-2].backup_token).actual)->type->info.str.pat_count - 1);
                                                                           YANG_ADDELEM(((struct yang_type *)(yyvsp[-2].backup_token).actual)->type->info.str.patterns_pcre, c, "patterns");
@@ -1431,8 +1431,8 @@ fill_yin_type(struct lys_module *module, struct lys_node *parent, struct lyxml_e
             type->info.str.patterns = calloc(i, sizeof *type->info.str.patterns);
             LY_CHECK_ERR_GOTO(!type->info.str.patterns, LOGMEM(ctx), error);
 #ifdef LY_ENABLED_CACHE
-            if (!in_grp) {
-                /* do not compile patterns in groupings */
+            if (!in_grp && !(ctx->models.flags & LY_CTX_TRUSTED)) {
+                /* do not compile patterns in groupings, trusted patterns are compiled on demand */
                 type->info.str.patterns_pcre = calloc(2 * i, sizeof *type->info.str.patterns_pcre);
                 LY_CHECK_ERR_GOTO(!type->info.str.patterns_pcre, LOGMEM(ctx), error);
             }
@@ -1447,7 +1447,7 @@ fill_yin_type(struct lys_module *module, struct lys_node *parent, struct lyxml_e
                     }
                 }
 #ifdef LY_ENABLED_CACHE
-                else {
+                else if (!(ctx->models.flags & LY_CTX_TRUSTED)) {
                     /* outside grouping, check syntax and precompile pattern for later use by libpcre */
                     if (lyp_precompile_pattern(ctx, value,
                             (pcre **)&type->info.str.patterns_pcre[type->info.str.pat_count * 2],
@@ -8298,7 +8298,7 @@ lyp_yin_parse_complex_ext(struct lys_module *mod, struct lys_ext_instance_comple
             LY_CHECK_ERR_GOTO(!(*(struct lys_restr **)p)->expr, LOGMEM(mod->ctx), error);
             ((char *)(*(struct lys_restr **)p)->expr)[0] = modifier;
             strcpy(&((char *)(*(struct lys_restr **)p)->expr)[1], value);
-            lydict_insert_zc(mod->ctx, (char *)(*(struct lys_restr **)p)->expr);
+            (*(struct lys_restr **)p)->expr = lydict_insert_zc(mod->ctx, (char *)(*(struct lys_restr **)p)->expr);
 
             /* get possible sub-statements */
             if (read_restr_substmt(mod, *(struct lys_restr **)p, node, unres)) {
@@ -197,12 +197,12 @@ lyb_check_augments(struct lys_node *parent, struct hash_table *ht)
 
 #endif
 
+/* builds the sibling hash table used by the printer, see lyb_sib_cache_get() */
 static struct hash_table *
-lyb_hash_siblings(struct lys_node *sibling, const struct lys_module **models, int mod_count)
+lyb_hash_siblings(const struct lys_node *parent, const struct lys_module *mod)
 {
     struct hash_table *ht;
-    struct lys_node *parent;
-    const struct lys_module *mod;
+    struct lys_node *sibling;
     int i, j;
 #ifndef NDEBUG
     int aug_col = 0;
@@ -210,21 +210,11 @@ lyb_hash_siblings(struct lys_node *sibling, const struct lys_module **models, in
 #endif
 
     ht = lyht_new(1, sizeof(struct lys_node *), lyb_hash_equal_cb, NULL, 1);
-    LY_CHECK_ERR_RETURN(!ht, LOGMEM(sibling->module->ctx), NULL);
-
-    for (parent = lys_parent(sibling);
-         parent && (parent->nodetype & (LYS_USES | LYS_CHOICE | LYS_CASE));
-         parent = lys_parent(parent));
-    mod = lys_node_module(sibling);
+    LY_CHECK_ERR_RETURN(!ht, LOGMEM(mod->ctx), NULL);
 
     sibling = NULL;
     /* ignore features so that their state does not affect hashes */
     while ((sibling = (struct lys_node *)lys_getnext(sibling, parent, mod, LYS_GETNEXT_NOSTATECHECK))) {
-        if (models && !lyb_has_schema_model(sibling, models, mod_count)) {
-            /* ignore models not present during printing */
-            continue;
-        }
-
 #ifndef NDEBUG
         if (sibling->parent && sibling->parent->nodetype == LYS_AUGMENT && lys_node_module(sibling->parent) != mod) {
             if (aug_mod && aug_mod != lys_node_module(sibling->parent)) {
@@ -279,7 +269,7 @@ lyb_hash_siblings(struct lys_node *sibling, const struct lys_module **models, in
 
 #ifndef NDEBUG
     if (aug_col) {
-        lyb_check_augments(parent, ht);
+        lyb_check_augments((struct lys_node *)parent, ht);
     }
 #endif
 
@@ -316,6 +306,26 @@ lyb_hash_find(struct hash_table *ht, struct lys_node *node)
     return hash;
 }
 
+/* write the buffered data segment of the current subtree (streamed variant) */
+static int
+lyb_write_segment(struct lyout *out, struct lyb_state *lybs)
+{
+    uint8_t len;
+
+    if (!lybs->used || !lybs->written[lybs->used - 1]) {
+        /* nothing buffered */
+        return 0;
+    }
+
+    len = lybs->written[lybs->used - 1];
+    if ((ly_write(out, (char *)&len, 1) < 1) || (ly_write(out, (char *)lybs->seg, len) < len)) {
+        return -1;
+    }
+    lybs->written[lybs->used - 1] = 0;
+
+    return 1;
+}
+
 /* writing function handles writing size information */
 static int
 lyb_write(struct lyout *out, const uint8_t *buf, size_t count, struct lyb_state *lybs)
@@ -326,6 +336,31 @@ lyb_write(struct lyout *out, const uint8_t *buf, size_t count, struct lyb_state
 
     assert(out && lybs);
 
+    if ((lybs->header & LYB_HEADER_STREAM) && lybs->used) {
+        /* only buffer the data until the segment is full */
+        while (count) {
+            to_write = LYB_STREAM_SEG_MAX - lybs->written[lybs->used - 1];
+            if (to_write > count) {
+                to_write = count;
+            }
+
+            memcpy(lybs->seg + lybs->written[lybs->used - 1], buf, to_write);
+            lybs->written[lybs->used - 1] += to_write;
+            count -= to_write;
+            buf += to_write;
+            ret += to_write;
+
+            if (lybs->written[lybs->used - 1] == LYB_STREAM_SEG_MAX) {
+                if (lyb_write_segment(out, lybs) < 0) {
+                    return -1;
+                }
+                ++ret;
+            }
+        }
+
+        return ret;
+    }
+
     while (1) {
         /* check for full data chunks */
         to_write = count;
@@ -404,6 +439,22 @@ lyb_write_stop_subtree(struct lyout *out, struct lyb_state *lybs)
     int r;
     uint8_t meta_buf[LYB_META_BYTES];
 
+    if (lybs->header & LYB_HEADER_STREAM) {
+        /* finish the last segment and write the end token */
+        r = lyb_write_segment(out, lybs);
+        if (r < 0) {
+            return -1;
+        }
+
+        meta_buf[0] = LYB_STREAM_END;
+        if (ly_write(out, (char *)meta_buf, 1) < 1) {
+            return -1;
+        }
+
+        --lybs->used;
+        return r + 1;
+    }
+
     /* write the meta chunk information */
     meta_buf[0] = lybs->written[lybs->used - 1] & 0xFF;
     meta_buf[1] = lybs->inner_chunks[lybs->used - 1] & 0xFF;
@@ -420,7 +471,16 @@ lyb_write_stop_subtree(struct lyout *out, struct lyb_state *lybs)
 static int
 lyb_write_start_subtree(struct lyout *out, struct lyb_state *lybs)
 {
-    int i;
+    int i, r = 0;
+    uint8_t token;
+
+    if (lybs->header & LYB_HEADER_STREAM) {
+        /* the segment of the parent subtree must be written first */
+        r = lyb_write_segment(out, lybs);
+        if (r < 0) {
+            return -1;
+        }
+    }
 
     if (lybs->used == lybs->size) {
         lybs->size += LYB_STATE_STEP;
@@ -434,6 +494,15 @@ lyb_write_start_subtree(struct lyout *out, struct lyb_state *lybs)
     lybs->written[lybs->used - 1] = 0;
     lybs->inner_chunks[lybs->used - 1] = 0;
 
+    if (lybs->header & LYB_HEADER_STREAM) {
+        /* no sizes, just the start token */
+        token = LYB_STREAM_START;
+        if (ly_write(out, (char *)&token, 1) < 1) {
+            return -1;
+        }
+        return r + 1;
+    }
+
     /* another inner chunk */
     for (i = 0; i < lybs->used - 1; ++i) {
         if (lybs->inner_chunks[i] == LYB_INCHUNK_MAX) {
@@ -504,6 +573,53 @@ lyb_write_string(const char *str, size_t str_len, int with_length, struct lyout
     return ret;
 }
 
+/* string table record */
+struct lyb_str_rec {
+    const char *str;
+    uint32_t count;             /* occurrences in the data */
+    uint32_t idx;               /* index in the string table, 0 if not there */
+};
+
+static int
+lyb_str_rec_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    /* all the value strings are in the dictionary */
+    return ((struct lyb_str_rec *)val1_p)->str == ((struct lyb_str_rec *)val2_p)->str;
+}
+
+static int
+lyb_write_value_str(const char *str, struct lyout *out, struct lyb_state *lybs)
+{
+    int r, ret = 0;
+    uint32_t idx = 0;
+    struct lyb_str_rec rec, *match;
+
+    if (lybs->header & LYB_HEADER_STRTABLE) {
+        /* string table index first */
+        rec.str = str;
+        if (!lyht_find(lybs->str_ht, &rec, lydict_hash(str), (void **)&match)) {
+            idx = match->idx;
+        }
+
+        ret += (r = lyb_write_enum(idx, lybs->str_count + 1, out, lybs));
+        if (r < 0) {
+            return -1;
+        }
+
+        if (idx) {
+            /* the string is in the table */
+            return ret;
+        }
+    }
+
+    ret += (r = lyb_write_string(str, lydict_len(str), 0, out, lybs));
+    if (r < 0) {
+        return -1;
+    }
+
+    return ret;
+}
+
 static int
 lyb_print_model(struct lyout *out, const struct lys_module *mod, struct lyb_state *lybs)
 {
@@ -638,6 +754,126 @@ next_mod:
     return ret;
 }
 
+/* whether the value is printed as a string, must match lyb_print_value() */
+static int
+lyb_is_value_str(const struct lys_type *type, lyd_val value, LY_DATA_TYPE value_type, uint8_t value_flags)
+{
+    while (type->base == LY_TYPE_LEAFREF) {
+        type = &type->info.lref.target->type;
+    }
+
+    if ((value_flags & LY_VALUE_USER) || (type->base == LY_TYPE_UNION)) {
+        return 1;
+    }
+    while ((value_type == LY_TYPE_LEAFREF) && !(value_flags & LY_VALUE_UNRES)) {
+        value_type = ((struct lyd_node_leaf_list *)value.leafref)->value_type;
+        value = ((struct lyd_node_leaf_list *)value.leafref)->value;
+    }
+
+    switch (value_type) {
+    case LY_TYPE_BINARY:
+    case LY_TYPE_INST:
+    case LY_TYPE_STRING:
+    case LY_TYPE_UNION:
+    case LY_TYPE_IDENT:
+    case LY_TYPE_UNKNOWN:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static int
+lyb_count_str(const char *str, struct lyb_state *lybs)
+{
+    struct lyb_str_rec rec, *match;
+    const char **strs;
+    size_t len;
+    int r;
+
+    rec.str = str;
+    rec.count = 1;
+    rec.idx = 0;
+    r = lyht_insert(lybs->str_ht, &rec, lydict_hash(str), (void **)&match);
+    if (r < 0) {
+        LOGINT(lybs->ctx);
+        return -1;
+    } else if (!r || (++match->count > 2)) {
+        /* first occurrence or already decided */
+        return 0;
+    }
+
+    /* repeated string, add it into the table unless it is too short or too long */
+    len = lydict_len(str);
+    if ((len < LYB_STRTABLE_MIN_LEN) || (len > UINT16_MAX)) {
+        return 0;
+    }
+
+    strs = ly_realloc(lybs->strs, (lybs->str_count + 1) * sizeof *lybs->strs);
+    LY_CHECK_ERR_RETURN(!strs, LOGMEM(lybs->ctx), -1);
+    lybs->strs = strs;
+
+    lybs->strs[lybs->str_count] = str;
+    match->idx = ++lybs->str_count;
+    return 0;
+}
+
+static int
+lyb_print_str_table(struct lyout *out, const struct lyd_node *root, int options, struct lyb_state *lybs)
+{
+    int r, ret = 0;
+    const struct lyd_node *top, *next, *elem;
+    const struct lyd_node_leaf_list *leaf;
+    const struct lyd_attr *attr;
+    struct lys_type **type;
+    uint32_t i;
+
+    lybs->str_ht = lyht_new(8, sizeof(struct lyb_str_rec), lyb_str_rec_equal, NULL, 1);
+    LY_CHECK_ERR_RETURN(!lybs->str_ht, LOGMEM(lybs->ctx), -1);
+
+    /* collect all the repeated value strings */
+    LY_TREE_FOR(root, top) {
+        LY_TREE_DFS_BEGIN(top, next, elem) {
+            LY_TREE_FOR(elem->attr, attr) {
+                type = (struct lys_type **)lys_ext_complex_get_substmt(LY_STMT_TYPE, attr->annotation, NULL);
+                if (type && *type && lyb_is_value_str(*type, attr->value, attr->value_type, attr->value_flags)
+                        && lyb_count_str(attr->value_str, lybs)) {
+                    return -1;
+                }
+            }
+
+            if (elem->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST)) {
+                leaf = (const struct lyd_node_leaf_list *)elem;
+                if (lyb_is_value_str(&((struct lys_node_leaf *)elem->schema)->type, leaf->value, leaf->value_type,
+                                     leaf->value_flags) && lyb_count_str(leaf->value_str, lybs)) {
+                    return -1;
+                }
+            }
+            LY_TREE_DFS_END(top, next, elem);
+        }
+
+        if (!(options & LYP_WITHSIBLINGS)) {
+            break;
+        }
+    }
+
+    /* string count on 4 bytes */
+    ret += (r = lyb_write_number(lybs->str_count, 4, out, lybs));
+    if (r < 0) {
+        return -1;
+    }
+
+    /* and the strings with their length */
+    for (i = 0; i < lybs->str_count; ++i) {
+        ret += (r = lyb_write_string(lybs->strs[i], lydict_len(lybs->strs[i]), 1, out, lybs));
+        if (r < 0) {
+            return -1;
+        }
+    }
+
+    return ret;
+}
+
 static int
 lyb_print_magic_number(struct lyout *out)
 {
@@ -652,12 +888,13 @@ lyb_print_magic_number(struct lyout *out)
 }
 
 static int
-lyb_print_header(struct lyout *out)
+lyb_print_header(struct lyout *out, struct lyb_state *lybs)
 {
     int ret = 0;
     uint8_t byte = 0;
 
-    /* TODO version, some other flags? */
+    /* TODO version? */
+    byte = lybs->header;
     ret += ly_write(out, (char *)&byte, sizeof byte);
 
     return ret;
@@ -771,7 +1008,7 @@ lyb_print_value(const struct lys_type *type, const char *value_str, lyd_val valu
     case LY_TYPE_IDENT:
     case LY_TYPE_UNKNOWN:
         /* store string */
-        ret += lyb_write_string(value_str, 0, 0, out, lybs);
+        ret += lyb_write_value_str(value_str, out, lybs);
         break;
     case LY_TYPE_BITS:
         /* find the correct structure */
@@ -911,43 +1148,30 @@ lyb_print_attributes(struct lyout *out, struct lyd_attr *attr, struct lyb_state
 static int
 lyb_print_schema_hash(struct lyout *out, struct lys_node *schema, struct hash_table **sibling_ht, struct lyb_state *lybs)
 {
-    int r, ret = 0;
+    int r, ret = 0, dynamic;
     void *mem;
     uint32_t i;
     LYB_HASH hash;
-    struct lys_node *first_sibling, *parent;
+    struct lys_node *parent;
 
-    /* create whole sibling HT if not already created and saved */
+    /* get the sibling HT if not already known */
     if (!*sibling_ht) {
-        /* get first schema data sibling (or input/output) */
+        /* get schema data parent (or input/output) */
         for (parent = lys_parent(schema);
              parent && (parent->nodetype & (LYS_USES | LYS_CASE | LYS_CHOICE));
              parent = lys_parent(parent));
 
-        first_sibling = (struct lys_node *)lys_getnext(NULL, parent, lys_node_module(schema), 0);
-        for (r = 0; r < lybs->sib_ht_count; ++r) {
-            if (lybs->sib_ht[r].first_sibling == first_sibling) {
-                /* we have already created a hash table for these siblings */
-                *sibling_ht = lybs->sib_ht[r].ht;
-                break;
-            }
-        }
-
+        *sibling_ht = lyb_sib_cache_get(lybs->ctx, parent, lys_node_module(schema), 0, lyb_hash_siblings, &dynamic);
         if (!*sibling_ht) {
-            /* we must create sibling hash table */
-            *sibling_ht = lyb_hash_siblings(first_sibling, NULL, 0);
-            if (!*sibling_ht) {
-                return -1;
-            }
+            return -1;
+        }
 
-            /* and save it */
-            ++lybs->sib_ht_count;
-            mem = realloc(lybs->sib_ht, lybs->sib_ht_count * sizeof *lybs->sib_ht);
-            LY_CHECK_ERR_RETURN(!mem, LOGMEM(lybs->ctx), -1);
+        if (dynamic) {
+            /* not cached in the context, free it after printing */
+            mem = realloc(lybs->sib_ht, (lybs->sib_ht_count + 1) * sizeof *lybs->sib_ht);
+            LY_CHECK_ERR_RETURN(!mem, LOGMEM(lybs->ctx); lyht_free(*sibling_ht), -1);
             lybs->sib_ht = mem;
-
-            lybs->sib_ht[lybs->sib_ht_count - 1].first_sibling = first_sibling;
-            lybs->sib_ht[lybs->sib_ht_count - 1].ht = *sibling_ht;
+            lybs->sib_ht[lybs->sib_ht_count++] = *sibling_ht;
         }
     }
 
@@ -1086,13 +1310,23 @@ lyb_print_data(struct lyout *out, const struct lyd_node *root, int options)
 
     memset(&lybs, 0, sizeof lybs);
 
+    if (options & LYP_STREAM) {
+        lybs.header |= LYB_HEADER_STREAM;
+        lybs.seg = malloc(LYB_STREAM_SEG_MAX);
+        LY_CHECK_ERR_RETURN(!lybs.seg, LOGMEM(root ? lyd_node_module(root)->ctx : NULL), EXIT_FAILURE);
+    }
+    if (options & LYP_STRTABLE) {
+        lybs.header |= LYB_HEADER_STRTABLE;
+    }
+
     if (root) {
         lybs.ctx = lyd_node_module(root)->ctx;
 
         for (parent = lys_parent(root->schema); parent && (parent->nodetype == LYS_USES); parent = lys_parent(parent));
         if (parent && (parent->nodetype != LYS_EXT)) {
             LOGERR(lybs.ctx, LY_EINVAL, "LYB printer supports only printing top-level nodes.");
-            return EXIT_FAILURE;
+            rc = EXIT_FAILURE;
+            goto finish;
         }
     }
 
@@ -1104,7 +1338,7 @@ lyb_print_data(struct lyout *out, const struct lyd_node *root, int options)
     }
 
     /* LYB header */
-    ret += (r = lyb_print_header(out));
+    ret += (r = lyb_print_header(out, &lybs));
     if (r < 0) {
         rc = EXIT_FAILURE;
         goto finish;
@@ -1117,6 +1351,15 @@ lyb_print_data(struct lyout *out, const struct lyd_node *root, int options)
         goto finish;
     }
 
+    if (lybs.header & LYB_HEADER_STRTABLE) {
+        /* string table */
+        ret += (r = lyb_print_str_table(out, root, options, &lybs));
+        if (r < 0) {
+            rc = EXIT_FAILURE;
+            goto finish;
+        }
+    }
+
     LY_TREE_FOR(root, root) {
         /* do not reuse sibling hash tables from different modules */
         if (lyd_node_module(root) != prev_mod) {
@@ -1145,8 +1388,11 @@ finish:
     free(lybs.written);
     free(lybs.position);
     free(lybs.inner_chunks);
+    free(lybs.seg);
+    lyht_free(lybs.str_ht);
+    free(lybs.strs);
     for (r = 0; r < lybs.sib_ht_count; ++r) {
-        lyht_free(lybs.sib_ht[r].ht);
+        lyht_free(lybs.sib_ht[r]);
     }
     free(lybs.sib_ht);
 
@@ -1239,16 +1239,16 @@ resolve_json_data_node_hash(struct lyd_node *parent, struct parsed_pred pp)
     prev_cb = lyht_set_cb(parent->ht, resolve_hash_table_find_equal);
 
     /* get the hash of the searched node */
-    hash = dict_hash_multi(0, lys_node_module(pp.schema)->name, strlen(lys_node_module(pp.schema)->name));
-    hash = dict_hash_multi(hash, pp.schema->name, strlen(pp.schema->name));
+    hash = lydict_hash_multi(0, lys_node_module(pp.schema)->name);
+    hash = lydict_hash_multi(hash, pp.schema->name);
     if (pp.schema->nodetype == LYS_LEAFLIST) {
         assert((pp.len == 1) && (pp.pred[0].name[0] == '.') && (pp.pred[0].nam_len == 1));
-        /* leaf-list value in predicate */
-        hash = dict_hash_multi(hash, pp.pred[0].value, pp.pred[0].val_len);
+        /* leaf-list value in predicate, not in the dictionary */
+        hash = dict_hash_multi_str(hash, pp.pred[0].value, pp.pred[0].val_len);
     } else if (pp.schema->nodetype == LYS_LIST) {
         /* list keys in predicates */
         for (i = 0; i < pp.len; ++i) {
-            hash = dict_hash_multi(hash, pp.pred[i].value, pp.pred[i].val_len);
+            hash = dict_hash_multi_str(hash, pp.pred[i].value, pp.pred[i].val_len);
         }
     }
     hash = dict_hash_multi(hash, NULL, 0);
@@ -2347,8 +2347,8 @@ resolve_json_nodeid(const char *nodeid, const struct ly_ctx *ctx, const struct l
 {
     char *str;
     const char *name, *mod_name, *id, *backup_mod_name = NULL, *yang_data_name = NULL;
-    const struct lys_node *sibling, *start_parent, *parent;
-    int r, nam_len, mod_name_len, is_relative = -1, has_predicate;
+    const struct lys_node *sibling, *start_parent, *parent, *indexed;
+    int r, nam_len, mod_name_len, is_relative = -1, has_predicate, use_index;
     int yang_data_name_len, backup_mod_name_len;
     /* resolved import module from the start module, it must match the next node-name-match sibling */
     const struct lys_module *prefix_mod, *module, *prev_mod;
@@ -2434,8 +2434,13 @@ resolve_json_nodeid(const char *nodeid, const struct ly_ctx *ctx, const struct l
     prev_mod = module;
 
     while (1) {
+        /* the schema index gives the only sibling that can match, otherwise iterate them all */
+        prefix_mod = mod_name ? ly_ctx_nget_module(ctx, mod_name, mod_name_len, NULL, 1) : prev_mod;
+        use_index = prefix_mod && !lys_child_find(start_parent, module, lys_main_module(prefix_mod)->ns, name, nam_len, 0,
+                                                  &indexed);
+
         sibling = NULL;
-        while ((sibling = lys_getnext(sibling, start_parent, module, 0))) {
+        while ((sibling = use_index ? (sibling ? NULL : indexed) : lys_getnext(sibling, start_parent, module, 0))) {
             /* name match */
             if (sibling->name && !strncmp(name, sibling->name, nam_len) && !sibling->name[nam_len]) {
                 /* output check */
@@ -6703,6 +6708,106 @@ check_augment:
     return 0;
 }
 
+/**
+ * @brief Result of a when condition of a uses, choice, case, or augment shared by all its data nodes
+ * with the same context node.
+ */
+struct resolve_when_memo_rec {
+    const struct lys_when *when;
+    const struct lyd_node *ctx_node;
+    enum lyxp_node_type ctx_node_type;
+    int result;
+};
+
+static int
+resolve_when_memo_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct resolve_when_memo_rec *rec1 = val1_p, *rec2 = val2_p;
+
+    return (rec1->when == rec2->when) && (rec1->ctx_node == rec2->ctx_node)
+            && (rec1->ctx_node_type == rec2->ctx_node_type);
+}
+
+static uint32_t
+resolve_when_memo_hash(const struct resolve_when_memo_rec *rec)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, (const char *)&rec->when, sizeof rec->when);
+    hash = dict_hash_multi(hash, (const char *)&rec->ctx_node, sizeof rec->ctx_node);
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+/**
+ * @brief Evaluate the when condition of a uses, choice, case, or augment affecting a data node.
+ *
+ * All the data nodes defined by \p snode are hidden during the evaluation, so the result is the same
+ * for all of them with the same context node and it is evaluated only once per \p memo.
+ *
+ * @param[in] snode Uses, choice, case, or augment with the when condition.
+ * @param[in] node Data node affected by the condition.
+ * @param[in,out] ctx_node Context node of the condition, may be moved if it was hidden.
+ * @param[in] ctx_node_type Type of \p ctx_node.
+ * @param[in] memo Results of the conditions evaluated before, NULL to always evaluate.
+ * @param[out] result Boolean result of the condition.
+ * @return 0 on success, 1 if the nodes needed are conditional and not yet resolved, -1 on error.
+ */
+static int
+resolve_when_snode(struct lys_node *snode, struct lyd_node *node, struct lyd_node **ctx_node,
+                   enum lyxp_node_type ctx_node_type, struct hash_table *memo, int *result)
+{
+    struct resolve_when_memo_rec rec, *match;
+    struct lyd_node *unlinked_nodes = NULL, *tmp_node;
+    struct lyxp_set set;
+    uint32_t hash = 0;
+    int rc;
+
+    if (memo) {
+        rec.when = snode_get_when(snode);
+        rec.ctx_node = *ctx_node;
+        rec.ctx_node_type = ctx_node_type;
+        hash = resolve_when_memo_hash(&rec);
+        if (!lyht_find(memo, &rec, hash, (void **)&match)) {
+            *result = match->result;
+            return 0;
+        }
+    }
+
+    memset(&set, 0, sizeof set);
+
+    /* we do not want our node pointer to change */
+    tmp_node = node;
+    if (resolve_when_unlink_nodes(snode, &tmp_node, ctx_node, ctx_node_type, &unlinked_nodes)) {
+        return -1;
+    }
+
+    rc = lyxp_eval(snode_get_when(snode)->cond, *ctx_node, ctx_node_type, lys_node_module(snode), &set, LYXP_WHEN);
+
+    /* reconnect nodes, if ctx_node is NULL then all the nodes were unlinked, but linked together,
+     * so the tree did not actually change and there is nothing for us to do
+     */
+    if (unlinked_nodes && *ctx_node && resolve_when_relink_nodes(*ctx_node, unlinked_nodes, ctx_node_type)) {
+        rc = -1;
+    }
+
+    if (!rc) {
+        lyxp_set_cast(&set, LYXP_SET_BOOLEAN, *ctx_node, lys_node_module(snode), LYXP_WHEN);
+        *result = set.val.bool;
+
+        if (memo) {
+            rec.result = *result;
+            if (lyht_insert(memo, &rec, hash, NULL) == -1) {
+                LOGMEM(snode->module->ctx);
+                rc = -1;
+            }
+        }
+    }
+
+    /* free xpath set content */
+    lyxp_set_cast(&set, LYXP_SET_EMPTY, *ctx_node ? *ctx_node : node, NULL, 0);
+    return rc;
+}
+
 /**
  * @brief Resolve (check) all when conditions relevant for \p node.
  * Logs directly.
@@ -6710,6 +6815,8 @@ check_augment:
  * @param[in] node Data node, whose conditional reference, if such, is being decided.
  * @param[in] ignore_fail 1 if when does not have to be satisfied, 2 if it does not have to be satisfied
  * only when requiring external dependencies.
+ * @param[in] memo Results of the when conditions of uses, choices, cases, and augments shared by all their
+ * data nodes, see resolve_unres_data(). NULL to always evaluate them.
  *
  * @return
  *  -1 - error, ly_errno is set
@@ -6718,14 +6825,14 @@ check_augment:
  *   1, ly_vecode = LYVE_INWHEN - nodes needed to resolve are conditional and not yet resolved (under another "when")
  */
 int
-resolve_when(struct lyd_node *node, int ignore_fail, struct lys_when **failed_when)
+resolve_when(struct lyd_node *node, int ignore_fail, struct lys_when **failed_when, struct hash_table *memo)
 {
-    struct lyd_node *ctx_node = NULL, *unlinked_nodes, *tmp_node;
+    struct lyd_node *ctx_node = NULL;
     struct lys_node *sparent;
     struct lyxp_set set;
     enum lyxp_node_type ctx_node_type;
     struct ly_ctx *ctx = node->schema->module->ctx;
-    int rc = 0;
+    int rc = 0, result;
 
     assert(node);
     memset(&set, 0, sizeof set);
@@ -6777,24 +6884,7 @@ resolve_when(struct lyd_node *node, int ignore_fail, struct lys_when **failed_wh
                 }
             }
 
-            unlinked_nodes = NULL;
-            /* we do not want our node pointer to change */
-            tmp_node = node;
-            rc = resolve_when_unlink_nodes(sparent, &tmp_node, &ctx_node, ctx_node_type, &unlinked_nodes);
-            if (rc) {
-                goto cleanup;
-            }
-
-            rc = lyxp_eval(snode_get_when(sparent)->cond, ctx_node, ctx_node_type, lys_node_module(sparent),
-                           &set, LYXP_WHEN);
-
-            if (unlinked_nodes && ctx_node) {
-                if (resolve_when_relink_nodes(ctx_node, unlinked_nodes, ctx_node_type)) {
-                    rc = -1;
-                    goto cleanup;
-                }
-            }
-
+            rc = resolve_when_snode(sparent, node, &ctx_node, ctx_node_type, memo, &result);
             if (rc) {
                 if (rc == 1) {
                     LOGVAL(ctx, LYE_INWHEN, LY_VLOG_LYD, node, snode_get_when(sparent)->cond);
@@ -6802,8 +6892,7 @@ resolve_when(struct lyd_node *node, int ignore_fail, struct lys_when **failed_wh
                 goto cleanup;
             }
 
-            lyxp_set_cast(&set, LYXP_SET_BOOLEAN, ctx_node, lys_node_module(sparent), LYXP_WHEN);
-            if (!set.val.bool) {
+            if (!result) {
                 if ((ignore_fail == 1) || ((snode_get_when(sparent)->flags & (LYS_XPCONF_DEP | LYS_XPSTATE_DEP))
                         && (ignore_fail == 2))) {
                     LOGVRB("When condition \"%s\" is not satisfied, but it is not required.", snode_get_when(sparent)->cond);
@@ -6816,9 +6905,6 @@ resolve_when(struct lyd_node *node, int ignore_fail, struct lys_when **failed_wh
                     goto cleanup;
                 }
             }
-
-            /* free xpath set content */
-            lyxp_set_cast(&set, LYXP_SET_EMPTY, ctx_node, lys_node_module(sparent), 0);
         }
 
 check_augment:
@@ -6831,26 +6917,7 @@ check_augment:
                 }
             }
 
-            unlinked_nodes = NULL;
-            tmp_node = node;
-            rc = resolve_when_unlink_nodes(sparent->parent, &tmp_node, &ctx_node, ctx_node_type, &unlinked_nodes);
-            if (rc) {
-                goto cleanup;
-            }
-
-            rc = lyxp_eval(snode_get_when(sparent->parent)->cond, ctx_node, ctx_node_type,
-                           lys_node_module(sparent->parent), &set, LYXP_WHEN);
-
-            /* reconnect nodes, if ctx_node is NULL then all the nodes were unlinked, but linked together,
-             * so the tree did not actually change and there is nothing for us to do
-             */
-            if (unlinked_nodes && ctx_node) {
-                if (resolve_when_relink_nodes(ctx_node, unlinked_nodes, ctx_node_type)) {
-                    rc = -1;
-                    goto cleanup;
-                }
-            }
-
+            rc = resolve_when_snode(sparent->parent, node, &ctx_node, ctx_node_type, memo, &result);
             if (rc) {
                 if (rc == 1) {
                     LOGVAL(ctx, LYE_INWHEN, LY_VLOG_LYD, node, snode_get_when(sparent->parent)->cond);
@@ -6858,8 +6925,7 @@ check_augment:
                 goto cleanup;
             }
 
-            lyxp_set_cast(&set, LYXP_SET_BOOLEAN, ctx_node, lys_node_module(sparent->parent), LYXP_WHEN);
-            if (!set.val.bool) {
+            if (!result) {
                 node->when_status |= LYD_WHEN_FALSE;
                 if ((ignore_fail == 1) || ((snode_get_when(sparent->parent)->flags & (LYS_XPCONF_DEP | LYS_XPSTATE_DEP))
                         && (ignore_fail == 2))) {
@@ -6873,9 +6939,6 @@ check_augment:
                     goto cleanup;
                 }
             }
-
-            /* free xpath set content */
-            lyxp_set_cast(&set, LYXP_SET_EMPTY, ctx_node, lys_node_module(sparent->parent), 0);
         }
 
         sparent = lys_parent(sparent);
@@ -6885,7 +6948,7 @@ check_augment:
 
 cleanup:
     /* free xpath set content */
-    lyxp_set_cast(&set, LYXP_SET_EMPTY, ctx_node ? ctx_node : node, NULL, 0);
+    lyxp_set_cast(&set, LYXP_SET_EMPTY, node, NULL, 0);
     return rc;
 }
 
@@ -8056,7 +8119,7 @@ resolve_union(struct lyd_node_leaf_list *leaf, struct lys_type *type, int store,
     struct lys_type *t;
     struct lyd_node *ret;
     enum int_log_opts prev_ilo;
-    int found, success = 0, ext_dep, req_inst;
+    int found, success = 0, ext_dep, req_inst, first, idx;
     const char *json_val = NULL;
 
     assert(type->base == LY_TYPE_UNION);
@@ -8075,10 +8138,16 @@ resolve_union(struct lyd_node_leaf_list *leaf, struct lys_type *type, int store,
     /* turn logging off, we are going to try to validate the value with all the types in order */
     ly_ilo_change(NULL, ILO_IGNORE, &prev_ilo, 0);
 
+    /* skip the members whose patterns do not match */
+    first = lyp_multi_pattern_union(ctx, type, leaf->value_str);
+
     t = NULL;
     found = 0;
-    while ((t = lyp_get_next_union_type(type, t, &found))) {
+    for (idx = 0; (t = lyp_get_next_union_type(type, t, &found)); ++idx) {
         found = 0;
+        if ((first == -1) || (idx < first)) {
+            continue;
+        }
 
         switch (t->base) {
         case LY_TYPE_LEAFREF:
@@ -8145,7 +8214,8 @@ resolve_union(struct lyd_node_leaf_list *leaf, struct lys_type *type, int store,
             }
             break;
         default:
-            if (lyp_parse_value(t, &leaf->value_str, NULL, leaf, NULL, NULL, store, 0, 0)) {
+            if (lyp_parse_value(t, &leaf->value_str, NULL, leaf, NULL, NULL, store, 0,
+                                ((idx == first) && (t->base == LY_TYPE_STRING)) ? 2 : 0)) {
                 success = 1;
             }
             break;
@@ -8196,11 +8266,13 @@ resolve_union(struct lyd_node_leaf_list *leaf, struct lys_type *type, int store,
  * @param[in] node Data node to resolve.
  * @param[in] type Type of the unresolved item.
  * @param[in] ignore_fail 0 - no, 1 - yes, 2 - yes, but only for external dependencies.
+ * @param[in] when_memo Shared results of when conditions, see resolve_when().
  *
  * @return EXIT_SUCCESS on success, EXIT_FAILURE on forward reference, -1 on error.
  */
 int
-resolve_unres_data_item(struct lyd_node *node, enum UNRES_ITEM type, int ignore_fail, struct lys_when **failed_when)
+resolve_unres_data_item(struct lyd_node *node, enum UNRES_ITEM type, int ignore_fail, struct lys_when **failed_when,
+                        struct hash_table *when_memo)
 {
     int rc, req_inst, ext_dep;
     struct lyd_node_leaf_list *leaf;
@@ -8288,7 +8360,7 @@ resolve_unres_data_item(struct lyd_node *node, enum UNRES_ITEM type, int ignore_
         return resolve_union(leaf, &sleaf->type, 1, ignore_fail, NULL);
 
     case UNRES_WHEN:
-        if ((rc = resolve_when(node, ignore_fail, failed_when))) {
+        if ((rc = resolve_when(node, ignore_fail, failed_when, when_memo))) {
             return rc;
         }
         break;
@@ -8450,8 +8522,11 @@ resolve_unres_data(struct ly_ctx *ctx, struct unres_data *unres, struct lyd_node
     }
 
     /*
-     * when-stmt first
+     * when-stmt first, the tree is not changed until all of them are resolved, so the results
+     * of the conditions shared by several data nodes are evaluated only once
      */
+    unres->when_memo = lyht_new(8, sizeof(struct resolve_when_memo_rec), resolve_when_memo_equal, NULL, 1);
+    LY_CHECK_ERR_GOTO(!unres->when_memo, LOGMEM(ctx), error);
     first = 1;
     stmt_count = 0;
     resolved = 0;
@@ -8489,7 +8564,7 @@ resolve_unres_data(struct ly_ctx *ctx, struct unres_data *unres, struct lyd_node
             }
 
             prev_when_status = unres->node[i]->when_status;
-            rc = resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, &when);
+            rc = resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, &when, unres->when_memo);
             if (!rc) {
                 /* finish with error/delete the node only if when was changed from true to false, an external
                  * dependency was not required, or it was not provided (the flag would not be passed down otherwise,
@@ -8559,6 +8634,8 @@ resolve_unres_data(struct ly_ctx *ctx, struct unres_data *unres, struct lyd_node
         }
         first = 0;
     } while (progress && resolved < stmt_count);
+    lyht_free(unres->when_memo);
+    unres->when_memo = NULL;
 
     /* do we have some unresolved when-stmt? */
     if (stmt_count > resolved) {
@@ -8611,7 +8688,7 @@ resolve_unres_data(struct ly_ctx *ctx, struct unres_data *unres, struct lyd_node
                 stmt_count++;
             }
 
-            rc = resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, NULL);
+            rc = resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, NULL, NULL);
             if (!rc) {
                 unres->type[i] = UNRES_RESOLVED;
                 if (!ignore_fail) {
@@ -8646,7 +8723,7 @@ resolve_unres_data(struct ly_ctx *ctx, struct unres_data *unres, struct lyd_node
         }
         assert(!(options & LYD_OPT_TRUSTED) || ((unres->type[i] != UNRES_MUST) && (unres->type[i] != UNRES_MUST_INOUT)));
 
-        rc = resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, NULL);
+        rc = resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, NULL, NULL);
         if (rc) {
             /* since when was already resolved, a forward reference is an error */
             return -1;
@@ -8660,6 +8737,8 @@ resolve_unres_data(struct ly_ctx *ctx, struct unres_data *unres, struct lyd_node
     return EXIT_SUCCESS;
 
 error:
+    lyht_free(unres->when_memo);
+    unres->when_memo = NULL;
     if (!ignore_fail) {
         /* print all the new errors */
         ly_ilo_restore(ctx, prev_ilo, prev_eitem, 1);
@@ -98,6 +98,9 @@ struct unres_data {
     struct lyd_difflist *diff;
     unsigned int diff_size;
     unsigned int diff_idx;
+
+    struct hash_table *when_memo;  /* results of the when conditions shared by sibling data nodes,
+                                      valid only during a single resolve_unres_data() */
 };
 
 /**
@@ -214,7 +217,7 @@ struct lys_ident *resolve_identref(struct lys_type *type, const char *ident_name
 
 int resolve_unres_schema(struct lys_module *mod, struct unres_schema *unres);
 
-int resolve_when(struct lyd_node *node, int ignore_fail, struct lys_when **failed_when);
+int resolve_when(struct lyd_node *node, int ignore_fail, struct lys_when **failed_when, struct hash_table *memo);
 
 int unres_schema_add_str(struct lys_module *mod, struct unres_schema *unres, void *item, enum UNRES_ITEM type,
                          const char *str);
@@ -236,7 +239,8 @@ void unres_schema_free(struct lys_module *module, struct unres_schema **unres, i
 int resolve_union(struct lyd_node_leaf_list *leaf, struct lys_type *type, int store, int ignore_fail,
                   struct lys_type **resolved_type);
 
-int resolve_unres_data_item(struct lyd_node *dnode, enum UNRES_ITEM type, int ignore_fail, struct lys_when **failed_when);
+int resolve_unres_data_item(struct lyd_node *dnode, enum UNRES_ITEM type, int ignore_fail, struct lys_when **failed_when,
+                            struct hash_table *when_memo);
 
 int unres_data_addonly(struct unres_data *unres, struct lyd_node *node, enum UNRES_ITEM type);
 int unres_data_add(struct unres_data *unres, struct lyd_node *node, enum UNRES_ITEM type);
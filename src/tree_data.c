@@ -26,6 +26,7 @@
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
+#include <sched.h>
 
 #include "libyang.h"
 #include "common.h"
@@ -351,17 +352,16 @@ lyd_hash(struct lyd_node *node)
     int i;
 
     if ((node->schema->nodetype != LYS_LIST) || lyd_list_has_keys(node)) {
-        node->hash = dict_hash_multi(0, lyd_node_module(node)->name, strlen(lyd_node_module(node)->name));
-        node->hash = dict_hash_multi(node->hash, node->schema->name, strlen(node->schema->name));
+        /* all the strings are in the dictionary, use their hashes */
+        node->hash = lydict_hash_multi(0, lyd_node_module(node)->name);
+        node->hash = lydict_hash_multi(node->hash, node->schema->name);
         if (node->schema->nodetype == LYS_LEAFLIST) {
-            node->hash = dict_hash_multi(node->hash, ((struct lyd_node_leaf_list *)node)->value_str,
-                                        strlen(((struct lyd_node_leaf_list *)node)->value_str));
+            node->hash = lydict_hash_multi(node->hash, ((struct lyd_node_leaf_list *)node)->value_str);
         } else if (node->schema->nodetype == LYS_LIST) {
             if (((struct lys_node_list *)node->schema)->keys_size) {
                 for (i = 0, iter = node->child; i < ((struct lys_node_list *)node->schema)->keys_size; ++i, iter = iter->next) {
                     assert(iter);
-                    node->hash = dict_hash_multi(node->hash, ((struct lyd_node_leaf_list *)iter)->value_str,
-                                                 strlen(((struct lyd_node_leaf_list *)iter)->value_str));
+                    node->hash = lydict_hash_multi(node->hash, ((struct lyd_node_leaf_list *)iter)->value_str);
                 }
             } else {
                 /* no-keys list */
@@ -434,7 +434,8 @@ _lyd_insert_hash(struct lyd_node *node, int keyless_list_check)
                 assert(i <= LY_CACHE_HT_MIN_CHILDREN);
                 if (i == LY_CACHE_HT_MIN_CHILDREN) {
                     /* create hash table, insert all the children */
-                    node->parent->ht = lyht_new(1, sizeof(struct lyd_node *), lyd_hash_table_val_equal, NULL, 1);
+                    node->parent->ht = lyht_new(LY_CACHE_HT_INIT_SIZE, sizeof(struct lyd_node *), lyd_hash_table_val_equal,
+                                                NULL, 1);
                     LY_TREE_FOR(node->parent->child, iter) {
                         if ((iter->schema->nodetype == LYS_LIST) && !lyd_list_has_keys(iter)) {
                             /* skip lists without keys */
@@ -487,8 +488,8 @@ _lyd_unlink_hash(struct lyd_node *node, struct lyd_node *orig_parent, int keyles
                 assert(0);
             }
 
-            /* if no longer enough children, free the whole hash table */
-            if (orig_parent->ht->used < LY_CACHE_HT_MIN_CHILDREN) {
+            /* if too few children, free the whole hash table */
+            if (orig_parent->ht->used < LY_CACHE_HT_FREE_CHILDREN) {
                 lyht_free(orig_parent->ht);
                 orig_parent->ht = NULL;
             }
@@ -574,7 +575,7 @@ lyd_is_when_false(struct lyd_node *root, struct lyd_node *last_parent, struct ly
         }
         for (current = dummy; current; current = current->child) {
             ly_ilo_change(NULL, ILO_IGNORE, &prev_ilo, NULL);
-            resolve_when(current, 0, NULL);
+            resolve_when(current, 0, NULL, NULL);
             ly_ilo_restore(NULL, prev_ilo, NULL, 0);
 
             if (current->when_status & LYD_WHEN_FALSE) {
@@ -933,6 +934,7 @@ lyd_parse_(struct ly_ctx *ctx, const struct lyd_node *rpc_act, const char *data,
 {
     struct lyxml_elem *xml;
     struct lyd_node *result = NULL;
+    struct dict_batch batch;
     int xmlopt = LYXML_PARSE_MULTIROOT;
 
     if (!ctx || !data) {
@@ -944,6 +946,9 @@ lyd_parse_(struct ly_ctx *ctx, const struct lyd_node *rpc_act, const char *data,
         xmlopt = 0;
     }
 
+    /* the strings of the XML tree and of the invalid data are released together */
+    lydict_batch_start(ctx, &batch);
+
     /* we must free all the errors, otherwise we are unable to properly check returned ly_errno :-/ */
     ly_errno = LY_SUCCESS;
     switch (format) {
@@ -976,15 +981,14 @@ lyd_parse_(struct ly_ctx *ctx, const struct lyd_node *rpc_act, const char *data,
 
     if (ly_errno) {
         lyd_free_withsiblings(result);
-        return NULL;
-    }
-
-    if ((options & (LYD_OPT_RPC | LYD_OPT_RPCREPLY)) && lyd_schema_sort(result, 1)) {
+        result = NULL;
+    } else if ((options & (LYD_OPT_RPC | LYD_OPT_RPCREPLY)) && lyd_schema_sort(result, 1)) {
         /* rpc and rpc-reply must be sorted */
         lyd_free_withsiblings(result);
-        return NULL;
+        result = NULL;
     }
 
+    lydict_batch_end(ctx);
     return result;
 }
 
@@ -5290,6 +5294,16 @@ cleanup:
     return ret;
 }
 
+/* copy a dictionary string of the original data into ctx, the string is only referenced in the same context */
+static const char *
+lyd_dup_str(struct ly_ctx *ctx, struct ly_ctx *orig_ctx, const char *str)
+{
+    if (ctx == orig_ctx) {
+        return lydict_ref(ctx, str);
+    }
+    return lydict_insert(ctx, str, 0);
+}
+
 /* create an attribute copy */
 static struct lyd_attr *
 lyd_dup_attr(struct ly_ctx *ctx, struct lyd_node *parent, struct lyd_attr *attr)
@@ -5311,8 +5325,8 @@ lyd_dup_attr(struct ly_ctx *ctx, struct lyd_node *parent, struct lyd_attr *attr)
     ret->parent = parent;
     ret->next = NULL;
     ret->annotation = attr->annotation;
-    ret->name = lydict_insert(ctx, attr->name, 0);
-    ret->value_str = lydict_insert(ctx, attr->value_str, 0);
+    ret->name = lyd_dup_str(ctx, attr->parent->schema->module->ctx, attr->name);
+    ret->value_str = lyd_dup_str(ctx, attr->parent->schema->module->ctx, attr->value_str);
     ret->value_type = attr->value_type;
     ret->value_flags = attr->value_flags;
     switch (ret->value_type) {
@@ -5331,7 +5345,7 @@ lyd_dup_attr(struct ly_ctx *ctx, struct lyd_node *parent, struct lyd_attr *attr)
     case LY_TYPE_UNION:
         /* unresolved union (this must be non-validated tree), duplicate the stored string (duplicated
          * because of possible change of the value in case of instance-identifier) */
-        ret->value.string = lydict_insert(ctx, attr->value.string, 0);
+        ret->value.string = lyd_dup_str(ctx, attr->parent->schema->module->ctx, attr->value.string);
         break;
     case LY_TYPE_ENUM:
     case LY_TYPE_IDENT:
@@ -5470,7 +5484,7 @@ _lyd_dup_node(const struct lyd_node *node, const struct lys_node *schema, struct
         LY_CHECK_ERR_GOTO(!new_node, LOGMEM(ctx), error);
         new_node->schema = (struct lys_node *)schema;
 
-        new_leaf->value_str = lydict_insert(ctx, ((struct lyd_node_leaf_list *)node)->value_str, 0);
+        new_leaf->value_str = lyd_dup_str(ctx, node->schema->module->ctx, ((struct lyd_node_leaf_list *)node)->value_str);
         new_leaf->value_type = ((struct lyd_node_leaf_list *)node)->value_type;
         new_leaf->value_flags = ((struct lyd_node_leaf_list *)node)->value_flags;
         if (_lyd_dup_node_common(new_node, node, ctx, options)) {
@@ -5495,7 +5509,8 @@ _lyd_dup_node(const struct lyd_node *node, const struct lys_node *schema, struct
         case LY_TYPE_UNION:
             /* unresolved union (this must be non-validated tree), duplicate the stored string (duplicated
              * because of possible change of the value in case of instance-identifier) */
-            new_leaf->value.string = lydict_insert(ctx, ((struct lyd_node_leaf_list *)node)->value.string, 0);
+            new_leaf->value.string = lyd_dup_str(ctx, node->schema->module->ctx,
+                                                 ((struct lyd_node_leaf_list *)node)->value.string);
             break;
         case LY_TYPE_ENUM:
         case LY_TYPE_IDENT:
@@ -5551,7 +5566,7 @@ _lyd_dup_node(const struct lyd_node *node, const struct lys_node *schema, struct
         case LYD_ANYDATA_CONSTSTRING:
         case LYD_ANYDATA_SXML:
         case LYD_ANYDATA_JSON:
-            new_any->value.str = lydict_insert(ctx, old_any->value.str, 0);
+            new_any->value.str = lyd_dup_str(ctx, node->schema->module->ctx, old_any->value.str);
             break;
         case LYD_ANYDATA_DATATREE:
             new_any->value.tree = lyd_dup_withsiblings_to_ctx(old_any->value.tree, 1, ctx);
@@ -5641,11 +5656,9 @@ lyd_dup_keys(struct lyd_node *new_list, const struct lyd_node *old_list, struct
     return 0;
 }
 
-API struct lyd_node *
-lyd_dup_to_ctx(const struct lyd_node *node, int options, struct ly_ctx *ctx)
+static struct lyd_node *
+_lyd_dup_to_ctx(const struct lyd_node *node, int options, struct ly_ctx *ctx)
 {
-    FUN_IN;
-
     struct ly_ctx *log_ctx;
     struct lys_node *schema;
     const char *yang_data_name;
@@ -5653,11 +5666,6 @@ lyd_dup_to_ctx(const struct lyd_node *node, int options, struct ly_ctx *ctx)
     const struct lyd_node *next, *elem;
     struct lyd_node *ret, *parent, *new_node = NULL;
 
-    if (!node) {
-        LOGARG;
-        return NULL;
-    }
-
     /* fix options */
     if ((options & LYD_DUP_OPT_RECURSIVE) && (options & LYD_DUP_OPT_WITH_KEYS)) {
         options &= ~LYD_DUP_OPT_WITH_KEYS;
@@ -5806,6 +5814,29 @@ error:
     return NULL;
 }
 
+API struct lyd_node *
+lyd_dup_to_ctx(const struct lyd_node *node, int options, struct ly_ctx *ctx)
+{
+    FUN_IN;
+
+    struct ly_ctx *dict_ctx;
+    struct dict_batch batch;
+    struct lyd_node *ret;
+
+    if (!node) {
+        LOGARG;
+        return NULL;
+    }
+
+    /* change the references of all the copied strings at once */
+    dict_ctx = (ctx ? ctx : node->schema->module->ctx);
+    lydict_batch_start(dict_ctx, &batch);
+    ret = _lyd_dup_to_ctx(node, options, ctx);
+    lydict_batch_end(dict_ctx);
+
+    return ret;
+}
+
 API struct lyd_node *
 lyd_dup(const struct lyd_node *node, int options)
 {
@@ -5931,11 +5962,20 @@ lyd_dup_withsiblings(const struct lyd_node *node, int options)
 {
     FUN_IN;
 
+    struct ly_ctx *ctx;
+    struct dict_batch batch;
+    struct lyd_node *ret;
+
     if (!node) {
         return NULL;
     }
 
-    return lyd_dup_withsiblings_to_ctx(node, options, lyd_node_module(node)->ctx);
+    ctx = lyd_node_module(node)->ctx;
+    lydict_batch_start(ctx, &batch);
+    ret = lyd_dup_withsiblings_to_ctx(node, options, ctx);
+    lydict_batch_end(ctx);
+
+    return ret;
 }
 
 API void
@@ -5977,11 +6017,11 @@ lyd_free_attr(struct ly_ctx *ctx, struct lyd_node *parent, struct lyd_attr *attr
         attr = iter;
         iter = iter->next;
 
-        lydict_remove(ctx, attr->name);
+        lydict_unref(ctx, attr->name);
         type = lys_ext_complex_get_substmt(LY_STMT_TYPE, attr->annotation, NULL);
         assert(type);
         lyd_free_value(attr->value, attr->value_type, attr->value_flags, *type, attr->value_str, NULL, NULL, NULL);
-        lydict_remove(ctx, attr->value_str);
+        lydict_unref(ctx, attr->value_str);
         free(attr);
     }
 }
@@ -6153,7 +6193,7 @@ _lyd_free_node(struct lyd_node *node)
         case LYD_ANYDATA_CONSTSTRING:
         case LYD_ANYDATA_SXML:
         case LYD_ANYDATA_JSON:
-            lydict_remove(node->schema->module->ctx, ((struct lyd_node_anydata *)node)->value.str);
+            lydict_unref(node->schema->module->ctx, ((struct lyd_node_anydata *)node)->value.str);
             break;
         case LYD_ANYDATA_DATATREE:
             lyd_free_withsiblings(((struct lyd_node_anydata *)node)->value.tree);
@@ -6178,7 +6218,7 @@ _lyd_free_node(struct lyd_node *node)
         leaf = (struct lyd_node_leaf_list *)node;
         lyd_free_value(leaf->value, leaf->value_type, leaf->value_flags, &((struct lys_node_leaf *)leaf->schema)->type,
                        leaf->value_str, NULL, NULL, NULL);
-        lydict_remove(leaf->schema->module->ctx, leaf->value_str);
+        lydict_unref(leaf->schema->module->ctx, leaf->value_str);
         break;
     default:
         assert(0);
@@ -6215,7 +6255,22 @@ lyd_free(struct lyd_node *node)
 {
     FUN_IN;
 
+    struct ly_ctx *ctx;
+    struct dict_batch batch;
+
+    if (!node) {
+        return;
+    } else if (node->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA)) {
+        /* just a few strings, not worth batching */
+        lyd_free_internal_r(node, 1);
+        return;
+    }
+
+    /* release all the strings of the subtree with a single dictionary lock */
+    ctx = node->schema->module->ctx;
+    lydict_batch_start(ctx, &batch);
     lyd_free_internal_r(node, 1);
+    lydict_batch_end(ctx);
 }
 
 static void
@@ -6237,11 +6292,16 @@ lyd_free_withsiblings(struct lyd_node *node)
     FUN_IN;
 
     struct lyd_node *iter, *aux;
+    struct ly_ctx *ctx;
+    struct dict_batch batch;
 
     if (!node) {
         return;
     }
 
+    ctx = node->schema->module->ctx;
+    lydict_batch_start(ctx, &batch);
+
     if (node->parent) {
         /* optimization - avoid freeing (unlinking) the last node of the siblings list */
         /* so, first, free the node's predecessors to the beginning of the list ... */
@@ -6263,6 +6323,220 @@ lyd_free_withsiblings(struct lyd_node *node)
         /* free it all */
         lyd_free_withsiblings_r(node);
     }
+
+    lydict_batch_end(ctx);
+}
+
+API struct lyd_rcu *
+lyd_rcu_new(struct lyd_node *root)
+{
+    FUN_IN;
+
+    struct lyd_rcu *rcu;
+
+    if (root && root->parent) {
+        LOGARG;
+        return NULL;
+    }
+
+    if (root) {
+        while (root->prev->next) {
+            root = root->prev;
+        }
+    }
+
+    rcu = calloc(1, sizeof *rcu);
+    LY_CHECK_ERR_RETURN(!rcu, LOGMEM(root ? root->schema->module->ctx : NULL), NULL);
+    rcu->retired = ly_set_new();
+    rcu->draining = ly_set_new();
+    if (!rcu->retired || !rcu->draining) {
+        LOGMEM(root ? root->schema->module->ctx : NULL);
+        ly_set_free(rcu->retired);
+        ly_set_free(rcu->draining);
+        free(rcu);
+        return NULL;
+    }
+    pthread_mutex_init(&rcu->lock, NULL);
+    rcu->root = root;
+
+    return rcu;
+}
+
+API const struct lyd_node *
+lyd_rcu_read_lock(struct lyd_rcu *rcu, int *ticket)
+{
+    FUN_IN;
+
+    uint32_t epoch;
+
+    if (!rcu || !ticket) {
+        LOGARG;
+        return NULL;
+    }
+
+    /* register in the current epoch, retry if it ended meanwhile */
+    do {
+        epoch = __atomic_load_n(&rcu->epoch, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&rcu->readers[epoch % 2], 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&rcu->epoch, __ATOMIC_SEQ_CST) == epoch) {
+            break;
+        }
+        __atomic_sub_fetch(&rcu->readers[epoch % 2], 1, __ATOMIC_SEQ_CST);
+    } while (1);
+
+    *ticket = epoch % 2;
+    return __atomic_load_n(&rcu->root, __ATOMIC_SEQ_CST);
+}
+
+API void
+lyd_rcu_read_unlock(struct lyd_rcu *rcu, int ticket)
+{
+    FUN_IN;
+
+    if (!rcu || ((ticket != 0) && (ticket != 1))) {
+        LOGARG;
+        return;
+    }
+
+    __atomic_sub_fetch(&rcu->readers[ticket], 1, __ATOMIC_SEQ_CST);
+}
+
+API int
+lyd_rcu_dup(struct lyd_rcu *rcu, struct lyd_node **root)
+{
+    FUN_IN;
+
+    const struct lyd_node *cur;
+    int ticket;
+
+    if (!rcu || !root) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    cur = lyd_rcu_read_lock(rcu, &ticket);
+    *root = NULL;
+    if (cur) {
+        *root = lyd_dup_withsiblings(cur, LYD_DUP_OPT_RECURSIVE);
+    }
+    lyd_rcu_read_unlock(rcu, ticket);
+
+    return (cur && !*root) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/*
+ * Free the replaced versions that no reader can be using anymore, rcu->lock must be held.
+ *
+ * A version replaced during an epoch can be read only by the readers of this epoch (and of the previous ones,
+ * but they must have finished before this epoch started). So the next epoch is started and once the readers
+ * of the previous one finish, the version can be freed. Only then can another epoch be started.
+ */
+static void
+lyd_rcu_reclaim(struct lyd_rcu *rcu, int wait)
+{
+    struct ly_set *set;
+    uint32_t epoch;
+    unsigned int i;
+
+    while (1) {
+        if (rcu->draining->number) {
+            epoch = __atomic_load_n(&rcu->epoch, __ATOMIC_SEQ_CST);
+            while (__atomic_load_n(&rcu->readers[(epoch - 1) % 2], __ATOMIC_SEQ_CST)) {
+                if (!wait) {
+                    return;
+                }
+                sched_yield();
+            }
+
+            for (i = 0; i < rcu->draining->number; ++i) {
+                lyd_free_withsiblings(rcu->draining->set.d[i]);
+            }
+            ly_set_clean(rcu->draining);
+        }
+
+        if (!rcu->retired->number) {
+            return;
+        }
+
+        /* start a new epoch */
+        set = rcu->draining;
+        rcu->draining = rcu->retired;
+        rcu->retired = set;
+        __atomic_add_fetch(&rcu->epoch, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+API int
+lyd_rcu_publish(struct lyd_rcu *rcu, struct lyd_node *root)
+{
+    FUN_IN;
+
+    struct lyd_node *old;
+
+    if (!rcu || (root && root->parent)) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    if (root) {
+        while (root->prev->next) {
+            root = root->prev;
+        }
+    }
+
+    pthread_mutex_lock(&rcu->lock);
+
+    /* only the writers change the root */
+    old = rcu->root;
+    if (old && (ly_set_add(rcu->retired, old, LY_SET_OPT_USEASLIST) == -1)) {
+        pthread_mutex_unlock(&rcu->lock);
+        return EXIT_FAILURE;
+    }
+    __atomic_store_n(&rcu->root, root, __ATOMIC_SEQ_CST);
+
+    lyd_rcu_reclaim(rcu, 0);
+
+    pthread_mutex_unlock(&rcu->lock);
+    return EXIT_SUCCESS;
+}
+
+API void
+lyd_rcu_synchronize(struct lyd_rcu *rcu)
+{
+    FUN_IN;
+
+    if (!rcu) {
+        return;
+    }
+
+    pthread_mutex_lock(&rcu->lock);
+    lyd_rcu_reclaim(rcu, 1);
+    pthread_mutex_unlock(&rcu->lock);
+}
+
+API void
+lyd_rcu_free(struct lyd_rcu *rcu)
+{
+    FUN_IN;
+
+    unsigned int i;
+
+    if (!rcu) {
+        return;
+    }
+
+    for (i = 0; i < rcu->draining->number; ++i) {
+        lyd_free_withsiblings(rcu->draining->set.d[i]);
+    }
+    for (i = 0; i < rcu->retired->number; ++i) {
+        lyd_free_withsiblings(rcu->retired->set.d[i]);
+    }
+    lyd_free_withsiblings(rcu->root);
+
+    ly_set_free(rcu->draining);
+    ly_set_free(rcu->retired);
+    pthread_mutex_destroy(&rcu->lock);
+    free(rcu);
 }
 
 /**
@@ -6446,36 +6720,57 @@ lyd_build_relative_data_path(const struct lys_module *module, const struct lyd_n
     return len;
 }
 
-API struct ly_set *
-lyd_find_path(const struct lyd_node *ctx_node, const char *path)
+/**
+ * @brief Transform a data path in JSON format into YANG XPath.
+ *
+ * @param[in] ctx_node Path context node.
+ * @param[in] path Data path.
+ * @param[out] yang_xpath Transformed path, NULL if \p path cannot match any node.
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on error.
+ */
+static int
+lyd_find_path_transform(const struct lyd_node *ctx_node, const char *path, char **yang_xpath)
 {
-    FUN_IN;
-
-    struct lyxp_set xp_set;
-    struct ly_set *set;
-    char *yang_xpath;
     const char * node_mod_name, *mod_name, *name;
     int mod_name_len, name_len, is_relative = -1;
-    uint32_t i;
 
-    if (!ctx_node || !path) {
-        LOGARG;
-        return NULL;
-    }
+    *yang_xpath = NULL;
 
     if (parse_schema_nodeid(path, &mod_name, &mod_name_len, &name, &name_len, &is_relative, NULL, NULL, 1) > 0) {
         if (name[0] == '#' && !is_relative) {
             node_mod_name = lyd_node_module(ctx_node)->name;
             if (strncmp(mod_name, node_mod_name, mod_name_len) || node_mod_name[mod_name_len]) {
-                return NULL;
+                return EXIT_SUCCESS;
             }
             path = name + name_len;
         }
     }
 
     /* transform JSON into YANG XPATH */
-    yang_xpath = transform_json2xpath(lyd_node_module(ctx_node), path);
-    if (!yang_xpath) {
+    *yang_xpath = transform_json2xpath(lyd_node_module(ctx_node), path);
+    if (!*yang_xpath) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+API struct ly_set *
+lyd_find_path(const struct lyd_node *ctx_node, const char *path)
+{
+    FUN_IN;
+
+    struct lyxp_set xp_set;
+    struct ly_set *set;
+    char *yang_xpath;
+    uint32_t i;
+
+    if (!ctx_node || !path) {
+        LOGARG;
+        return NULL;
+    }
+
+    if (lyd_find_path_transform(ctx_node, path, &yang_xpath) || !yang_xpath) {
         return NULL;
     }
 
@@ -6507,6 +6802,56 @@ lyd_find_path(const struct lyd_node *ctx_node, const char *path)
     return set;
 }
 
+API struct lyd_find_iter *
+lyd_find_path_iter(const struct lyd_node *ctx_node, const char *path)
+{
+    FUN_IN;
+
+    struct lyd_find_iter *iter;
+    char *yang_xpath;
+
+    if (!ctx_node || !path) {
+        LOGARG;
+        return NULL;
+    }
+
+    if (lyd_find_path_transform(ctx_node, path, &yang_xpath)) {
+        return NULL;
+    }
+
+    iter = lyxp_iter_new(yang_xpath, ctx_node, lyd_node_module(ctx_node));
+    free(yang_xpath);
+
+    return iter;
+}
+
+API struct lyd_node *
+lyd_find_path_next(struct lyd_find_iter *iter)
+{
+    FUN_IN;
+
+    struct lyd_node *node;
+
+    if (!iter) {
+        LOGARG;
+        return NULL;
+    }
+
+    if (lyxp_iter_next(iter, &node)) {
+        return NULL;
+    }
+
+    return node;
+}
+
+API void
+lyd_find_path_iter_free(struct lyd_find_iter *iter)
+{
+    FUN_IN;
+
+    lyxp_iter_free(iter);
+}
+
 API struct ly_set *
 lyd_find_instance(const struct lyd_node *data, const struct lys_node *schema)
 {
@@ -6962,6 +7307,37 @@ lyd_first_sibling(struct lyd_node *node)
     return start;
 }
 
+/**
+ * @brief Make sure there is space for at least \p count more items in the set.
+ *
+ * @param[in] set Set to enlarge.
+ * @param[in] count Number of items to be added.
+ * @return EXIT_SUCCESS or -1 on error.
+ */
+static int
+ly_set_grow(struct ly_set *set, unsigned int count)
+{
+    unsigned int size;
+    void **new;
+
+    if (set->size - set->number >= count) {
+        return EXIT_SUCCESS;
+    }
+
+    /* geometric growth so that adding N items means only log(N) reallocations */
+    size = set->size ? set->size : 8;
+    while (size - set->number < count) {
+        size <<= 1;
+    }
+
+    new = realloc(set->set.g, size * sizeof *(set->set.g));
+    LY_CHECK_ERR_RETURN(!new, LOGMEM(NULL), -1);
+    set->size = size;
+    set->set.g = new;
+
+    return EXIT_SUCCESS;
+}
+
 API struct ly_set *
 ly_set_new(void)
 {
@@ -7020,13 +7396,15 @@ ly_set_dup(const struct ly_set *set)
         return NULL;
     }
 
-    new = malloc(sizeof *new);
+    new = calloc(1, sizeof *new);
     LY_CHECK_ERR_RETURN(!new, LOGMEM(NULL), NULL);
     new->number = set->number;
     new->size = set->size;
-    new->set.g = malloc(new->size * sizeof *(new->set.g));
-    LY_CHECK_ERR_RETURN(!new->set.g, LOGMEM(NULL); free(new), NULL);
-    memcpy(new->set.g, set->set.g, new->size * sizeof *(new->set.g));
+    if (new->size) {
+        new->set.g = malloc(new->size * sizeof *(new->set.g));
+        LY_CHECK_ERR_RETURN(!new->set.g, LOGMEM(NULL); free(new), NULL);
+        memcpy(new->set.g, set->set.g, new->number * sizeof *(new->set.g));
+    }
 
     return new;
 }
@@ -7037,7 +7415,6 @@ ly_set_add(struct ly_set *set, void *node, int options)
     FUN_IN;
 
     unsigned int i;
-    void **new;
 
     if (!set) {
         LOGARG;
@@ -7054,11 +7431,8 @@ ly_set_add(struct ly_set *set, void *node, int options)
         }
     }
 
-    if (set->size == set->number) {
-        new = realloc(set->set.g, (set->size + 8) * sizeof *(set->set.g));
-        LY_CHECK_ERR_RETURN(!new, LOGMEM(NULL), -1);
-        set->size += 8;
-        set->set.g = new;
+    if (ly_set_grow(set, 1)) {
+        return -1;
     }
 
     set->set.g[set->number++] = node;
@@ -7072,7 +7446,6 @@ ly_set_merge(struct ly_set *trg, struct ly_set *src, int options)
     FUN_IN;
 
     unsigned int i, ret;
-    void **new;
 
     if (!trg) {
         LOGARG;
@@ -7096,11 +7469,8 @@ ly_set_merge(struct ly_set *trg, struct ly_set *src, int options)
     }
 
     /* allocate more memory if needed */
-    if (trg->size < trg->number + src->number) {
-        new = realloc(trg->set.g, (trg->number + src->number) * sizeof *(trg->set.g));
-        LY_CHECK_ERR_RETURN(!new, LOGMEM(NULL), -1);
-        trg->size = trg->number + src->number;
-        trg->set.g = new;
+    if (ly_set_grow(trg, src->number)) {
+        return -1;
     }
 
     /* copy contents from src into trg */
@@ -7141,7 +7511,7 @@ ly_set_rm(struct ly_set *set, void *node)
 {
     FUN_IN;
 
-    unsigned int i;
+    int i;
 
     if (!set || !node) {
         LOGARG;
@@ -7149,12 +7519,8 @@ ly_set_rm(struct ly_set *set, void *node)
     }
 
     /* get index */
-    for (i = 0; i < set->number; i++) {
-        if (set->set.g[i] == node) {
-            break;
-        }
-    }
-    if (i == set->number) {
+    i = ly_set_contains(set, node);
+    if (i == -1) {
         /* node is not in set */
         LOGARG;
         return EXIT_FAILURE;
@@ -7176,6 +7542,178 @@ ly_set_clean(struct ly_set *set)
     return EXIT_SUCCESS;
 }
 
+/**
+ * @brief Record of the ::ly_set_hashed hash index.
+ */
+struct ly_set_rec {
+    void *item;             /**< item stored in the set */
+    unsigned int index;     /**< its index in the set array */
+};
+
+static int
+ly_set_rec_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    return ((struct ly_set_rec *)val1_p)->item == ((struct ly_set_rec *)val2_p)->item;
+}
+
+static uint32_t
+ly_set_hash(void *item)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, (const char *)&item, sizeof item);
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+/**
+ * @brief Find an item in the set hash index.
+ *
+ * @param[in] hset Hashed set.
+ * @param[in] item Item to find.
+ * @return Found record, NULL if the item is not in the set.
+ */
+static struct ly_set_rec *
+ly_set_hash_find(const struct ly_set_hashed *hset, void *item)
+{
+    struct ly_set_rec rec, *match;
+
+    rec.item = item;
+    if (lyht_find(hset->ht, &rec, ly_set_hash(item), (void **)&match)) {
+        return NULL;
+    }
+    return match;
+}
+
+API struct ly_set_hashed *
+ly_set_hashed_new(void)
+{
+    FUN_IN;
+
+    struct ly_set_hashed *new;
+
+    new = calloc(1, sizeof *new);
+    LY_CHECK_ERR_RETURN(!new, LOGMEM(NULL), NULL);
+    new->ht = lyht_new(8, sizeof(struct ly_set_rec), ly_set_rec_equal, NULL, 1);
+    LY_CHECK_ERR_RETURN(!new->ht, LOGMEM(NULL); free(new), NULL);
+    return new;
+}
+
+API void
+ly_set_hashed_free(struct ly_set_hashed *hset)
+{
+    FUN_IN;
+
+    if (!hset) {
+        return;
+    }
+
+    lyht_free(hset->ht);
+    free(hset->set.set.g);
+    free(hset);
+}
+
+API int
+ly_set_hashed_contains(const struct ly_set_hashed *hset, void *node)
+{
+    FUN_IN;
+
+    struct ly_set_rec *rec;
+
+    if (!hset) {
+        return -1;
+    }
+
+    rec = ly_set_hash_find(hset, node);
+    return rec ? (int)rec->index : -1;
+}
+
+API int
+ly_set_hashed_add(struct ly_set_hashed *hset, void *node)
+{
+    FUN_IN;
+
+    struct ly_set_rec rec;
+
+    if (!hset) {
+        LOGARG;
+        return -1;
+    }
+
+    if (ly_set_grow(&hset->set, 1)) {
+        return -1;
+    }
+
+    rec.item = node;
+    rec.index = hset->set.number;
+    switch (lyht_insert(hset->ht, &rec, ly_set_hash(node), NULL)) {
+    case 0:
+        break;
+    case 1:
+        /* already in set */
+        return ly_set_hash_find(hset, node)->index;
+    default:
+        LOGMEM(NULL);
+        return -1;
+    }
+
+    hset->set.set.g[hset->set.number++] = node;
+
+    return hset->set.number - 1;
+}
+
+API int
+ly_set_hashed_rm(struct ly_set_hashed *hset, void *node)
+{
+    FUN_IN;
+
+    struct ly_set_rec *rec;
+    unsigned int index;
+
+    if (!hset || !node) {
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+
+    rec = ly_set_hash_find(hset, node);
+    if (!rec) {
+        /* node is not in set */
+        LOGARG;
+        return EXIT_FAILURE;
+    }
+    index = rec->index;
+    lyht_remove(hset->ht, rec, ly_set_hash(node));
+
+    /* put the last item instead of the removed one */
+    ly_set_rm_index(&hset->set, index);
+    if (index < hset->set.number) {
+        ly_set_hash_find(hset, hset->set.set.g[index])->index = index;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+API int
+ly_set_hashed_clean(struct ly_set_hashed *hset)
+{
+    FUN_IN;
+
+    struct hash_table *ht;
+
+    if (!hset) {
+        return EXIT_FAILURE;
+    }
+
+    if (hset->set.number) {
+        ht = lyht_new(8, sizeof(struct ly_set_rec), ly_set_rec_equal, NULL, 1);
+        LY_CHECK_ERR_RETURN(!ht, LOGMEM(NULL), EXIT_FAILURE);
+        lyht_free(hset->ht);
+        hset->ht = ht;
+    }
+
+    hset->set.number = 0;
+    return EXIT_SUCCESS;
+}
+
 API int
 lyd_wd_default(struct lyd_node_leaf_list *node)
 {
@@ -179,6 +179,13 @@ struct lyd_node {
     uint8_t dflt:1;                  /**< flag for implicit default node */
     uint8_t when_status:3;           /**< bit for checking if the when-stmt condition is resolved - internal use only,
                                           do not use this value! */
+#ifdef LY_ENABLED_PACKED_DATA_NODES
+    /* the next byte is used by ::lyd_node_leaf_list */
+
+#ifdef LY_ENABLED_CACHE
+    uint32_t hash;                   /**< hash of this particular node (module name + schema name + key string values if list) */
+#endif
+#endif
 
     struct lyd_attr *attr;           /**< pointer to the list of attributes of this node */
     struct lyd_node *next;           /**< pointer to the next sibling node (NULL if there is no one) */
@@ -193,7 +200,9 @@ struct lyd_node {
 #endif
 
 #ifdef LY_ENABLED_CACHE
+#ifndef LY_ENABLED_PACKED_DATA_NODES
     uint32_t hash;                   /**< hash of this particular node (module name + schema name + key string values if list) */
+#endif
     struct hash_table *ht;           /**< hash table with all the direct children (except keys for a list, lists without keys) */
 #endif
 
@@ -221,6 +230,13 @@ struct lyd_node_leaf_list {
     uint8_t dflt:1;                  /**< flag for implicit default node */
     uint8_t when_status:3;           /**< bit for checking if the when-stmt condition is resolved - internal use only,
                                           do not use this value! */
+#ifdef LY_ENABLED_PACKED_DATA_NODES
+    uint8_t value_flags;             /**< value type flags */
+
+#ifdef LY_ENABLED_CACHE
+    uint32_t hash;                   /**< hash of this particular node (module name + schema name + string value if leaf-list) */
+#endif
+#endif
 
     struct lyd_attr *attr;           /**< pointer to the list of attributes of this node */
     struct lyd_node *next;           /**< pointer to the next sibling node (NULL if there is no one) */
@@ -234,7 +250,7 @@ struct lyd_node_leaf_list {
     void *priv;                      /**< private user data, not used by libyang */
 #endif
 
-#ifdef LY_ENABLED_CACHE
+#if defined(LY_ENABLED_CACHE) && !defined(LY_ENABLED_PACKED_DATA_NODES)
     uint32_t hash;                   /**< hash of this particular node (module name + schema name + string value if leaf-list) */
 #endif
 
@@ -244,7 +260,9 @@ struct lyd_node_leaf_list {
     const char *value_str;           /**< string representation of value (for comparison, printing,...), always corresponds to value_type */
     lyd_val value;                   /**< node's value representation, always corresponds to schema->type.base */
     LY_DATA_TYPE _PACKED value_type; /**< type of the value in the node, mainly for union to avoid repeating of type detection */
+#ifndef LY_ENABLED_PACKED_DATA_NODES
     uint8_t value_flags;             /**< value type flags */
+#endif
 };
 
 /**
@@ -283,6 +301,10 @@ struct lyd_node_anydata {
     uint8_t when_status:3;           /**< bit for checking if the when-stmt condition is resolved - internal use only,
                                           do not use this value! */
 
+#if defined(LY_ENABLED_CACHE) && defined(LY_ENABLED_PACKED_DATA_NODES)
+    uint32_t hash;                   /**< hash of this particular node (module name + schema name) */
+#endif
+
     struct lyd_attr *attr;           /**< pointer to the list of attributes of this node */
     struct lyd_node *next;           /**< pointer to the next sibling node (NULL if there is no one) */
     struct lyd_node *prev;           /**< pointer to the previous sibling node \note Note that this pointer is
@@ -295,7 +317,7 @@ struct lyd_node_anydata {
     void *priv;                      /**< private user data, not used by libyang */
 #endif
 
-#ifdef LY_ENABLED_CACHE
+#if defined(LY_ENABLED_CACHE) && !defined(LY_ENABLED_PACKED_DATA_NODES)
     uint32_t hash;                   /**< hash of this particular node (module name + schema name) */
 #endif
 
@@ -1143,6 +1165,47 @@ int lyd_schema_sort(struct lyd_node *sibling, int recursive);
  */
 struct ly_set *lyd_find_path(const struct lyd_node *ctx_node, const char *path);
 
+/**
+ * @brief Opaque iterator over the data nodes matching a path, see ::lyd_find_path_iter().
+ */
+struct lyd_find_iter;
+
+/**
+ * @brief Create an iterator over the data nodes matching the provided path. Unlike ::lyd_find_path(),
+ * the matching nodes are not collected into a set, they are found one at a time by ::lyd_find_path_next().
+ *
+ * Paths consisting only of node name tests with predicates, such as "/mod:cont/list[key='val']/leaf" or
+ * "/mod:cont//leaf[. > 10]", are evaluated lazily so the search stops as soon as the caller stops iterating
+ * and it takes a constant amount of memory. Only the last step of such paths may search all the descendants ('//')
+ * and the predicates cannot use the last() function. Any other paths are evaluated at once
+ * when the iterator is created.
+ *
+ * The data tree must not be modified while iterating.
+ *
+ * Learn more about the path format on page @ref howtoxpath.
+ *
+ * @param[in] ctx_node Path context node.
+ * @param[in] path Data path expression filtering the matching nodes.
+ * @return Iterator to be freed by ::lyd_find_path_iter_free(), NULL on error.
+ */
+struct lyd_find_iter *lyd_find_path_iter(const struct lyd_node *ctx_node, const char *path);
+
+/**
+ * @brief Get the next data node matching the path of an iterator. The nodes are returned in the document order.
+ *
+ * @param[in] iter Iterator created by ::lyd_find_path_iter().
+ * @return Next matching data node, NULL if there are no more or on error (ly_errno is set).
+ */
+struct lyd_node *lyd_find_path_next(struct lyd_find_iter *iter);
+
+/**
+ * @brief Free an iterator created by ::lyd_find_path_iter(). It can be freed at any time, even
+ * before all the matching nodes were returned.
+ *
+ * @param[in] iter Iterator to free.
+ */
+void lyd_find_path_iter_free(struct lyd_find_iter *iter);
+
 /**
  * @brief Search in the given data for instances of the provided schema node.
  *
@@ -1341,6 +1404,86 @@ void lyd_free(struct lyd_node *node);
  */
 void lyd_free_withsiblings(struct lyd_node *node);
 
+/**
+ * @brief Opaque holder of the published versions of a data tree, see ::lyd_rcu_new().
+ */
+struct lyd_rcu;
+
+/**
+ * @brief Create a read-copy-update holder of a data tree for readers that do not block on writers.
+ *
+ * Readers get the current version of the data tree by ::lyd_rcu_read_lock() and traverse it without any
+ * locking until ::lyd_rcu_read_unlock(). A writer modifies its own copy from ::lyd_rcu_dup() (or any other
+ * tree) and makes it the current version by ::lyd_rcu_publish(). The replaced version is freed only after
+ * all the readers that could have got it finish, so readers never wait for writers and writers do not wait
+ * for readers.
+ *
+ * Data nodes are linked to their parents and siblings, so they cannot be shared between the versions and every
+ * version is a complete data tree. Writers must be serialized by the caller, a publication replaces whatever
+ * version is current at the moment.
+ *
+ * @param[in] root First top-level node of the initial version, the holder takes it over. NULL for an empty tree.
+ * @return New holder to be freed by ::lyd_rcu_free(), NULL on error.
+ */
+struct lyd_rcu *lyd_rcu_new(struct lyd_node *root);
+
+/**
+ * @brief Start reading the current version of a data tree.
+ *
+ * The returned tree must not be modified. It stays valid until the matching ::lyd_rcu_read_unlock(), even
+ * if newer versions are published meanwhile. Read sections can be nested.
+ *
+ * @param[in] rcu Holder of the data tree.
+ * @param[out] ticket Reader ticket to be passed to ::lyd_rcu_read_unlock().
+ * @return First top-level node of the current version, NULL if the tree is empty or on error.
+ */
+const struct lyd_node *lyd_rcu_read_lock(struct lyd_rcu *rcu, int *ticket);
+
+/**
+ * @brief Finish reading a version of a data tree started by ::lyd_rcu_read_lock().
+ *
+ * @param[in] rcu Holder of the data tree.
+ * @param[in] ticket Reader ticket returned by ::lyd_rcu_read_lock().
+ */
+void lyd_rcu_read_unlock(struct lyd_rcu *rcu, int ticket);
+
+/**
+ * @brief Create a private copy of the current version of a data tree to be modified and published.
+ *
+ * @param[in] rcu Holder of the data tree.
+ * @param[out] root Copy of the whole data tree, NULL if the tree is empty.
+ * @return 0 on success, nonzero on error.
+ */
+int lyd_rcu_dup(struct lyd_rcu *rcu, struct lyd_node **root);
+
+/**
+ * @brief Make a data tree the current version read by all the new readers.
+ *
+ * The replaced version is freed once there are no readers that could have got it, which is checked
+ * by the following publications and ::lyd_rcu_synchronize().
+ *
+ * @param[in] rcu Holder of the data tree.
+ * @param[in] root First top-level node of the new version, the holder takes it over. NULL for an empty tree.
+ * @return 0 on success, nonzero on error (\p root is not published and stays owned by the caller).
+ */
+int lyd_rcu_publish(struct lyd_rcu *rcu, struct lyd_node *root);
+
+/**
+ * @brief Wait for all the readers of the replaced versions of a data tree to finish and free these versions.
+ *
+ * Must not be called from a read section of the same holder.
+ *
+ * @param[in] rcu Holder of the data tree.
+ */
+void lyd_rcu_synchronize(struct lyd_rcu *rcu);
+
+/**
+ * @brief Free the holder of a data tree with all its versions. There must be no readers left.
+ *
+ * @param[in] rcu Holder of the data tree.
+ */
+void lyd_rcu_free(struct lyd_rcu *rcu);
+
 /**
  * @brief Insert attribute into the data node.
  *
@@ -17,6 +17,7 @@
 #define LY_TREE_INTERNAL_H_
 
 #include <stdint.h>
+#include <pthread.h>
 
 #include "libyang.h"
 #include "tree_schema.h"
@@ -76,15 +77,29 @@ struct lyb_state {
     const struct lys_module **models;
     int mod_count;
     struct ly_ctx *ctx;
+    uint8_t header;              /* LYB header flags (LYB_HEADER_*) */
+    const char **strs;           /* string table (#LYB_HEADER_STRTABLE), referenced in the dictionary by the parser */
+    uint32_t str_count;
 
     /* LYB printer only */
-    struct {
-        struct lys_node *first_sibling;
-        struct hash_table *ht;
-    } *sib_ht;
+    uint8_t *seg;                /* data segment being written in the streamed variant */
+    struct hash_table *str_ht;   /* value strings and their string table indices */
+    struct hash_table **sib_ht;  /* sibling hash tables not cached in the context */
     int sib_ht_count;
 };
 
+/**
+ * @brief Published versions of a data tree, see lyd_rcu_new().
+ */
+struct lyd_rcu {
+    struct lyd_node *root;       /* current version, accessed atomically */
+    uint32_t epoch;              /* readers register in the epoch parity counter, accessed atomically */
+    uint32_t readers[2];         /* readers that registered in an even/odd epoch, accessed atomically */
+    pthread_mutex_t lock;        /* serializes the writers */
+    struct ly_set *retired;      /* replaced versions possibly read by the readers of the current epoch */
+    struct ly_set *draining;     /* replaced versions possibly read by the readers of the previous epoch */
+};
+
 /* struct lyb_state allocation step */
 #define LYB_STATE_STEP 4
 
@@ -129,10 +144,84 @@ struct lyb_state {
 /* Type large enough for all meta data */
 #define LYB_META uint16_t
 
+/**
+ * LYB streamed variant
+ *
+ * Instead of the chunk sizes, which are known only when the chunk is finished, subtrees are delimited
+ * by tokens so the data can be written strictly forward. Any byte other than the tokens is the size
+ * of the data segment following it, segments never cross subtree boundaries.
+ */
+
+/* Header flag of the streamed variant */
+#define LYB_HEADER_STREAM 0x01
+
+/* Token ending the current subtree */
+#define LYB_STREAM_END 0x00
+
+/* Token starting a new (nested) subtree */
+#define LYB_STREAM_START 0xFF
+
+/* Maximum size of a single data segment */
+#define LYB_STREAM_SEG_MAX (LYB_STREAM_START - 1)
+
+/**
+ * LYB string table
+ *
+ * Value strings repeated in the data are stored only once in a table following the used models,
+ * the values then refer to them by their index (from 1, 0 means the string follows in place).
+ * The index is stored on as few bytes as possible for the table size.
+ */
+
+/* Header flag of the data with a string table */
+#define LYB_HEADER_STRTABLE 0x02
+
+/* Minimal length of a string worth putting into the table */
+#define LYB_STRTABLE_MIN_LEN 3
+
 LYB_HASH lyb_hash(struct lys_node *sibling, uint8_t collision_id);
 
 int lyb_has_schema_model(struct lys_node *sibling, const struct lys_module **models, int mod_count);
 
+/**
+ * @brief Callback building a LYB sibling hash table.
+ *
+ * @param[in] parent Schema parent of the siblings, NULL for top-level nodes.
+ * @param[in] mod Module of the siblings.
+ * @return Sibling hash table, NULL on error.
+ */
+typedef struct hash_table *(*lyb_sib_build_clb)(const struct lys_node *parent, const struct lys_module *mod);
+
+/**
+ * @brief Create the context cache of LYB sibling hash tables.
+ *
+ * @return New empty cache, NULL on error.
+ */
+struct lyb_sib_cache *lyb_sib_cache_new(void);
+
+/**
+ * @brief Free the context cache of LYB sibling hash tables with all the tables.
+ *
+ * @param[in] cache Cache to free.
+ */
+void lyb_sib_cache_free(struct lyb_sib_cache *cache);
+
+/**
+ * @brief Get a LYB sibling hash table from the context cache, build it if not there yet.
+ *
+ * The tables are valid until the module set of the context changes, which must not happen
+ * while a LYB printer or parser is running.
+ *
+ * @param[in] ctx Context with the cache.
+ * @param[in] parent Schema parent of the siblings, NULL for top-level nodes.
+ * @param[in] mod Module of the siblings.
+ * @param[in] parser Whether the table is built for the parser or for the printer.
+ * @param[in] build Callback building the table.
+ * @param[out] dynamic Set if the returned table is not in the cache and must be freed by the caller.
+ * @return Sibling hash table, NULL on error.
+ */
+struct hash_table *lyb_sib_cache_get(struct ly_ctx *ctx, const struct lys_node *parent, const struct lys_module *mod,
+                                     int parser, lyb_sib_build_clb build, int *dynamic);
+
 /**
  * Macros to work with ::lyd_node#when_status
  * +--- bit 1 - some when-stmt connected with the node (resolve_applies_when() is true)
@@ -156,9 +245,22 @@ int lyb_has_schema_model(struct lys_node *sibling, const struct lys_module **mod
 #ifdef LY_ENABLED_CACHE
 
 /**
- * @brief Minimum number of children for the parent to create a hash table for them.
+ * @brief Minimum number of children for the parent to create a hash table for them. Below it, the siblings
+ * are simply scanned, which is as fast for so few nodes and saves the memory of the table.
  */
-#   define LY_CACHE_HT_MIN_CHILDREN 4
+#   define LY_CACHE_HT_MIN_CHILDREN 12
+
+/**
+ * @brief Number of children under which the parent hash table is freed again. Lower than
+ * ::LY_CACHE_HT_MIN_CHILDREN so that adding and removing a single child does not create and free the table repeatedly.
+ */
+#   define LY_CACHE_HT_FREE_CHILDREN (LY_CACHE_HT_MIN_CHILDREN / 2)
+
+/**
+ * @brief Initial size of the parent hash table, power of 2. Big enough for ::LY_CACHE_HT_MIN_CHILDREN children
+ * to fit without enlarging it right away.
+ */
+#   define LY_CACHE_HT_INIT_SIZE 32
 
     int lyd_hash(struct lyd_node *node);
 
@@ -483,6 +585,70 @@ int lys_get_sibling(const struct lys_node *siblings, const char *mod_name, int m
 int lys_getnext_data(const struct lys_module *mod, const struct lys_node *parent, const char *name, int nam_len,
                      LYS_NODE type, int getnext_opts, const struct lys_node **ret);
 
+/**
+ * @brief Create the context index of schema node children used by lys_child_find().
+ *
+ * @return New empty index, NULL on error.
+ */
+struct lys_child_index *lys_child_index_new(void);
+
+/**
+ * @brief Free the context index of schema node children.
+ *
+ * @param[in] idx Index to free.
+ */
+void lys_child_index_free(struct lys_child_index *idx);
+
+/**
+ * @brief Invalidate the indexed children of a schema node, must be called on every change of its children.
+ *
+ * @param[in] parent Parent whose children are changed, NULL for top-level nodes.
+ * @param[in] module Module of the top-level nodes, used only if \p parent == NULL.
+ */
+void lys_child_index_invalidate(const struct lys_node *parent, const struct lys_module *module);
+
+/**
+ * @brief Remove a schema node or a main module being freed from the context index of schema node children.
+ *
+ * @param[in] ctx Context with the index.
+ * @param[in] parent Schema node or main module.
+ */
+void lys_child_index_remove(struct ly_ctx *ctx, const void *parent);
+
+/**
+ * @brief Index the children of all the schema nodes invalidated since the last update. Must be called
+ * once a change of the schemas is finished, does nothing while modules are being parsed.
+ *
+ * @param[in] ctx Context with the index.
+ */
+void lys_child_index_update(struct ly_ctx *ctx);
+
+/**
+ * @brief Find a data node among the children of a schema node or among the top-level nodes of a module
+ * the same way lys_getnext() iteration would, using the context index. Does not log.
+ *
+ * @param[in] parent Parent of the node, NULL for a top-level node.
+ * @param[in] module Module of the top-level node, used only if \p parent == NULL.
+ * @param[in] ns Namespace of the main module of the node (from the dictionary).
+ * @param[in] name Node name.
+ * @param[in] nam_len Node \p name length.
+ * @param[in] getnext_opts lys_getnext() options to mimic, only #LYS_GETNEXT_NOSTATECHECK can be used with the index.
+ * @param[out] ret Found node, NULL if there is no such node.
+ *
+ * @return 0 if \p ret was set, 1 if the index cannot be used and the children must be iterated.
+ */
+int lys_child_find(const struct lys_node *parent, const struct lys_module *module, const char *ns, const char *name,
+                   int nam_len, int getnext_opts, const struct lys_node **ret);
+
+/**
+ * @brief Build everything that is otherwise built lazily when working with data of a module - precompiled
+ * patterns and compiled must and when expressions.
+ *
+ * @param[in] module Module to process.
+ * @return 0 on success, -1 on error.
+ */
+int lys_precompute(struct lys_module *module);
+
 int lyd_get_unique_default(const char* unique_expr, struct lyd_node *list, const char **dflt);
 
 int lyd_build_relative_data_path(const struct lys_module *module, const struct lyd_node *node, const char *schema_id,
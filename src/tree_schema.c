@@ -223,6 +223,362 @@ lys_get_sibling(const struct lys_node *siblings, const char *mod_name, int mod_n
     return EXIT_FAILURE;
 }
 
+/**
+ * @brief Minimal number of data children of a schema node for them to be indexed,
+ * smaller sibling sets are faster to iterate.
+ */
+#define LYS_CHILD_INDEX_MIN 8
+
+/**
+ * @brief Context index of data children of schema nodes.
+ *
+ * Children of a schema node are indexed by the namespace of their module and their name,
+ * transparent nodes (choice, case, uses, input, output) are skipped exactly as by lys_getnext().
+ * A change of the children of a node only marks the node (and its transparent ancestors) dirty
+ * and the dirty parents are indexed again by lys_child_index_update() once the schema change
+ * is finished. The index is thus written only while the schemas are being modified, which is
+ * never done concurrently with any other work in the context, and lookups need no locking.
+ */
+struct lys_child_index {
+    struct hash_table *parents;  /* struct lys_child_parent, parents whose children were changed or inspected */
+};
+
+struct lys_child_parent {
+    const void *parent;          /* parent schema node or the main module for top-level nodes */
+    int top;                     /* whether parent is the module */
+    int dirty;                   /* children changed since they were inspected */
+    struct hash_table *children; /* struct lys_child_rec, NULL if the children must be iterated */
+};
+
+struct lys_child_rec {
+    const char *ns;              /* namespace of the node module (dictionary) */
+    const char *name;            /* node name */
+    int nam_len;                 /* node name length */
+    const struct lys_node *node;
+};
+
+static int
+lys_child_parent_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    return ((struct lys_child_parent *)val1_p)->parent == ((struct lys_child_parent *)val2_p)->parent;
+}
+
+static uint32_t
+lys_child_parent_hash(const void *parent)
+{
+    return dict_hash_multi(dict_hash_multi(0, (const char *)&parent, sizeof parent), NULL, 0);
+}
+
+static int
+lys_child_rec_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lys_child_rec *rec1 = val1_p, *rec2 = val2_p;
+
+    return (rec1->ns == rec2->ns) && (rec1->nam_len == rec2->nam_len) && !strncmp(rec1->name, rec2->name, rec1->nam_len);
+}
+
+static uint32_t
+lys_child_rec_hash(const struct lys_child_rec *rec)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, (const char *)&rec->ns, sizeof rec->ns);
+    hash = dict_hash_multi(hash, rec->name, rec->nam_len);
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+struct lys_child_index *
+lys_child_index_new(void)
+{
+    struct lys_child_index *idx;
+
+    idx = calloc(1, sizeof *idx);
+    LY_CHECK_ERR_RETURN(!idx, LOGMEM(NULL), NULL);
+
+    idx->parents = lyht_new(64, sizeof(struct lys_child_parent), lys_child_parent_equal, NULL, 1);
+    LY_CHECK_ERR_RETURN(!idx->parents, LOGMEM(NULL); free(idx), NULL);
+
+    return idx;
+}
+
+void
+lys_child_index_free(struct lys_child_index *idx)
+{
+    struct ht_rec *rec;
+    uint32_t i;
+
+    if (!idx) {
+        return;
+    }
+
+    for (i = 0; i < idx->parents->size; ++i) {
+        rec = lyht_get_rec(idx->parents->recs, idx->parents->rec_size, i);
+        if (rec->hits > 0) {
+            lyht_free(((struct lys_child_parent *)&rec->val)->children);
+        }
+    }
+    lyht_free(idx->parents);
+    free(idx);
+}
+
+/**
+ * @brief Mark the children of a parent changed.
+ *
+ * @param[in] idx Child index.
+ * @param[in] parent Parent schema node or the main module.
+ * @param[in] top Whether \p parent is the module.
+ */
+static void
+lys_child_index_dirty(struct lys_child_index *idx, const void *parent, int top)
+{
+    struct lys_child_parent prec, *pmatch;
+    uint32_t hash;
+
+    prec.parent = parent;
+    hash = lys_child_parent_hash(parent);
+    if (!lyht_find(idx->parents, &prec, hash, (void **)&pmatch)) {
+        lyht_free(pmatch->children);
+        pmatch->children = NULL;
+        pmatch->dirty = 1;
+        return;
+    }
+
+    prec.top = top;
+    prec.dirty = 1;
+    prec.children = NULL;
+    if (lyht_insert(idx->parents, &prec, hash, NULL) == -1) {
+        /* the children will just be iterated */
+        LOGMEM(NULL);
+    }
+}
+
+void
+lys_child_index_invalidate(const struct lys_node *parent, const struct lys_module *module)
+{
+    struct lys_child_index *idx;
+
+    idx = parent ? parent->module->ctx->child_index : module->ctx->child_index;
+    if (!idx) {
+        return;
+    }
+
+    while (parent) {
+        if (parent->nodetype == LYS_AUGMENT) {
+            if (!((struct lys_node_augment *)parent)->target || (parent->flags & LYS_NOTAPPLIED)) {
+                /* the children are not connected into the target */
+                return;
+            }
+            /* the children are connected into the target */
+            parent = ((struct lys_node_augment *)parent)->target;
+            continue;
+        }
+
+        if (parent->nodetype & (LYS_CONTAINER | LYS_LIST | LYS_CHOICE | LYS_CASE | LYS_INPUT | LYS_OUTPUT | LYS_NOTIF)) {
+            lys_child_index_dirty(idx, parent, 0);
+        }
+        if (!(parent->nodetype & (LYS_CHOICE | LYS_CASE | LYS_USES))) {
+            /* the children of a non-transparent node are not children of its parent */
+            return;
+        }
+
+        module = lys_node_module(parent);
+        parent = parent->parent;
+    }
+
+    lys_child_index_dirty(idx, lys_main_module(module), 1);
+}
+
+void
+lys_child_index_remove(struct ly_ctx *ctx, const void *parent)
+{
+    struct lys_child_parent prec, *pmatch;
+    uint32_t hash;
+
+    if (!ctx->child_index) {
+        return;
+    }
+
+    prec.parent = parent;
+    hash = lys_child_parent_hash(parent);
+    if (!lyht_find(ctx->child_index->parents, &prec, hash, (void **)&pmatch)) {
+        lyht_free(pmatch->children);
+        lyht_remove(ctx->child_index->parents, &prec, hash);
+    }
+}
+
+/**
+ * @brief Collect the data nodes among siblings the same way lys_getnext() traverses them.
+ *
+ * @param[in] first First sibling.
+ * @param[in,out] set Set with the collected nodes.
+ * @return 0 on success, -1 if the siblings cannot be indexed.
+ */
+static int
+lys_child_index_collect(const struct lys_node *first, struct ly_set *set)
+{
+    const struct lys_node *node;
+
+    LY_TREE_FOR(first, node) {
+        switch (node->nodetype) {
+        case LYS_GROUPING:
+            break;
+        case LYS_CHOICE:
+        case LYS_CASE:
+        case LYS_USES:
+        case LYS_INPUT:
+        case LYS_OUTPUT:
+            if (lys_child_index_collect(node->child, set)) {
+                return -1;
+            }
+            break;
+        case LYS_CONTAINER:
+        case LYS_LIST:
+        case LYS_LEAF:
+        case LYS_LEAFLIST:
+        case LYS_ANYXML:
+        case LYS_ANYDATA:
+        case LYS_RPC:
+        case LYS_ACTION:
+        case LYS_NOTIF:
+            if (ly_set_add(set, (void *)node, LY_SET_OPT_USEASLIST) == -1) {
+                return -1;
+            }
+            break;
+        default:
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Index the children of a parent if it is worth it.
+ *
+ * @param[in] first First child of the parent.
+ * @return Children hash table, NULL if the children are to be iterated.
+ */
+static struct hash_table *
+lys_child_index_build(const struct lys_node *first)
+{
+    struct hash_table *children = NULL;
+    struct lys_child_rec rec;
+    struct ly_set *set;
+    const struct lys_node *node;
+    unsigned int i;
+
+    set = ly_set_new();
+    LY_CHECK_ERR_RETURN(!set, LOGMEM(NULL), NULL);
+    if (lys_child_index_collect(first, set) || (set->number < LYS_CHILD_INDEX_MIN)) {
+        /* iterate these children */
+        goto cleanup;
+    }
+
+    children = lyht_new(16, sizeof(struct lys_child_rec), lys_child_rec_equal, NULL, 1);
+    LY_CHECK_ERR_GOTO(!children, LOGMEM(NULL), cleanup);
+    for (i = 0; i < set->number; ++i) {
+        node = set->set.s[i];
+        rec.ns = lys_node_module(node)->ns;
+        rec.name = node->name;
+        rec.nam_len = strlen(node->name);
+        rec.node = node;
+        if (lyht_insert(children, &rec, lys_child_rec_hash(&rec), NULL)) {
+            /* same name in input and output or similar, lys_getnext() order must decide */
+            lyht_free(children);
+            children = NULL;
+            break;
+        }
+    }
+
+cleanup:
+    ly_set_free(set);
+    return children;
+}
+
+void
+lys_child_index_update(struct ly_ctx *ctx)
+{
+    struct lys_child_parent *prec;
+    struct ht_rec *rec;
+    uint32_t i;
+
+    if (!ctx->child_index || ctx->models.parsing_sub_modules_count) {
+        /* the schema change is not finished */
+        return;
+    }
+
+    for (i = 0; i < ctx->child_index->parents->size; ++i) {
+        rec = lyht_get_rec(ctx->child_index->parents->recs, ctx->child_index->parents->rec_size, i);
+        if (rec->hits < 1) {
+            continue;
+        }
+
+        prec = (struct lys_child_parent *)&rec->val;
+        if (prec->dirty) {
+            prec->children = lys_child_index_build(prec->top ? ((struct lys_module *)prec->parent)->data
+                                                   : ((struct lys_node *)prec->parent)->child);
+            prec->dirty = 0;
+        }
+    }
+}
+
+int
+lys_child_find(const struct lys_node *parent, const struct lys_module *module, const char *ns, const char *name,
+               int nam_len, int getnext_opts, const struct lys_node **ret)
+{
+    struct ly_ctx *ctx;
+    struct lys_child_parent prec, *pmatch;
+    struct lys_child_rec rec, *match;
+    const struct lys_node *iter;
+
+    assert(parent || module);
+
+    if (getnext_opts & ~LYS_GETNEXT_NOSTATECHECK) {
+        /* transparent nodes are not skipped the same way */
+        return 1;
+    }
+
+    if (parent) {
+        if (!(parent->nodetype & (LYS_CONTAINER | LYS_LIST | LYS_CHOICE | LYS_CASE | LYS_INPUT | LYS_OUTPUT | LYS_NOTIF))) {
+            /* RPC input/output names can collide, augments and uses are special for lys_getnext() */
+            return 1;
+        }
+        ctx = parent->module->ctx;
+        prec.parent = parent;
+    } else {
+        module = lys_main_module(module);
+        if (!(getnext_opts & LYS_GETNEXT_NOSTATECHECK) && (module->disabled || !module->implemented)) {
+            *ret = NULL;
+            return 0;
+        }
+        ctx = module->ctx;
+        prec.parent = module;
+    }
+
+    if (!ctx->child_index || lyht_find(ctx->child_index->parents, &prec, lys_child_parent_hash(prec.parent), (void **)&pmatch)
+            || !pmatch->children) {
+        /* not indexed, not worth indexing or changed since */
+        return 1;
+    }
+
+    rec.ns = ns;
+    rec.name = name;
+    rec.nam_len = nam_len;
+    *ret = lyht_find(pmatch->children, &rec, lys_child_rec_hash(&rec), (void **)&match) ? NULL : match->node;
+
+    if (*ret && !(getnext_opts & LYS_GETNEXT_NOSTATECHECK)) {
+        /* lys_getnext() skips disabled nodes including the transparent ones on the way */
+        for (iter = *ret; iter && (iter != parent); iter = lys_parent(iter)) {
+            if (lys_is_disabled(iter, 0)) {
+                *ret = NULL;
+                break;
+            }
+        }
+    }
+
+    return 0;
+}
+
 int
 lys_getnext_data(const struct lys_module *mod, const struct lys_node *parent, const char *name, int nam_len,
                  LYS_NODE type, int getnext_opts, const struct lys_node **ret)
@@ -236,6 +592,16 @@ lys_getnext_data(const struct lys_module *mod, const struct lys_node *parent, co
         mod = lys_node_module(parent);
     }
 
+    if (!lys_child_find(parent, mod, lys_main_module(mod)->ns, name, nam_len, getnext_opts, &node)) {
+        if (!node || (type && !(node->nodetype & type))) {
+            return EXIT_FAILURE;
+        }
+        if (ret) {
+            *ret = node;
+        }
+        return EXIT_SUCCESS;
+    }
+
     /* try to find the node */
     node = NULL;
     while ((node = lys_getnext(node, parent, mod, getnext_opts))) {
@@ -258,6 +624,238 @@ lys_getnext_data(const struct lys_module *mod, const struct lys_node *parent, co
     return EXIT_FAILURE;
 }
 
+static int
+lys_precompute_type(struct ly_ctx *ctx, struct lys_type *type)
+{
+    unsigned int i;
+
+    switch (type->base) {
+    case LY_TYPE_STRING:
+#ifdef LY_ENABLED_CACHE
+        if (lyp_precompile_type_patterns(ctx, type) || lyp_multi_pattern_precompile(ctx, type)) {
+            return -1;
+        }
+#endif
+        break;
+    case LY_TYPE_UNION:
+        for (i = 0; i < type->info.uni.count; ++i) {
+            if (lys_precompute_type(ctx, &type->info.uni.types[i])) {
+                return -1;
+            }
+        }
+#ifdef LY_ENABLED_CACHE
+        if (lyp_multi_pattern_precompile(ctx, type)) {
+            return -1;
+        }
+#endif
+        break;
+    default:
+        break;
+    }
+
+    return 0;
+}
+
+static int
+lys_precompute_tpdfs(struct ly_ctx *ctx, struct lys_tpdf *tpdf, uint16_t tpdf_size)
+{
+    uint16_t i;
+
+    for (i = 0; i < tpdf_size; ++i) {
+        if (lys_precompute_type(ctx, &tpdf[i].type)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+lys_precompute_xpath(struct ly_ctx *ctx, struct lys_restr *must, uint8_t must_size, struct lys_when *when)
+{
+    uint8_t i;
+
+    for (i = 0; i < must_size; ++i) {
+        if (lyxp_expr_precompile(ctx, must[i].expr)) {
+            return -1;
+        }
+    }
+    if (when && lyxp_expr_precompile(ctx, when->cond)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Precompute the typedefs in a grouping subtree. Its nodes are never used themselves, but the types
+ * of their instances refer to these typedefs.
+ *
+ * @param[in] ctx Context.
+ * @param[in] first First node of the siblings in the grouping.
+ * @return 0 on success, -1 on error.
+ */
+static int
+lys_precompute_grouping_tpdfs(struct ly_ctx *ctx, struct lys_node *first)
+{
+    struct lys_node *node;
+    int ret;
+
+    LY_TREE_FOR(first, node) {
+        switch (node->nodetype) {
+        case LYS_GROUPING:
+            ret = lys_precompute_tpdfs(ctx, ((struct lys_node_grp *)node)->tpdf, ((struct lys_node_grp *)node)->tpdf_size);
+            break;
+        case LYS_CONTAINER:
+            ret = lys_precompute_tpdfs(ctx, ((struct lys_node_container *)node)->tpdf,
+                                       ((struct lys_node_container *)node)->tpdf_size);
+            break;
+        case LYS_LIST:
+            ret = lys_precompute_tpdfs(ctx, ((struct lys_node_list *)node)->tpdf, ((struct lys_node_list *)node)->tpdf_size);
+            break;
+        case LYS_INPUT:
+        case LYS_OUTPUT:
+            ret = lys_precompute_tpdfs(ctx, ((struct lys_node_inout *)node)->tpdf, ((struct lys_node_inout *)node)->tpdf_size);
+            break;
+        case LYS_NOTIF:
+            ret = lys_precompute_tpdfs(ctx, ((struct lys_node_notif *)node)->tpdf, ((struct lys_node_notif *)node)->tpdf_size);
+            break;
+        case LYS_RPC:
+        case LYS_ACTION:
+            ret = lys_precompute_tpdfs(ctx, ((struct lys_node_rpc_action *)node)->tpdf,
+                                       ((struct lys_node_rpc_action *)node)->tpdf_size);
+            break;
+        default:
+            ret = 0;
+            break;
+        }
+        if (ret) {
+            return -1;
+        }
+
+        if (!(node->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA)) && lys_precompute_grouping_tpdfs(ctx, node->child)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+lys_precompute_siblings(struct ly_ctx *ctx, struct lys_node *first)
+{
+    struct lys_node *node;
+    int ret;
+
+    LY_TREE_FOR(first, node) {
+        switch (node->nodetype) {
+        case LYS_GROUPING:
+            /* only the instantiated nodes are used, but they may refer to the typedefs in the grouping */
+            if (lys_precompute_tpdfs(ctx, ((struct lys_node_grp *)node)->tpdf, ((struct lys_node_grp *)node)->tpdf_size)
+                    || lys_precompute_grouping_tpdfs(ctx, node->child)) {
+                return -1;
+            }
+            continue;
+        case LYS_CONTAINER:
+            ret = lys_precompute_tpdfs(ctx, ((struct lys_node_container *)node)->tpdf,
+                                       ((struct lys_node_container *)node)->tpdf_size)
+                  || lys_precompute_xpath(ctx, ((struct lys_node_container *)node)->must,
+                                          ((struct lys_node_container *)node)->must_size,
+                                          ((struct lys_node_container *)node)->when);
+            break;
+        case LYS_LIST:
+            ret = lys_precompute_tpdfs(ctx, ((struct lys_node_list *)node)->tpdf, ((struct lys_node_list *)node)->tpdf_size)
+                  || lys_precompute_xpath(ctx, ((struct lys_node_list *)node)->must, ((struct lys_node_list *)node)->must_size,
+                                          ((struct lys_node_list *)node)->when);
+            break;
+        case LYS_LEAF:
+            ret = lys_precompute_type(ctx, &((struct lys_node_leaf *)node)->type)
+                  || lys_precompute_xpath(ctx, ((struct lys_node_leaf *)node)->must, ((struct lys_node_leaf *)node)->must_size,
+                                          ((struct lys_node_leaf *)node)->when);
+            break;
+        case LYS_LEAFLIST:
+            ret = lys_precompute_type(ctx, &((struct lys_node_leaflist *)node)->type)
+                  || lys_precompute_xpath(ctx, ((struct lys_node_leaflist *)node)->must,
+                                          ((struct lys_node_leaflist *)node)->must_size,
+                                          ((struct lys_node_leaflist *)node)->when);
+            break;
+        case LYS_ANYXML:
+        case LYS_ANYDATA:
+            ret = lys_precompute_xpath(ctx, ((struct lys_node_anydata *)node)->must,
+                                       ((struct lys_node_anydata *)node)->must_size, ((struct lys_node_anydata *)node)->when);
+            break;
+        case LYS_CHOICE:
+            ret = lys_precompute_xpath(ctx, NULL, 0, ((struct lys_node_choice *)node)->when);
+            break;
+        case LYS_CASE:
+            ret = lys_precompute_xpath(ctx, NULL, 0, ((struct lys_node_case *)node)->when);
+            break;
+        case LYS_USES:
+            ret = lys_precompute_xpath(ctx, NULL, 0, ((struct lys_node_uses *)node)->when);
+            break;
+        case LYS_INPUT:
+        case LYS_OUTPUT:
+            ret = lys_precompute_tpdfs(ctx, ((struct lys_node_inout *)node)->tpdf, ((struct lys_node_inout *)node)->tpdf_size)
+                  || lys_precompute_xpath(ctx, ((struct lys_node_inout *)node)->must,
+                                          ((struct lys_node_inout *)node)->must_size, NULL);
+            break;
+        case LYS_NOTIF:
+            ret = lys_precompute_tpdfs(ctx, ((struct lys_node_notif *)node)->tpdf, ((struct lys_node_notif *)node)->tpdf_size)
+                  || lys_precompute_xpath(ctx, ((struct lys_node_notif *)node)->must,
+                                          ((struct lys_node_notif *)node)->must_size, NULL);
+            break;
+        case LYS_RPC:
+        case LYS_ACTION:
+            ret = lys_precompute_tpdfs(ctx, ((struct lys_node_rpc_action *)node)->tpdf,
+                                       ((struct lys_node_rpc_action *)node)->tpdf_size);
+            break;
+        default:
+            ret = 0;
+            break;
+        }
+        if (ret) {
+            return -1;
+        }
+
+        if (!(node->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA)) && lys_precompute_siblings(ctx, node->child)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int
+lys_precompute(struct lys_module *module)
+{
+    struct ly_ctx *ctx = module->ctx;
+    int i, j;
+
+    for (i = -1; i < module->inc_size; ++i) {
+        if (i == -1) {
+            if (lys_precompute_tpdfs(ctx, module->tpdf, module->tpdf_size)) {
+                return -1;
+            }
+            for (j = 0; j < module->augment_size; ++j) {
+                if (lys_precompute_xpath(ctx, NULL, 0, module->augment[j].when)) {
+                    return -1;
+                }
+            }
+        } else {
+            if (lys_precompute_tpdfs(ctx, module->inc[i].submodule->tpdf, module->inc[i].submodule->tpdf_size)) {
+                return -1;
+            }
+            for (j = 0; j < module->inc[i].submodule->augment_size; ++j) {
+                if (lys_precompute_xpath(ctx, NULL, 0, module->inc[i].submodule->augment[j].when)) {
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return lys_precompute_siblings(ctx, module->data);
+}
+
 API const struct lys_node *
 lys_getnext(const struct lys_node *last, const struct lys_node *parent, const struct lys_module *module, int options)
 {
@@ -428,6 +1026,8 @@ lys_node_unlink(struct lys_node *node)
 
     /* unlink from data model if necessary */
     if (node->module) {
+        lys_child_index_invalidate(node->parent, lys_node_module(node));
+
         /* get main module with data tree */
         main_module = lys_node_module(node);
         if (main_module->data == node) {
@@ -781,6 +1381,7 @@ lys_node_addchild(struct lys_node *parent, struct lys_module *module, struct lys
     struct lyext_substmt *info = NULL;
 
     assert(child);
+    lys_child_index_invalidate(parent, module);
 
     if (parent) {
         type = parent->nodetype;
@@ -1052,6 +1653,7 @@ lys_parse_mem_(struct ly_ctx *ctx, const char *data, LYS_INFORMAT format, const
         LOGARG;
         return NULL;
     }
+    LY_CTX_CHECK_FROZEN(ctx, NULL);
 
     if (!internal && format == LYS_IN_YANG) {
         /* enlarge data by 2 bytes for flex */
@@ -1075,8 +1677,14 @@ lys_parse_mem_(struct ly_ctx *ctx, const char *data, LYS_INFORMAT format, const
         break;
     }
 
+    if (mod) {
+        ly_ctx_mod_src_add(mod, data, format);
+    }
     free(enlarged_data);
 
+    /* index the changed schema children once the (possibly failed) change is finished */
+    lys_child_index_update(ctx);
+
     /* hack for NETCONF's edit-config's operation attribute. It is not defined in the schema, but since libyang
      * implements YANG metadata (annotations), we need its definition. Because the ietf-netconf schema is not the
      * internal part of libyang, we cannot add the annotation into the schema source, but we do it here to have
@@ -1135,6 +1743,9 @@ lys_sub_parse_mem(struct lys_module *module, const char *data, LYS_INFORMAT form
         break;
     }
 
+    if (submod) {
+        ly_ctx_mod_src_add((struct lys_module *)submod, data, format);
+    }
     free(enlarged_data);
     return submod;
 }
@@ -1299,6 +1910,9 @@ lys_sub_parse_fd(struct lys_module *module, int fd, LYS_INFORMAT format, struct
         return NULL;
     }
 
+    if (submodule) {
+        ly_ctx_mod_src_add((struct lys_module *)submodule, addr, format);
+    }
     lyp_munmap(addr, length);
 
     if (submodule && !submodule->filepath) {
@@ -1807,21 +2421,8 @@ type_dup(struct lys_module *mod, struct lys_node *parent, struct lys_type *new,
         if (old->info.str.pat_count) {
             new->info.str.patterns = lys_restr_dup(mod, old->info.str.patterns, old->info.str.pat_count, shallow, unres);
             new->info.str.pat_count = old->info.str.pat_count;
-#ifdef LY_ENABLED_CACHE
-            if (!in_grp) {
-                new->info.str.patterns_pcre = malloc(new->info.str.pat_count * 2 * sizeof *new->info.str.patterns_pcre);
-                LY_CHECK_ERR_RETURN(!new->info.str.patterns_pcre, LOGMEM(mod->ctx), -1);
-                for (u = 0; u < new->info.str.pat_count; u++) {
-                    if (lyp_precompile_pattern(mod->ctx, &new->info.str.patterns[u].expr[1],
-                                              (pcre**)&new->info.str.patterns_pcre[2 * u],
-                                              (pcre_extra**)&new->info.str.patterns_pcre[2 * u + 1])) {
-                        free(new->info.str.patterns_pcre);
-                        new->info.str.patterns_pcre = NULL;
-                        return -1;
-                    }
-                }
-            }
-#endif
+            /* the copied patterns were already checked, they are compiled only when first used for validation,
+             * see lyp_precompile_type_patterns() */
         }
         break;
 
@@ -2348,21 +2949,18 @@ lys_type_free(struct ly_ctx *ctx, struct lys_type *type,
         break;
 
     case LY_TYPE_STRING:
+#ifdef LY_ENABLED_CACHE
+        /* the compiled patterns themselves are owned by the context pattern cache */
+        lyp_type_patterns_release(ctx, type);
+        free(type->info.str.patterns_pcre);
+        lyp_multi_pattern_forget(ctx, type);
+#endif
         lys_restr_free(ctx, type->info.str.length, private_destructor);
         free(type->info.str.length);
         for (i = 0; i < type->info.str.pat_count; i++) {
             lys_restr_free(ctx, &type->info.str.patterns[i], private_destructor);
-#ifdef LY_ENABLED_CACHE
-            if (type->info.str.patterns_pcre) {
-                pcre_free((pcre*)type->info.str.patterns_pcre[2 * i]);
-                pcre_free_study((pcre_extra*)type->info.str.patterns_pcre[2 * i + 1]);
-            }
-#endif
         }
         free(type->info.str.patterns);
-#ifdef LY_ENABLED_CACHE
-        free(type->info.str.patterns_pcre);
-#endif
         break;
 
     case LY_TYPE_UNION:
@@ -2370,6 +2968,9 @@ lys_type_free(struct ly_ctx *ctx, struct lys_type *type,
             lys_type_free(ctx, &type->info.uni.types[i], private_destructor);
         }
         free(type->info.uni.types);
+#ifdef LY_ENABLED_CACHE
+        lyp_multi_pattern_forget(ctx, type);
+#endif
         break;
 
     case LY_TYPE_IDENT:
@@ -2869,6 +3470,8 @@ lys_node_free(struct lys_node *node, void (*private_destructor)(const struct lys
 
     /* again common part */
     lys_node_unlink(node);
+    /* after the children were unlinked, the node may be indexed as a parent */
+    lys_child_index_remove(ctx, node);
     free(node);
 }
 
@@ -2913,6 +3516,9 @@ module_free_common(struct lys_module *module, void (*private_destructor)(const s
     assert(module->ctx);
     ctx = module->ctx;
 
+    /* source kept for the context images */
+    ly_ctx_mod_src_remove(module);
+
     /* just free the import array, imported modules will stay in the context */
     for (i = 0; i < module->imp_size; i++) {
         lydict_remove(ctx, module->imp[i].prefix);
@@ -3648,11 +4254,24 @@ lys_node_dup(struct lys_module *module, struct lys_node *parent, const struct ly
 static void
 lys_node_switch(struct lys_node *node1, struct lys_node *node2)
 {
-    const size_t mem_size = 104;
-    uint8_t mem[mem_size];
+    union {
+        struct lys_node_container cont;
+        struct lys_node_choice choic;
+        struct lys_node_leaf leaf;
+        struct lys_node_leaflist llist;
+        struct lys_node_list list;
+        struct lys_node_anydata any;
+        struct lys_node_case cs;
+        struct lys_node_inout inout;
+        struct lys_node_notif notif;
+        struct lys_node_rpc_action rpc;
+    } buf;
+    uint8_t *mem = (uint8_t *)&buf;
     size_t offset, size;
 
     assert((node1->module == node2->module) && ly_strequal(node1->name, node2->name, 1) && (node1->nodetype == node2->nodetype));
+    lys_child_index_invalidate(node1, NULL);
+    lys_child_index_invalidate(node2, NULL);
 
     /*
      * Initially, the nodes were really switched in the tree which
@@ -3756,7 +4375,16 @@ lys_node_switch(struct lys_node *node1, struct lys_node *node2)
         LOGINT(node1->module->ctx);
         return;
     }
-    assert(size <= mem_size);
+#ifdef LY_ENABLED_CACHE
+    /* the types are switched as well */
+    if (node1->nodetype == LYS_LEAF) {
+        lyp_multi_pattern_forget(node1->module->ctx, &((struct lys_node_leaf *)node1)->type);
+        lyp_multi_pattern_forget(node1->module->ctx, &((struct lys_node_leaf *)node2)->type);
+    } else if (node1->nodetype == LYS_LEAFLIST) {
+        lyp_multi_pattern_forget(node1->module->ctx, &((struct lys_node_leaflist *)node1)->type);
+        lyp_multi_pattern_forget(node1->module->ctx, &((struct lys_node_leaflist *)node2)->type);
+    }
+#endif
     memcpy(mem, ((uint8_t *)node1) + offset, size);
     memcpy(((uint8_t *)node1) + offset, ((uint8_t *)node2) + offset, size);
     memcpy(((uint8_t *)node2) + offset, mem, size);
@@ -3817,6 +4445,7 @@ lys_free(struct lys_module *module, void (*private_destructor)(const struct lys_
 
     /* remove schema from the context */
     ctx = module->ctx;
+    ly_ctx_mod_index_remove(module);
     if (remove_from_ctx && ctx->models.used) {
         for (i = 0; i < ctx->models.used; i++) {
             if (ctx->models.list[i] == module) {
@@ -3849,6 +4478,8 @@ lys_free(struct lys_module *module, void (*private_destructor)(const struct lys_
     /* specific items to free */
     lydict_remove(ctx, module->ns);
 
+    /* after all the data nodes were unlinked, the module may be indexed as a parent */
+    lys_child_index_remove(ctx, module);
     free(module);
 }
 
@@ -3889,6 +4520,7 @@ lys_features_change(const struct lys_module *module, const char *name, int op)
         LOGARG;
         return EXIT_FAILURE;
     }
+    LY_CTX_CHECK_FROZEN(module->ctx, EXIT_FAILURE);
 
     if (!strcmp(name, "*")) {
         /* enable all */
@@ -4332,7 +4964,8 @@ lys_node_xpath_atomize(const struct lys_node *node, int options)
 
     const struct lys_node *next, *elem, *parent, *tmp;
     struct lyxp_set set;
-    struct ly_set *ret_set;
+    struct ly_set_hashed *ret_set;
+    struct ly_set *plain_set;
     uint16_t i;
 
     if (!node) {
@@ -4346,7 +4979,8 @@ lys_node_xpath_atomize(const struct lys_node *node, int options)
         return NULL;
     }
 
-    ret_set = ly_set_new();
+    /* the dependencies of many nodes overlap, so deduplicate them using the hash index */
+    ret_set = ly_set_hashed_new();
     if (!ret_set) {
         return NULL;
     }
@@ -4358,7 +4992,7 @@ lys_node_xpath_atomize(const struct lys_node *node, int options)
         }
 
         if (lyxp_node_atomize(elem, &set, 0)) {
-            ly_set_free(ret_set);
+            ly_set_hashed_free(ret_set);
             free(set.val.snodes);
             return NULL;
         }
@@ -4373,8 +5007,8 @@ lys_node_xpath_atomize(const struct lys_node *node, int options)
                         break;
                     }
                 }
-                if (ly_set_add(ret_set, set.val.snodes[i].snode, 0) == -1) {
-                    ly_set_free(ret_set);
+                if (ly_set_hashed_add(ret_set, set.val.snodes[i].snode) == -1) {
+                    ly_set_hashed_free(ret_set);
                     free(set.val.snodes);
                     return NULL;
                 }
@@ -4393,7 +5027,13 @@ next_iter:
         LY_TREE_DFS_END(node, next, elem);
     }
 
-    return ret_set;
+    /* the caller gets a plain set it can freely modify */
+    plain_set = ly_set_new();
+    LY_CHECK_ERR_RETURN(!plain_set, ly_set_hashed_free(ret_set), NULL);
+    *plain_set = ret_set->set;
+    ret_set->set.set.g = NULL;
+    ly_set_hashed_free(ret_set);
+    return plain_set;
 }
 
 /* logs */
@@ -4469,6 +5109,7 @@ apply_aug(struct lys_node_augment *augment, struct unres_schema *unres)
     }
 
     /* reconnect augmenting data into the target - add them to the target child list */
+    lys_child_index_invalidate(augment->target, NULL);
     if (augment->target->child) {
         child = augment->target->child->prev;
         child->next = augment->child;
@@ -4502,6 +5143,7 @@ remove_aug(struct lys_node_augment *augment)
             }
         }
         /* elem is first augment child, last is the last child */
+        lys_child_index_invalidate(augment->target, NULL);
 
         /* parent child ptr */
         if (augment->target->child == elem) {
@@ -5026,6 +5668,7 @@ lys_set_implemented(const struct lys_module *module)
         LOGARG;
         return EXIT_FAILURE;
     }
+    LY_CTX_CHECK_FROZEN(module->ctx, EXIT_FAILURE);
 
     module = lys_main_module(module);
 
@@ -5061,6 +5704,7 @@ lys_set_implemented(const struct lys_module *module)
         goto error;
     }
     unres_schema_free(NULL, &unres, 0);
+    lys_child_index_update(module->ctx);
 
     LOGVRB("Module \"%s%s%s\" now implemented.", module->name, (module->rev_size ? "@" : ""),
            (module->rev_size ? module->rev[0].date : ""));
@@ -5074,6 +5718,7 @@ error:
 
     ((struct lys_module *)module)->implemented = 0;
     unres_schema_free((struct lys_module *)module, &unres, 1);
+    lys_child_index_update(module->ctx);
     return EXIT_FAILURE;
 }
 
@@ -334,7 +334,7 @@ lyv_data_unique(struct lyd_node *list)
                         /* unique item not present nor has default value */
                         break;
                     }
-                    hash = dict_hash_multi(hash, id, strlen(id));
+                    hash = lydict_hash_multi(hash, id);
                 }
                 if (!id) {
                     /* skip this list instance since its unique set is incomplete */
@@ -506,13 +506,13 @@ lyv_data_dup(struct lyd_node *node, struct lyd_node *start)
             /* get the hash for the instance - keys */
             if (node->schema->nodetype == LYS_LEAFLIST) {
                 id = ((struct lyd_node_leaf_list *)set->set.d[u])->value_str;
-                hash = dict_hash_multi(0, id, strlen(id));
+                hash = lydict_hash_multi(0, id);
             } else { /* LYS_LIST */
                 for (hash = i = 0, key = set->set.d[u]->child;
                         i < ((struct lys_node_list *)set->set.d[u]->schema)->keys_size;
                         i++, key = key->next) {
                     id = ((struct lyd_node_leaf_list *)key)->value_str;
-                    hash = dict_hash_multi(hash, id, strlen(id));
+                    hash = lydict_hash_multi(hash, id);
                 }
             }
             /* finish the hash value */
@@ -355,8 +355,8 @@ lyxml_free_attr(struct ly_ctx *ctx, struct lyxml_elem *parent, struct lyxml_attr
             aprev->next = attr->next;
         }
     }
-    lydict_remove(ctx, attr->name);
-    lydict_remove(ctx, attr->value);
+    lydict_unref(ctx, attr->name);
+    lydict_unref(ctx, attr->value);
     free(attr);
 }
 
@@ -372,8 +372,8 @@ lyxml_free_attrs(struct ly_ctx *ctx, struct lyxml_elem *elem)
     do {
         next = a->next;
 
-        lydict_remove(ctx, a->name);
-        lydict_remove(ctx, a->value);
+        lydict_unref(ctx, a->name);
+        lydict_unref(ctx, a->value);
         free(a);
 
         a = next;
@@ -393,8 +393,8 @@ lyxml_free_elem(struct ly_ctx *ctx, struct lyxml_elem *elem)
     LY_TREE_FOR_SAFE(elem->child, next, e) {
         lyxml_free_elem(ctx, e);
     }
-    lydict_remove(ctx, elem->name);
-    lydict_remove(ctx, elem->content);
+    lydict_unref(ctx, elem->name);
+    lydict_unref(ctx, elem->content);
     free(elem);
 }
 
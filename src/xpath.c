@@ -47,6 +47,7 @@ static int reparse_or_expr(struct ly_ctx *ctx, struct lyxp_expr *exp, uint16_t *
 static int set_snode_insert_node(struct lyxp_set *set, const struct lys_node *node, enum lyxp_node_type node_type);
 static int eval_expr_select(struct lyxp_expr *exp, uint16_t *exp_idx, enum lyxp_expr_type etype, struct lyd_node *cur_node,
                             struct lys_module *local_mod, struct lyxp_set *set, int options);
+static int eval_number(struct ly_ctx *ctx, struct lyxp_expr *exp, uint16_t *exp_idx, struct lyxp_set *set);
 
 void
 lyxp_expr_free(struct lyxp_expr *expr)
@@ -757,7 +758,7 @@ static struct lyxp_set *
 set_copy(struct lyxp_set *set)
 {
     struct lyxp_set *ret;
-    uint16_t i;
+    uint32_t i;
 
     if (!set) {
         return NULL;
@@ -881,8 +882,8 @@ set_fill_set(struct lyxp_set *trg, struct lyxp_set *src)
     } else if (src->type == LYXP_SET_STRING) {
         set_fill_string(trg, src->val.str, strlen(src->val.str));
     } else {
-        if (trg->type == LYXP_SET_NODE_SET) {
-            free(trg->val.nodes);
+        if ((trg->type == LYXP_SET_NODE_SET) && ((src->type == LYXP_SET_EMPTY) || (trg->size < src->used))) {
+            set_free_content(trg);
         } else if (trg->type == LYXP_SET_STRING) {
             free(trg->val.str);
         }
@@ -892,22 +893,28 @@ set_fill_set(struct lyxp_set *trg, struct lyxp_set *src)
         } else {
             assert(src->type == LYXP_SET_NODE_SET);
 
+            if (trg->type == LYXP_SET_NODE_SET) {
+                /* the node array is large enough, reuse it */
+#ifdef LY_ENABLED_CACHE
+                lyht_free(trg->ht);
+#endif
+            } else {
+                trg->val.nodes = malloc(src->used * sizeof *trg->val.nodes);
+                LY_CHECK_ERR_RETURN(!trg->val.nodes, LOGMEM(NULL); memset(trg, 0, sizeof *trg), );
+                trg->size = src->used;
+            }
+
             trg->type = LYXP_SET_NODE_SET;
             trg->used = src->used;
-            trg->size = src->used;
             trg->ctx_pos = src->ctx_pos;
             trg->ctx_size = src->ctx_size;
 
-            trg->val.nodes = malloc(trg->used * sizeof *trg->val.nodes);
-            LY_CHECK_ERR_RETURN(!trg->val.nodes, LOGMEM(NULL); memset(trg, 0, sizeof *trg), );
             memcpy(trg->val.nodes, src->val.nodes, src->used * sizeof *src->val.nodes);
 #ifdef LY_ENABLED_CACHE
             trg->ht = lyht_dup(src->ht);
 #endif
         }
     }
-
-
 }
 
 static void
@@ -960,7 +967,7 @@ set_remove_node(struct lyxp_set *set, uint32_t idx)
 static void
 set_remove_none_nodes(struct lyxp_set *set)
 {
-    uint16_t i, orig_used, end = 0;
+    uint32_t i, orig_used, end = 0;
     int32_t start;
 
     assert(set && (set->type == LYXP_SET_NODE_SET));
@@ -1519,6 +1526,94 @@ set_comp_cast(struct lyxp_set *trg, struct lyxp_set *src, enum lyxp_set_type typ
     return EXIT_SUCCESS;
 }
 
+/**
+ * @brief Get the leaf of a node set item whose value can be used directly for a comparison,
+ *        without casting the node into a string first.
+ *
+ * @param[in] item Node set item.
+ * @param[in] cur_node Original context node.
+ * @param[in] options Whether to apply data node access restrictions defined for 'when' and 'must' evaluation.
+ *
+ * @return Leaf (-list) data node, NULL if the item must be cast.
+ */
+static const struct lyd_node_leaf_list *
+set_comp_typed_leaf(const struct lyxp_set_node *item, const struct lyd_node *cur_node, int options)
+{
+    if ((item->type != LYXP_NODE_ELEM) || !(item->node->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST))
+            || (item->node->validity & LYD_VAL_INUSE)) {
+        /* dummy nodes are handled (refused) when cast */
+        return NULL;
+    }
+    if (options && cur_node && (cur_node->schema->flags & LYS_CONFIG_W) && (item->node->schema->flags & LYS_CONFIG_R)) {
+        /* state node from the config root is cast into an empty string */
+        return NULL;
+    }
+
+    return (const struct lyd_node_leaf_list *)item->node;
+}
+
+/**
+ * @brief Get the value of a node set item directly from its typed leaf value. Handles numeric types,
+ *        everything else must be cast.
+ *
+ * @param[in] item Node set item.
+ * @param[in] cur_node Original context node.
+ * @param[in] options Whether to apply data node access restrictions defined for 'when' and 'must' evaluation.
+ * @param[out] num Value of the item as a number.
+ *
+ * @return 1 if \p num was filled, 0 if the item must be cast.
+ */
+static int
+set_comp_typed_number(const struct lyxp_set_node *item, const struct lyd_node *cur_node, int options, long double *num)
+{
+    const struct lyd_node_leaf_list *leaf;
+    const struct lys_type *type;
+
+    leaf = set_comp_typed_leaf(item, cur_node, options);
+    if (!leaf || !leaf->value_str || (leaf->value_flags & (LY_VALUE_UNRES | LY_VALUE_USER))) {
+        return 0;
+    }
+
+    switch (leaf->value_type) {
+    case LY_TYPE_INT8:
+        *num = leaf->value.int8;
+        break;
+    case LY_TYPE_INT16:
+        *num = leaf->value.int16;
+        break;
+    case LY_TYPE_INT32:
+        *num = leaf->value.int32;
+        break;
+    case LY_TYPE_INT64:
+        *num = leaf->value.int64;
+        break;
+    case LY_TYPE_UINT8:
+        *num = leaf->value.uint8;
+        break;
+    case LY_TYPE_UINT16:
+        *num = leaf->value.uint16;
+        break;
+    case LY_TYPE_UINT32:
+        *num = leaf->value.uint32;
+        break;
+    case LY_TYPE_UINT64:
+        *num = leaf->value.uint64;
+        break;
+    case LY_TYPE_DEC64:
+        /* fraction digits are known only for a direct decimal64 type, not a union member */
+        type = &((struct lys_node_leaf *)leaf->schema)->type;
+        if (type->base != LY_TYPE_DEC64) {
+            return 0;
+        }
+        *num = (long double)leaf->value.dec64 / dec_pow(type->info.dec64.dig);
+        break;
+    default:
+        return 0;
+    }
+
+    return 1;
+}
+
 #ifndef NDEBUG
 
 /**
@@ -2919,6 +3014,139 @@ error:
     return NULL;
 }
 
+/**
+ * @brief Context cache of compiled XPath expressions.
+ *
+ * Only the expressions of the schemas (must and when) are stored and it is filled only while
+ * the schemas are being compiled or the context frozen, which is never done concurrently with
+ * any other work in the context. Evaluations then only look the expressions up without any
+ * locking, their tokens and repeat information are never modified by an evaluation so a single
+ * compiled expression can be evaluated concurrently by any number of threads. Any other
+ * expressions are compiled for every evaluation and the cache is thus bounded by the loaded schemas.
+ */
+struct lyxp_expr_cache {
+    struct hash_table *hash_tab; /* compiled expressions (struct lyxp_expr *) keyed by their string */
+};
+
+static int
+lyxp_expr_cache_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lyxp_expr *exp1 = *(struct lyxp_expr **)val1_p, *exp2 = *(struct lyxp_expr **)val2_p;
+
+    return !strcmp(exp1->expr, exp2->expr);
+}
+
+struct lyxp_expr_cache *
+lyxp_expr_cache_new(void)
+{
+    struct lyxp_expr_cache *cache;
+
+    cache = calloc(1, sizeof *cache);
+    LY_CHECK_ERR_RETURN(!cache, LOGMEM(NULL), NULL);
+
+    cache->hash_tab = lyht_new(256, sizeof(struct lyxp_expr *), lyxp_expr_cache_equal, NULL, 1);
+    LY_CHECK_ERR_RETURN(!cache->hash_tab, LOGMEM(NULL); free(cache), NULL);
+
+    return cache;
+}
+
+void
+lyxp_expr_cache_free(struct lyxp_expr_cache *cache)
+{
+    struct ht_rec *rec;
+    uint32_t i;
+
+    if (!cache) {
+        return;
+    }
+
+    for (i = 0; i < cache->hash_tab->size; ++i) {
+        rec = lyht_get_rec(cache->hash_tab->recs, cache->hash_tab->rec_size, i);
+        if (rec->hits > 0) {
+            lyxp_expr_free(*(struct lyxp_expr **)&rec->val);
+        }
+    }
+    lyht_free(cache->hash_tab);
+    free(cache);
+}
+
+/**
+ * @brief Get a compiled XPath expression from the context cache, parse and reparse it only
+ * if it is not there. Logs directly.
+ *
+ * @param[in] ctx Context with the compiled expression cache.
+ * @param[in] expr XPath expression to compile.
+ * @param[in] store Whether to store a newly compiled expression in the cache. Allowed only
+ * for schema expressions while the schemas are being modified.
+ * @param[out] dynamic Set if the returned expression is not shared and must be freed.
+ * @return Compiled expression, NULL on error.
+ */
+static struct lyxp_expr *
+lyxp_expr_compile(struct ly_ctx *ctx, const char *expr, int store, int *dynamic)
+{
+    struct lyxp_expr_cache *cache = ctx->xpath_cache;
+    struct lyxp_expr *exp, key, *key_p = &key, **match;
+    uint16_t exp_idx = 0;
+    uint32_t hash;
+
+    *dynamic = 1;
+    hash = dict_hash_multi(0, expr, strlen(expr));
+    hash = dict_hash_multi(hash, NULL, 0);
+    key.expr = (char *)expr;
+
+    if (cache && !lyht_find(cache->hash_tab, &key_p, hash, (void **)&match)) {
+        *dynamic = 0;
+        return *match;
+    }
+
+    exp = lyxp_parse_expr(ctx, expr);
+    if (!exp) {
+        return NULL;
+    }
+
+    if (reparse_or_expr(ctx, exp, &exp_idx)) {
+        lyxp_expr_free(exp);
+        return NULL;
+    } else if (exp->used > exp_idx) {
+        LOGVAL(ctx, LYE_XPATH_INTOK, LY_VLOG_NONE, NULL, "Unknown", &exp->expr[exp->expr_pos[exp_idx]]);
+        LOGVAL(ctx, LYE_SPEC, LY_VLOG_NONE, NULL, "Unparsed characters \"%s\" left at the end of an XPath expression.",
+               &exp->expr[exp->expr_pos[exp_idx]]);
+        lyxp_expr_free(exp);
+        return NULL;
+    }
+
+    print_expr_struct_debug(exp);
+
+    if (cache && store) {
+        if (lyht_insert(cache->hash_tab, &exp, hash, NULL) == -1) {
+            LOGINT(ctx);
+            lyxp_expr_free(exp);
+            return NULL;
+        }
+        *dynamic = 0;
+    }
+
+    return exp;
+}
+
+int
+lyxp_expr_precompile(struct ly_ctx *ctx, const char *expr)
+{
+    struct lyxp_expr *exp;
+    int dynamic;
+
+    exp = lyxp_expr_compile(ctx, expr, 1, &dynamic);
+    if (!exp) {
+        return -1;
+    }
+    assert(!dynamic || !ctx->xpath_cache);
+    if (dynamic) {
+        lyxp_expr_free(exp);
+    }
+
+    return 0;
+}
+
 /*
  * warn functions
  *
@@ -5618,7 +5846,7 @@ moveto_node(struct lyxp_set *set, struct lyd_node *cur_node, const char *qname,
                     }
                     ++i;
                 } else if (ret == EXIT_FAILURE) {
-                    lydict_remove(ctx, name_dict);
+                    lydict_unref(ctx, name_dict);
                     return EXIT_FAILURE;
                 }
             }
@@ -5638,7 +5866,7 @@ moveto_node(struct lyxp_set *set, struct lyd_node *cur_node, const char *qname,
                     }
                     ++i;
                 } else if (ret == EXIT_FAILURE) {
-                    lydict_remove(ctx, name_dict);
+                    lydict_unref(ctx, name_dict);
                     return EXIT_FAILURE;
                 }
             }
@@ -5649,7 +5877,7 @@ moveto_node(struct lyxp_set *set, struct lyd_node *cur_node, const char *qname,
             set_remove_node(set, i);
         }
     }
-    lydict_remove(ctx, name_dict);
+    lydict_unref(ctx, name_dict);
 
     return EXIT_SUCCESS;
 }
@@ -5767,7 +5995,7 @@ get_next_augment:
             }
         }
     }
-    lydict_remove(ctx, name_dict);
+    lydict_unref(ctx, name_dict);
 
     /* correct temporary in_ctx values */
     if (temp_ctx) {
@@ -6756,6 +6984,8 @@ moveto_op_comp(struct lyxp_set *set1, struct lyxp_set *set2, const char *op, str
     struct lyxp_set iter1, iter2;
     int result;
     int64_t i;
+    long double num;
+    const struct lyd_node_leaf_list *leaf;
 
     iter1.type = LYXP_SET_EMPTY;
 
@@ -6775,9 +7005,21 @@ moveto_op_comp(struct lyxp_set *set1, struct lyxp_set *set2, const char *op, str
                 }
             }
             for (i = 0; i < set1->used; ++i) {
+                if ((set2->type == LYXP_SET_STRING) && ((op[0] == '=') || (op[0] == '!'))
+                        && (leaf = set_comp_typed_leaf(&set1->val.nodes[i], cur_node, options))) {
+                    /* the string value of a leaf is its value_str, compare it directly */
+                    if (ly_strequal(leaf->value_str ? leaf->value_str : "", set2->val.str, 0) == (op[0] == '=')) {
+                        set_fill_boolean(set1, 1);
+                        return EXIT_SUCCESS;
+                    }
+                    continue;
+                }
+
                 switch (set2->type) {
                 case LYXP_SET_NUMBER:
-                    if (set_comp_cast(&iter1, set1, LYXP_SET_NUMBER, cur_node, local_mod, i, options)) {
+                    if (set_comp_typed_number(&set1->val.nodes[i], cur_node, options, &num)) {
+                        set_fill_number(&iter1, num);
+                    } else if (set_comp_cast(&iter1, set1, LYXP_SET_NUMBER, cur_node, local_mod, i, options)) {
                         return -1;
                     }
                     break;
@@ -6812,7 +7054,10 @@ moveto_op_comp(struct lyxp_set *set1, struct lyxp_set *set2, const char *op, str
             for (i = 0; i < set2->used; ++i) {
                 switch (set1->type) {
                     case LYXP_SET_NUMBER:
-                        if (set_comp_cast(&iter2, set2, LYXP_SET_NUMBER, cur_node, local_mod, i, options)) {
+                        if (set_comp_typed_number(&set2->val.nodes[i], cur_node, options, &num)) {
+                            iter2.type = LYXP_SET_EMPTY;
+                            set_fill_number(&iter2, num);
+                        } else if (set_comp_cast(&iter2, set2, LYXP_SET_NUMBER, cur_node, local_mod, i, options)) {
                             return -1;
                         }
                         break;
@@ -7159,9 +7404,9 @@ static int
 eval_predicate(struct lyxp_expr *exp, uint16_t *exp_idx, struct lyd_node *cur_node, struct lys_module *local_mod,
                struct lyxp_set *set, int options, int parent_pos_pred)
 {
-    int ret;
-    uint16_t i, orig_exp;
-    uint32_t orig_pos, orig_size, pred_in_ctx;
+    int ret, satisfied;
+    uint16_t orig_exp;
+    uint32_t i, orig_pos, orig_size, pred_in_ctx;
     struct lyxp_set set2;
     struct lyd_node *orig_parent;
 
@@ -7189,9 +7434,52 @@ only_parse:
         orig_pos = 0;
         orig_size = set->used;
         orig_parent = NULL;
-        for (i = 0; i < set->used; ++i) {
+
+        if ((exp->tokens[*exp_idx] == LYXP_TOKEN_NUMBER) && !exp->repeat[*exp_idx]
+                && (exp->tokens[*exp_idx + 1] == LYXP_TOKEN_BRACK2)) {
+            /* positional predicate, it can be decided for the whole set at once without evaluating it per node */
             memset(&set2, 0, sizeof set2);
-            set_insert_node(&set2, set->val.nodes[i].node, set->val.nodes[i].pos, set->val.nodes[i].type, 0);
+            if (eval_number(local_mod->ctx, exp, exp_idx, &set2)) {
+                return -1;
+            }
+
+            for (i = 0; i < set->used; ++i) {
+                if (parent_pos_pred && (set->val.nodes[i].node->parent != orig_parent)) {
+                    orig_parent = set->val.nodes[i].node->parent;
+                    orig_pos = 1;
+                } else {
+                    ++orig_pos;
+                }
+
+                if ((long long)set2.val.num != orig_pos) {
+#ifdef LY_ENABLED_CACHE
+                    set_remove_node_hash(set, set->val.nodes[i].node, set->val.nodes[i].type);
+#endif
+                    set->val.nodes[i].type = LYXP_NODE_NONE;
+                }
+            }
+            set_free_content(&set2);
+            set_remove_none_nodes(set);
+            goto finish;
+        }
+
+        /* one scratch set is reused for all the nodes, its node array is allocated only once */
+        memset(&set2, 0, sizeof set2);
+        for (i = 0; i < set->used; ++i) {
+            if ((set2.type == LYXP_SET_NODE_SET) && set2.size) {
+#ifdef LY_ENABLED_CACHE
+                lyht_free(set2.ht);
+                set2.ht = NULL;
+#endif
+                set2.val.nodes[0].node = set->val.nodes[i].node;
+                set2.val.nodes[0].type = set->val.nodes[i].type;
+                set2.val.nodes[0].pos = set->val.nodes[i].pos;
+                set2.used = 1;
+            } else {
+                set_free_content(&set2);
+                memset(&set2, 0, sizeof set2);
+                set_insert_node(&set2, set->val.nodes[i].node, set->val.nodes[i].pos, set->val.nodes[i].type, 0);
+            }
             /* remember the node context position for position() and context size for last(),
              * predicates should always be evaluated with respect to the child axis (since we do
              * not support explicit axes) so we assign positions based on their parents */
@@ -7220,16 +7508,22 @@ only_parse:
                     set2.val.num = 0;
                 }
             }
-            lyxp_set_cast(&set2, LYXP_SET_BOOLEAN, cur_node, local_mod, options);
 
-            /* predicate satisfied or not? */
-            if (!set2.val.bool) {
+            /* predicate satisfied or not? (a node set is kept as it is so that its array can be reused) */
+            if (set2.type == LYXP_SET_NODE_SET) {
+                satisfied = (set2.used ? 1 : 0);
+            } else {
+                lyxp_set_cast(&set2, LYXP_SET_BOOLEAN, cur_node, local_mod, options);
+                satisfied = set2.val.bool;
+            }
+            if (!satisfied) {
 #ifdef LY_ENABLED_CACHE
                 set_remove_node_hash(set, set->val.nodes[i].node, set->val.nodes[i].type);
 #endif
                 set->val.nodes[i].type = LYXP_NODE_NONE;
             }
         }
+        set_free_content(&set2);
 
         /* now actually remove all nodes that have not satisfied the predicate */
         set_remove_none_nodes(set);
@@ -7294,6 +7588,7 @@ only_parse:
         lyxp_set_cast(&set2, LYXP_SET_EMPTY, cur_node, local_mod, options);
     }
 
+finish:
     /* ']' */
     assert(exp->tokens[*exp_idx] == LYXP_TOKEN_BRACK2);
     LOGDBG(LY_LDGXPATH, "%-27s %s %s[%u]", __func__, (set ? "parsed" : "skipped"),
@@ -8580,7 +8875,7 @@ lyxp_eval(const char *expr, const struct lyd_node *cur_node, enum lyxp_node_type
     struct ly_ctx *ctx;
     struct lyxp_expr *exp;
     uint16_t exp_idx = 0;
-    int rc = -1;
+    int rc = -1, dynamic;
 
     if (!expr || !local_mod || !set) {
         LOGARG;
@@ -8589,25 +8884,11 @@ lyxp_eval(const char *expr, const struct lyd_node *cur_node, enum lyxp_node_type
 
     ctx = local_mod->ctx;
 
-    exp = lyxp_parse_expr(ctx, expr);
+    exp = lyxp_expr_compile(ctx, expr, 0, &dynamic);
     if (!exp) {
-        rc = -1;
-        goto finish;
-    }
-
-    rc = reparse_or_expr(ctx, exp, &exp_idx);
-    if (rc) {
-        goto finish;
-    } else if (exp->used > exp_idx) {
-        LOGVAL(ctx, LYE_XPATH_INTOK, LY_VLOG_NONE, NULL, "Unknown", &exp->expr[exp->expr_pos[exp_idx]]);
-        LOGVAL(ctx, LYE_SPEC, LY_VLOG_NONE, NULL, "Unparsed characters \"%s\" left at the end of an XPath expression.",
-               &exp->expr[exp->expr_pos[exp_idx]]);
-        rc = -1;
-        goto finish;
+        return -1;
     }
 
-    print_expr_struct_debug(exp);
-
     exp_idx = 0;
     memset(set, 0, sizeof *set);
     set->type = LYXP_SET_EMPTY;
@@ -8624,11 +8905,438 @@ lyxp_eval(const char *expr, const struct lyd_node *cur_node, enum lyxp_node_type
         lyxp_set_cast(set, LYXP_SET_EMPTY, cur_node, local_mod, options);
     }
 
-finish:
-    lyxp_expr_free(exp);
+    if (dynamic) {
+        lyxp_expr_free(exp);
+    }
     return rc;
 }
 
+/*
+ * lazy evaluation iterator
+ *
+ * Simple location paths are evaluated step by step on the data tree and
+ * every match is returned as soon as it is found, other expressions are
+ * evaluated at once and their result is only traversed.
+ */
+
+/**
+ * @brief Resolve the name test of a lazily evaluated step.
+ *
+ * @param[in] iter Iterator to use.
+ * @param[in] step Step to fill.
+ * @param[in] name_idx Index of the name test token.
+ *
+ * @return EXIT_SUCCESS on success, -1 on error.
+ */
+static int
+iter_step_resolve(struct lyd_find_iter *iter, struct lyd_find_iter_step *step, uint16_t name_idx)
+{
+    struct ly_ctx *ctx = iter->local_mod->ctx;
+    const char *qname, *ptr;
+    uint16_t qname_len;
+    int pref_len;
+
+    qname = &iter->exp->expr[iter->exp->expr_pos[name_idx]];
+    qname_len = iter->exp->tok_len[name_idx];
+
+    if ((ptr = strnchr(qname, ':', qname_len))) {
+        pref_len = ptr - qname;
+        step->mod = moveto_resolve_model(qname, pref_len, ctx, NULL, 1, 0);
+        if (!step->mod) {
+            LOGVAL(ctx, LYE_XPATH_INMOD, LY_VLOG_NONE, NULL, pref_len, qname);
+            return -1;
+        }
+        qname += pref_len + 1;
+        qname_len -= pref_len + 1;
+    } else if (step->all_desc || ((qname[0] == '*') && (qname_len == 1))) {
+        /* the module of the context node is checked for every node when searching all the descendants */
+        step->mod = NULL;
+    } else {
+        step->mod = lyd_node_module(iter->cur_node);
+    }
+
+    step->any_name = ((qname_len == 1) && (qname[0] == '*'));
+    step->name = lydict_insert(ctx, qname, qname_len);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Prepare lazy evaluation of \p iter expression, if possible.
+ *
+ * It is possible for a sequence of name test steps with predicates, only the last step can search all the
+ * descendants (otherwise the results are not guaranteed to be generated in the document order without duplicates).
+ *
+ * @param[in] iter Iterator to use.
+ *
+ * @return 1 if the expression can be evaluated lazily, 0 if not, -1 on error.
+ */
+static int
+iter_prepare(struct lyd_find_iter *iter)
+{
+    struct lyxp_expr *exp = iter->exp;
+    struct lyd_find_iter_step *step;
+    uint16_t exp_idx = 0, name_idx, i;
+    int all_desc = 0;
+    void *mem;
+
+    if (exp->repeat[0]) {
+        /* operators on the top level */
+        return 0;
+    }
+
+    if (exp->tokens[0] == LYXP_TOKEN_OPERATOR_PATH) {
+        iter->absolute = 1;
+        all_desc = (exp->tok_len[0] == 2);
+        ++exp_idx;
+    }
+
+    while (exp_idx < exp->used) {
+        if (exp->tokens[exp_idx] != LYXP_TOKEN_NAMETEST) {
+            return 0;
+        }
+        name_idx = exp_idx++;
+
+        mem = ly_realloc(iter->steps, (iter->step_count + 1) * sizeof *iter->steps);
+        LY_CHECK_ERR_RETURN(!mem, LOGMEM(iter->local_mod->ctx), -1);
+        iter->steps = mem;
+        step = &iter->steps[iter->step_count];
+        memset(step, 0, sizeof *step);
+        ++iter->step_count;
+
+        step->all_desc = all_desc;
+        if (iter_step_resolve(iter, step, name_idx)) {
+            return -1;
+        }
+
+        /* predicates */
+        if ((exp_idx < exp->used) && (exp->tokens[exp_idx] == LYXP_TOKEN_BRACK1)) {
+            step->pred_idx = exp_idx;
+        }
+        while ((exp_idx < exp->used) && (exp->tokens[exp_idx] == LYXP_TOKEN_BRACK1)) {
+            for (i = exp_idx + 1; exp->tokens[i] != LYXP_TOKEN_BRACK2; ++i) {
+                if ((exp->tokens[i] == LYXP_TOKEN_FUNCNAME) && (exp->tok_len[i] == 4)
+                        && !strncmp(&exp->expr[exp->expr_pos[i]], "last", 4)) {
+                    /* context size is not known in advance */
+                    return 0;
+                }
+            }
+            if (eval_predicate(exp, &exp_idx, iter->cur_node, iter->local_mod, NULL, 0, 1)) {
+                return -1;
+            }
+            ++step->pred_count;
+        }
+
+        if (step->pred_count) {
+            step->pred_parent = calloc(step->pred_count, sizeof *step->pred_parent);
+            step->pred_pos = calloc(step->pred_count, sizeof *step->pred_pos);
+            LY_CHECK_ERR_RETURN(!step->pred_parent || !step->pred_pos, LOGMEM(iter->local_mod->ctx), -1);
+        }
+
+        if (exp_idx == exp->used) {
+            break;
+        }
+        if ((exp->tokens[exp_idx] != LYXP_TOKEN_OPERATOR_PATH) || all_desc) {
+            /* another operator or a step after '//' */
+            return 0;
+        }
+        all_desc = (exp->tok_len[exp_idx] == 2);
+        ++exp_idx;
+    }
+
+    if (!iter->step_count || (exp_idx < exp->used)) {
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Get the next candidate node of a lazily evaluated step, in the document order.
+ *
+ * @param[in] iter Iterator to use.
+ * @param[in] step_idx Index of the step.
+ *
+ * @return Next candidate node, NULL if there are no more.
+ */
+static struct lyd_node *
+iter_step_next(struct lyd_find_iter *iter, uint16_t step_idx)
+{
+    struct lyd_find_iter_step *step = &iter->steps[step_idx];
+    struct lyd_node *base, *elem;
+    enum lyxp_node_type root_type;
+
+    /* node whose children/descendants are traversed, NULL for the root */
+    if (step_idx) {
+        base = iter->steps[step_idx - 1].node;
+    } else if (iter->absolute) {
+        base = NULL;
+    } else {
+        base = iter->cur_node;
+    }
+
+    if (!step->node) {
+        /* first candidate */
+        if (!base) {
+            return (struct lyd_node *)moveto_get_root(iter->cur_node, 0, &root_type);
+        }
+        if ((base->validity & LYD_VAL_INUSE) || (base->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA))) {
+            return NULL;
+        }
+        return base->child;
+    }
+
+    elem = step->node;
+    if (step->all_desc && !(elem->validity & LYD_VAL_INUSE)
+            && !(elem->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA)) && elem->child) {
+        /* children first */
+        return elem->child;
+    }
+
+    if (step->all_desc) {
+        /* no children, go back through the parents */
+        while (!elem->next) {
+            if (elem->parent == base) {
+                return NULL;
+            }
+            elem = elem->parent;
+        }
+    }
+    return elem->next;
+}
+
+/**
+ * @brief Check whether a candidate node matches the name test of a lazily evaluated step.
+ *
+ * @param[in] iter Iterator to use.
+ * @param[in] step Step to use.
+ * @param[in] node Candidate node.
+ *
+ * @return 1 on match, 0 otherwise.
+ */
+static int
+iter_step_match_name(struct lyd_find_iter *iter, struct lyd_find_iter_step *step, struct lyd_node *node)
+{
+    if (step->all_desc) {
+        /* see moveto_node_alldesc() */
+        if (node->validity & LYD_VAL_INUSE) {
+            return 0;
+        }
+        if (!step->any_name) {
+            if (step->mod && (lys_node_module(node->schema) != step->mod)) {
+                return 0;
+            } else if (!step->mod && (lys_node_module(node->schema) != lyd_node_module(iter->cur_node))) {
+                return 0;
+            }
+            if (!ly_strequal(node->schema->name, step->name, 1)) {
+                return 0;
+            }
+        }
+        return 1;
+    }
+
+    return (moveto_node_check(node, LYXP_NODE_ROOT, step->name, step->mod, 0) ? 0 : 1);
+}
+
+/**
+ * @brief Evaluate the predicates of a lazily evaluated step on a candidate node.
+ *
+ * @param[in] iter Iterator to use.
+ * @param[in] step Step to use.
+ * @param[in] node Candidate node.
+ *
+ * @return 1 if all the predicates are satisfied, 0 if not, -1 on error.
+ */
+static int
+iter_step_match_pred(struct lyd_find_iter *iter, struct lyd_find_iter_step *step, struct lyd_node *node)
+{
+    struct lyxp_set set;
+    uint16_t exp_idx, i;
+    int satisfied = 1;
+
+    exp_idx = step->pred_idx;
+    for (i = 0; i < step->pred_count; ++i) {
+        /* context position is relative to the parent, as in eval_predicate() */
+        if (node->parent != step->pred_parent[i]) {
+            step->pred_parent[i] = node->parent;
+            step->pred_pos[i] = 1;
+        } else {
+            ++step->pred_pos[i];
+        }
+
+        /* '[' */
+        ++exp_idx;
+
+        memset(&set, 0, sizeof set);
+        set_insert_node(&set, node, 0, LYXP_NODE_ELEM, 0);
+        set.ctx_pos = step->pred_pos[i];
+        set.ctx_size = step->pred_pos[i];
+        if (eval_expr_select(iter->exp, &exp_idx, 0, iter->cur_node, iter->local_mod, &set, 0)) {
+            lyxp_set_cast(&set, LYXP_SET_EMPTY, iter->cur_node, iter->local_mod, 0);
+            return -1;
+        }
+
+        /* number is a position */
+        if (set.type == LYXP_SET_NUMBER) {
+            satisfied = ((long long)set.val.num == step->pred_pos[i]);
+        } else {
+            lyxp_set_cast(&set, LYXP_SET_BOOLEAN, iter->cur_node, iter->local_mod, 0);
+            satisfied = set.val.bool;
+        }
+        lyxp_set_cast(&set, LYXP_SET_EMPTY, iter->cur_node, iter->local_mod, 0);
+
+        if (!satisfied) {
+            /* the following predicates are evaluated only for the nodes satisfying this one */
+            break;
+        }
+
+        /* ']' */
+        assert(iter->exp->tokens[exp_idx] == LYXP_TOKEN_BRACK2);
+        ++exp_idx;
+    }
+
+    return satisfied;
+}
+
+struct lyd_find_iter *
+lyxp_iter_new(const char *expr, const struct lyd_node *cur_node, const struct lys_module *local_mod)
+{
+    struct lyd_find_iter *iter;
+    uint16_t exp_idx = 0;
+    int ret;
+
+    if (!cur_node || !local_mod) {
+        LOGARG;
+        return NULL;
+    }
+
+    iter = calloc(1, sizeof *iter);
+    LY_CHECK_ERR_RETURN(!iter, LOGMEM(local_mod->ctx), NULL);
+    iter->cur_node = (struct lyd_node *)cur_node;
+    iter->local_mod = (struct lys_module *)local_mod;
+
+    if (!expr) {
+        /* nothing can match */
+        return iter;
+    }
+
+    iter->exp = lyxp_parse_expr(local_mod->ctx, expr);
+    if (!iter->exp) {
+        goto error;
+    }
+
+    if (reparse_or_expr(local_mod->ctx, iter->exp, &exp_idx)) {
+        goto error;
+    } else if (iter->exp->used > exp_idx) {
+        LOGVAL(local_mod->ctx, LYE_XPATH_INTOK, LY_VLOG_NONE, NULL, "Unknown", &iter->exp->expr[iter->exp->expr_pos[exp_idx]]);
+        LOGVAL(local_mod->ctx, LYE_SPEC, LY_VLOG_NONE, NULL, "Unparsed characters \"%s\" left at the end of an XPath expression.",
+               &iter->exp->expr[iter->exp->expr_pos[exp_idx]]);
+        goto error;
+    }
+
+    ret = iter_prepare(iter);
+    if (ret == -1) {
+        goto error;
+    } else if (ret) {
+        iter->lazy = 1;
+    } else if (lyxp_eval(expr, cur_node, LYXP_NODE_ELEM, local_mod, &iter->set, 0)) {
+        /* evaluate the whole expression at once, path was already logged */
+        lyxp_iter_free(iter);
+        return NULL;
+    }
+
+    return iter;
+
+error:
+    LOGPATH(local_mod->ctx, LY_VLOG_LYD, cur_node);
+    lyxp_iter_free(iter);
+    return NULL;
+}
+
+int
+lyxp_iter_next(struct lyd_find_iter *iter, struct lyd_node **node)
+{
+    struct lyd_find_iter_step *step;
+    struct lyd_node *next;
+    int ret;
+
+    *node = NULL;
+    if (iter->finished) {
+        return EXIT_SUCCESS;
+    }
+
+    if (!iter->lazy) {
+        if (iter->set.type == LYXP_SET_NODE_SET) {
+            while (iter->set_idx < iter->set.used) {
+                ++iter->set_idx;
+                if (iter->set.val.nodes[iter->set_idx - 1].type == LYXP_NODE_ELEM) {
+                    *node = iter->set.val.nodes[iter->set_idx - 1].node;
+                    return EXIT_SUCCESS;
+                }
+            }
+        }
+        iter->finished = 1;
+        return EXIT_SUCCESS;
+    }
+
+    while (1) {
+        step = &iter->steps[iter->depth];
+        next = iter_step_next(iter, iter->depth);
+        step->node = next;
+        if (!next) {
+            /* step exhausted, continue with the previous one */
+            if (!iter->depth) {
+                iter->finished = 1;
+                return EXIT_SUCCESS;
+            }
+            --iter->depth;
+            continue;
+        }
+
+        if (!iter_step_match_name(iter, step, next)) {
+            continue;
+        }
+        if (step->pred_count) {
+            ret = iter_step_match_pred(iter, step, next);
+            if (ret == -1) {
+                LOGPATH(iter->local_mod->ctx, LY_VLOG_LYD, iter->cur_node);
+                iter->finished = 1;
+                return -1;
+            } else if (!ret) {
+                continue;
+            }
+        }
+
+        if (iter->depth == iter->step_count - 1) {
+            /* match */
+            *node = next;
+            return EXIT_SUCCESS;
+        }
+
+        /* next step */
+        ++iter->depth;
+        iter->steps[iter->depth].node = NULL;
+    }
+}
+
+void
+lyxp_iter_free(struct lyd_find_iter *iter)
+{
+    uint16_t i;
+
+    if (!iter) {
+        return;
+    }
+
+    for (i = 0; i < iter->step_count; ++i) {
+        lydict_remove(iter->local_mod->ctx, iter->steps[i].name);
+        free(iter->steps[i].pred_parent);
+        free(iter->steps[i].pred_pos);
+    }
+    free(iter->steps);
+    lyxp_set_cast(&iter->set, LYXP_SET_EMPTY, iter->cur_node, iter->local_mod, 0);
+    lyxp_expr_free(iter->exp);
+    free(iter);
+}
+
 #if 0
 
 /* full xml printing of set elements, not used currently */
@@ -8875,35 +9583,26 @@ lyxp_set_cast(struct lyxp_set *set, enum lyxp_set_type target, const struct lyd_
     return EXIT_SUCCESS;
 }
 
-int
-lyxp_atomize(const char *expr, const struct lys_node *cur_snode, enum lyxp_node_type cur_snode_type,
-             struct lyxp_set *set, int options, const struct lys_node **ctx_snode)
+/**
+ * @brief Atomize an XPath expression, see lyxp_atomize().
+ *
+ * @param[in] store Whether to store the compiled expression in the context cache, only for schema expressions.
+ */
+static int
+lyxp_atomize_expr(const char *expr, const struct lys_node *cur_snode, enum lyxp_node_type cur_snode_type,
+                  struct lyxp_set *set, int options, const struct lys_node **ctx_snode, int store)
 {
     struct lys_node *_ctx_snode;
     enum lyxp_node_type ctx_snode_type;
     struct lyxp_expr *exp;
     uint16_t exp_idx = 0;
-    int rc = -1;
+    int rc = -1, dynamic;
 
-    exp = lyxp_parse_expr(cur_snode->module->ctx, expr);
+    exp = lyxp_expr_compile(cur_snode->module->ctx, expr, store, &dynamic);
     if (!exp) {
-        rc = -1;
-        goto finish;
-    }
-
-    rc = reparse_or_expr(cur_snode->module->ctx, exp, &exp_idx);
-    if (rc) {
-        goto finish;
-    } else if (exp->used > exp_idx) {
-        LOGVAL(cur_snode->module->ctx, LYE_XPATH_INTOK, LY_VLOG_NONE, NULL, "Unknown", &exp->expr[exp->expr_pos[exp_idx]]);
-        LOGVAL(cur_snode->module->ctx, LYE_SPEC, LY_VLOG_NONE, NULL, "Unparsed characters \"%s\" left at the end of an XPath expression.",
-               &exp->expr[exp->expr_pos[exp_idx]]);
-        rc = -1;
-        goto finish;
+        return -1;
     }
 
-    print_expr_struct_debug(exp);
-
     if (options & LYXP_SNODE_WHEN) {
         /* for when the context node may need to be changed */
         resolve_when_ctx_snode(cur_snode, &_ctx_snode, &ctx_snode_type);
@@ -8926,11 +9625,19 @@ lyxp_atomize(const char *expr, const struct lys_node *cur_snode, enum lyxp_node_
         rc = EXIT_SUCCESS;
     }
 
-finish:
-    lyxp_expr_free(exp);
+    if (dynamic) {
+        lyxp_expr_free(exp);
+    }
     return rc;
 }
 
+int
+lyxp_atomize(const char *expr, const struct lys_node *cur_snode, enum lyxp_node_type cur_snode_type,
+             struct lyxp_set *set, int options, const struct lys_node **ctx_snode)
+{
+    return lyxp_atomize_expr(expr, cur_snode, cur_snode_type, set, options, ctx_snode, 0);
+}
+
 int
 lyxp_node_atomize(const struct lys_node *node, struct lyxp_set *set, int set_ext_dep_flags)
 {
@@ -9016,7 +9723,8 @@ lyxp_node_atomize(const struct lys_node *node, struct lyxp_set *set, int set_ext
 
     /* check "when" */
     if (when) {
-        if (lyxp_atomize(when->cond, node, LYXP_NODE_ELEM, &tmp_set, LYXP_SNODE_WHEN | opts, &ctx_snode)) {
+        if (lyxp_atomize_expr(when->cond, node, LYXP_NODE_ELEM, &tmp_set, LYXP_SNODE_WHEN | opts, &ctx_snode,
+                              set_ext_dep_flags)) {
             free(tmp_set.val.snodes);
             if (ctx_snode) {
                 path = lys_path(ctx_snode, LYS_PATH_FIRST_PREFIX);
@@ -9063,7 +9771,8 @@ lyxp_node_atomize(const struct lys_node *node, struct lyxp_set *set, int set_ext
 
     /* check "must" */
     for (i = 0; i < must_size; ++i) {
-        if (lyxp_atomize(must[i].expr, node, LYXP_NODE_ELEM, &tmp_set, LYXP_SNODE_MUST | opts, &ctx_snode)) {
+        if (lyxp_atomize_expr(must[i].expr, node, LYXP_NODE_ELEM, &tmp_set, LYXP_SNODE_MUST | opts, &ctx_snode,
+                              set_ext_dep_flags)) {
             free(tmp_set.val.snodes);
             if (ctx_snode) {
                 path = lys_path(ctx_snode, LYS_PATH_FIRST_PREFIX);
@@ -256,6 +256,67 @@ struct lyxp_set {
 int lyxp_eval(const char *expr, const struct lyd_node *cur_node, enum lyxp_node_type cur_node_type,
               const struct lys_module *local_mod, struct lyxp_set *set, int options);
 
+/**
+ * @brief Iterator over the results of an XPath expression (::lyd_find_path_iter()).
+ */
+struct lyd_find_iter {
+    struct lyxp_expr *exp;           /* parsed expression */
+    struct lyd_node *cur_node;       /* context node */
+    struct lys_module *local_mod;    /* local module of the expression */
+
+    /* lazy evaluation, location path steps */
+    struct lyd_find_iter_step {
+        struct lys_module *mod;      /* module of the matching nodes, NULL for any */
+        const char *name;            /* name of the matching nodes (in dictionary), "*" for any */
+        uint8_t any_name;            /* whether name is "*" */
+        uint8_t all_desc;            /* step searches all the descendants ('//') */
+        uint16_t pred_idx;           /* index of the first predicate '[' token */
+        uint16_t pred_count;         /* number of predicates */
+        struct lyd_node **pred_parent; /* parent of the last node that reached the predicate, for each predicate */
+        uint32_t *pred_pos;          /* context position of the last node that reached the predicate, for each predicate */
+        struct lyd_node *node;       /* current candidate node of the step */
+    } *steps;
+    uint16_t step_count;
+    uint16_t depth;                  /* index of the step being evaluated */
+    uint8_t absolute;                /* expression starts from the root */
+    uint8_t lazy;                    /* expression is evaluated lazily, otherwise set holds the whole result */
+    uint8_t finished;                /* no more results */
+
+    /* full evaluation */
+    struct lyxp_set set;
+    uint32_t set_idx;
+};
+
+/**
+ * @brief Create an iterator over the data nodes matching \p expr. Location paths consisting of name tests
+ * with predicates (where only the last step can be '//') are evaluated lazily, one match at a time,
+ * in constant memory. Other expressions are evaluated fully on creation and their result is iterated.
+ *
+ * @param[in] expr XPath expression to evaluate, NULL for an iterator with no results.
+ * @param[in] cur_node Current (context) data node.
+ * @param[in] local_mod Local module relative to the \p expr.
+ *
+ * @return Created iterator, NULL on error.
+ */
+struct lyd_find_iter *lyxp_iter_new(const char *expr, const struct lyd_node *cur_node, const struct lys_module *local_mod);
+
+/**
+ * @brief Get the next data node matching the iterator expression, in the document order.
+ *
+ * @param[in] iter Iterator to use.
+ * @param[out] node Next matching node, NULL if there are no more.
+ *
+ * @return EXIT_SUCCESS on success, -1 on error.
+ */
+int lyxp_iter_next(struct lyd_find_iter *iter, struct lyd_node **node);
+
+/**
+ * @brief Free an iterator.
+ *
+ * @param[in] iter Iterator to free.
+ */
+void lyxp_iter_free(struct lyd_find_iter *iter);
+
 /**
  * @brief Get all the partial XPath nodes (atoms) that are required for \p expr to be evaluated.
  *
@@ -298,6 +359,8 @@ int lyxp_atomize(const char *expr, const struct lys_node *cur_snode, enum lyxp_n
  * Will be cleared before use.
  * @param[in] set_ext_dep_flags Whether to set #LYS_XPCONF_DEP or #LYS_XPSTATE_DEP for conditions that
  * require foreign configuration or state subtree and also for the node itself, if it has any such condition.
+ * The expressions are also stored in the context cache of compiled expressions, so it must only be set while
+ * the schema is being compiled.
  *
  * @return EXIT_SUCCESS on success, -1 on error.
  */
@@ -354,4 +417,29 @@ struct lyxp_expr *lyxp_parse_expr(struct ly_ctx *ctx, const char *expr);
  */
 void lyxp_expr_free(struct lyxp_expr *expr);
 
+/**
+ * @brief Create a cache of compiled XPath expressions for a context. Schema expressions
+ * are then tokenized and reparsed only once, other expressions on every evaluation.
+ *
+ * @return New empty cache, NULL on error.
+ */
+struct lyxp_expr_cache *lyxp_expr_cache_new(void);
+
+/**
+ * @brief Free a cache of compiled XPath expressions including all the expressions.
+ *
+ * @param[in] cache Cache to free.
+ */
+void lyxp_expr_cache_free(struct lyxp_expr_cache *cache);
+
+/**
+ * @brief Compile an XPath expression into the context cache without evaluating it. Must not be called
+ * concurrently with any other work in the context, the cache is read without locking.
+ *
+ * @param[in] ctx Context with the cache.
+ * @param[in] expr XPath expression to compile.
+ * @return 0 on success, -1 on error.
+ */
+int lyxp_expr_precompile(struct ly_ctx *ctx, const char *expr);
+
 #endif /* _XPATH_H */
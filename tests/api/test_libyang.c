@@ -39,16 +39,15 @@ struct lyd_node *root = NULL;
 const struct lys_module *module = NULL;
 
 static int
-setup_f(void **state)
+setup_ctx(int options)
 {
-    (void) state; /* unused */
     char *config_file = TESTS_DIR"/api/files/a.xml";
     char *yin_file = TESTS_DIR"/api/files/a.yin";
     char *yang_file = TESTS_DIR"/api/files/b.yang";
     char *yang_dev_file = TESTS_DIR"/api/files/b-dev.yang";
     char *yang_folder = TESTS_DIR"/api/files";
 
-    ctx = ly_ctx_new(yang_folder, 0);
+    ctx = ly_ctx_new(yang_folder, options);
     if (!ctx) {
         return -1;
     }
@@ -73,6 +72,20 @@ setup_f(void **state)
     return 0;
 }
 
+static int
+setup_f(void **state)
+{
+    (void) state; /* unused */
+    return setup_ctx(0);
+}
+
+static int
+setup_keep_sources_f(void **state)
+{
+    (void) state; /* unused */
+    return setup_ctx(LY_CTX_KEEP_SOURCES);
+}
+
 static int
 teardown_f(void **state)
 {
@@ -367,6 +380,342 @@ test_ly_ctx_get_module(void **state)
     assert_string_equal(revision, module->rev->date);
 }
 
+static const char *
+get_module_revisions_clb(const char *mod_name, const char *mod_rev, const char *submod_name, const char *sub_rev,
+                         void *user_data, LYS_INFORMAT *format, void (**free_module_data)(void *model_data, void *user_data))
+{
+    (void)submod_name;
+    (void)sub_rev;
+    (void)user_data;
+
+    *format = LYS_IN_YANG;
+    *free_module_data = NULL;
+    if (!strcmp(mod_name, "m") && mod_rev && !strcmp(mod_rev, "2016-01-01")) {
+        return "module m {namespace urn:m; prefix m; revision 2016-01-01;}";
+    }
+    return NULL;
+}
+
+static void
+test_ly_ctx_get_module_revisions(void **state)
+{
+    (void) state; /* unused */
+    struct ly_ctx *ctx2;
+    const struct lys_module *old, *new, *user;
+
+    ctx2 = ly_ctx_new(NULL, 0);
+    assert_ptr_not_equal(ctx2, NULL);
+    ly_ctx_set_module_imp_clb(ctx2, get_module_revisions_clb, NULL);
+
+    old = lys_parse_mem(ctx2, "module m {namespace urn:m; prefix m; revision 2015-01-01;}", LYS_IN_YANG);
+    assert_ptr_not_equal(old, NULL);
+    user = lys_parse_mem(ctx2, "module n {namespace urn:n; prefix n; import m {prefix m; revision-date 2016-01-01;}}",
+                         LYS_IN_YANG);
+    assert_ptr_not_equal(user, NULL);
+    new = ly_ctx_get_module(ctx2, "m", "2016-01-01", 0);
+    assert_ptr_not_equal(new, NULL);
+    assert_int_equal(new->implemented, 0);
+
+    /* newest, implemented and specific revision */
+    assert_ptr_equal(ly_ctx_get_module(ctx2, "m", NULL, 0), new);
+    assert_ptr_equal(ly_ctx_get_module(ctx2, "m", NULL, 1), old);
+    assert_ptr_equal(ly_ctx_get_module(ctx2, "m", "2015-01-01", 0), old);
+    assert_ptr_equal(ly_ctx_get_module(ctx2, "m", "2017-01-01", 0), NULL);
+    assert_ptr_equal(ly_ctx_get_module_by_ns(ctx2, "urn:m", NULL, 0), new);
+    assert_ptr_equal(ly_ctx_get_module_by_ns(ctx2, "urn:m", NULL, 1), old);
+    assert_ptr_equal(ly_ctx_get_module_by_ns(ctx2, "urn:m", "2015-01-01", 0), old);
+    assert_ptr_equal(ly_ctx_get_module(ctx2, "mm", NULL, 0), NULL);
+    assert_ptr_equal(ly_ctx_get_module_by_ns(ctx2, "urn:", NULL, 0), NULL);
+
+    /* disabled modules are skipped */
+    assert_int_equal(lys_set_disabled(old), 0);
+    assert_ptr_equal(ly_ctx_get_module(ctx2, "m", NULL, 1), NULL);
+    assert_ptr_equal(ly_ctx_get_module(ctx2, "m", "2015-01-01", 0), NULL);
+    assert_int_equal(lys_set_enabled(old), 0);
+    assert_ptr_equal(ly_ctx_get_module(ctx2, "m", NULL, 1), old);
+
+    /* the import-only revision is removed together with its user */
+    assert_int_equal(ly_ctx_remove_module(user, NULL), 0);
+    assert_ptr_equal(ly_ctx_get_module(ctx2, "n", NULL, 0), NULL);
+    assert_ptr_equal(ly_ctx_get_module(ctx2, "m", NULL, 0), old);
+    assert_ptr_equal(ly_ctx_get_module_by_ns(ctx2, "urn:m", NULL, 0), old);
+
+    ly_ctx_destroy(ctx2, NULL);
+}
+
+static void
+test_ly_ctx_bundle(void **state)
+{
+    (void) state; /* unused */
+    char file_name[] = "/tmp/libyang-XXXXXX";
+    struct ly_ctx *ctx2;
+    const struct lys_module *mod, *mod2;
+    struct lyd_node *root2;
+    char *str, *str2;
+    uint32_t idx = 0, idx2 = 0;
+    int fd;
+
+    /* module parsed from memory, features, a submodule feature and a disabled module */
+    mod = lys_parse_mem(ctx, "module m {namespace urn:m; prefix m; import b {prefix b; revision-date 2016-03-01;}"
+                        "feature f; leaf l {if-feature f; type string;}}", LYS_IN_YANG);
+    assert_ptr_not_equal(mod, NULL);
+    assert_int_equal(lys_features_enable(mod, "f"), 0);
+    assert_int_equal(lys_features_enable(module, "bar"), 0);
+    mod = ly_ctx_load_module(ctx, "c", NULL);
+    assert_ptr_not_equal(mod, NULL);
+    assert_int_equal(lys_set_disabled(mod), 0);
+
+    fd = mkstemp(file_name);
+    assert_int_not_equal(fd, -1);
+    close(fd);
+    assert_int_equal(ly_ctx_print_bundle(ctx, file_name), 0);
+    ctx2 = ly_ctx_new_bundle(NULL, file_name, 0);
+    unlink(file_name);
+    assert_ptr_not_equal(ctx2, NULL);
+
+    /* the same modules in the same state */
+    while ((mod = ly_ctx_get_module_iter(ctx, &idx))) {
+        mod2 = ly_ctx_get_module_iter(ctx2, &idx2);
+        assert_ptr_not_equal(mod2, NULL);
+        assert_string_equal(mod->name, mod2->name);
+        assert_int_equal(mod->rev_size ? 1 : 0, mod2->rev_size ? 1 : 0);
+        if (mod->rev_size) {
+            assert_string_equal(mod->rev[0].date, mod2->rev[0].date);
+        }
+        assert_int_equal(mod->implemented, mod2->implemented);
+        assert_int_equal(mod->disabled, mod2->disabled);
+        assert_int_equal(mod->inc_size, mod2->inc_size);
+        assert_int_equal(mod->features_size, mod2->features_size);
+    }
+    assert_ptr_equal(ly_ctx_get_module_iter(ctx2, &idx2), NULL);
+    mod2 = ly_ctx_get_module(ctx2, "m", NULL, 1);
+    assert_ptr_not_equal(mod2, NULL);
+    assert_int_equal(lys_features_state(mod2, "f"), 1);
+    assert_int_equal(lys_features_state(ly_ctx_get_module(ctx2, "b", "2016-03-01", 1), "bar"), 1);
+    assert_int_equal(lys_features_state(ly_ctx_get_module(ctx2, "b", "2016-03-01", 1), "foo"), 0);
+    assert_ptr_equal(ly_ctx_get_module(ctx2, "c", NULL, 0), NULL);
+    idx = idx2 = 0;
+    while ((mod = ly_ctx_get_disabled_module_iter(ctx, &idx))) {
+        mod2 = ly_ctx_get_disabled_module_iter(ctx2, &idx2);
+        assert_ptr_not_equal(mod2, NULL);
+        assert_string_equal(mod->name, mod2->name);
+    }
+    assert_ptr_equal(ly_ctx_get_disabled_module_iter(ctx2, &idx2), NULL);
+
+    /* the data are parsed the same way */
+    root2 = lyd_parse_path(ctx2, TESTS_DIR"/api/files/a.xml", LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(root2, NULL);
+    assert_int_equal(lyd_print_mem(&str, root, LYD_XML, LYP_WITHSIBLINGS), 0);
+    assert_int_equal(lyd_print_mem(&str2, root2, LYD_XML, LYP_WITHSIBLINGS), 0);
+    assert_string_equal(str, str2);
+    free(str);
+    free(str2);
+    lyd_free_withsiblings(root2);
+    ly_ctx_destroy(ctx2, NULL);
+
+    /* not a bundle */
+    assert_ptr_equal(ly_ctx_new_bundle(NULL, TESTS_DIR"/api/files/a.xml", 0), NULL);
+}
+
+static void
+test_ly_ctx_clone(void **state)
+{
+    (void) state; /* unused */
+    struct ly_ctx *ctx2;
+    const struct lys_module *mod, *mod2;
+    struct lyd_node *root2;
+    const char * const *dirs, * const *dirs2;
+    char *str, *str2;
+    uint32_t idx = 0, idx2 = 0;
+
+    assert_ptr_equal(ly_ctx_clone(NULL), NULL);
+
+    assert_int_equal(lys_features_enable(module, "bar"), 0);
+    ctx2 = ly_ctx_clone(ctx);
+    assert_ptr_not_equal(ctx2, NULL);
+
+    /* the same modules in the same state */
+    while ((mod = ly_ctx_get_module_iter(ctx, &idx))) {
+        mod2 = ly_ctx_get_module_iter(ctx2, &idx2);
+        assert_ptr_not_equal(mod2, NULL);
+        assert_ptr_not_equal(mod, mod2);
+        assert_string_equal(mod->name, mod2->name);
+        assert_int_equal(mod->implemented, mod2->implemented);
+    }
+    assert_ptr_equal(ly_ctx_get_module_iter(ctx2, &idx2), NULL);
+    dirs = ly_ctx_get_searchdirs(ctx);
+    dirs2 = ly_ctx_get_searchdirs(ctx2);
+    assert_ptr_not_equal(dirs2, NULL);
+    assert_string_equal(dirs[0], dirs2[0]);
+    assert_ptr_equal(dirs2[1], NULL);
+
+    /* the data are parsed the same way */
+    root2 = lyd_parse_path(ctx2, TESTS_DIR"/api/files/a.xml", LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(root2, NULL);
+    assert_int_equal(lyd_print_mem(&str, root, LYD_XML, LYP_WITHSIBLINGS), 0);
+    assert_int_equal(lyd_print_mem(&str2, root2, LYD_XML, LYP_WITHSIBLINGS), 0);
+    assert_string_equal(str, str2);
+    free(str);
+    free(str2);
+    lyd_free_withsiblings(root2);
+
+    /* but the contexts are independent */
+    mod2 = ly_ctx_get_module(ctx2, "b", "2016-03-01", 1);
+    assert_ptr_not_equal(mod2, NULL);
+    assert_int_equal(lys_features_state(mod2, "bar"), 1);
+    assert_int_equal(lys_features_disable(mod2, "bar"), 0);
+    assert_int_equal(lys_features_state(mod2, "bar"), 0);
+    assert_int_equal(lys_features_state(module, "bar"), 1);
+
+    assert_int_equal(lys_set_disabled(ly_ctx_get_module(ctx2, "b-dev", NULL, 1)), 0);
+    assert_ptr_not_equal(ly_ctx_get_module(ctx, "b-dev", NULL, 1), NULL);
+    assert_ptr_not_equal(ly_ctx_load_module(ctx2, "c", NULL), NULL);
+    assert_ptr_equal(ly_ctx_get_module(ctx, "c", NULL, 0), NULL);
+
+    ly_ctx_destroy(ctx2, NULL);
+}
+
+static void
+test_ly_ctx_clone_deviated(void **state)
+{
+    (void) state; /* unused */
+    struct ly_ctx *ctx1, *ctx2, *ctx3;
+    const struct lys_module *mod;
+    const char *yang_x = "module x {namespace urn:x; prefix x; feature f1 { if-feature f2; } feature f2;"
+                         "container c { leaf l1 { type string; } leaf l2 { type uint8; } } }";
+    const char *yang_x_dev = "module x-dev {namespace urn:x-dev; prefix xd; import x { prefix x; }"
+                             "deviation /x:c/x:l1 { deviate not-supported; }"
+                             "deviation /x:c/x:l2 { deviate replace { type uint16; } } }";
+
+    /* without the sources, the modules are printed from the parsed schemas, but not the deviated ones */
+    ctx1 = ly_ctx_new(NULL, 0);
+    assert_ptr_not_equal(ctx1, NULL);
+    assert_ptr_not_equal(lys_parse_mem(ctx1, yang_x, LYS_IN_YANG), NULL);
+    ctx2 = ly_ctx_clone(ctx1);
+    assert_ptr_not_equal(ctx2, NULL);
+    assert_ptr_not_equal(ly_ctx_get_node(ctx2, NULL, "/x:c/l1", 0), NULL);
+    ly_ctx_destroy(ctx2, NULL);
+    assert_ptr_not_equal(lys_parse_mem(ctx1, yang_x_dev, LYS_IN_YANG), NULL);
+    assert_ptr_equal(ctx1->models.sources, NULL);
+    assert_ptr_equal(ly_ctx_clone(ctx1), NULL);
+    ly_ctx_destroy(ctx1, NULL);
+
+    /* modules parsed from memory, one of them deviated */
+    ctx1 = ly_ctx_new(NULL, LY_CTX_KEEP_SOURCES);
+    assert_ptr_not_equal(ctx1, NULL);
+    mod = lys_parse_mem(ctx1, yang_x, LYS_IN_YANG);
+    assert_ptr_not_equal(mod, NULL);
+    assert_ptr_not_equal(lys_parse_mem(ctx1, yang_x_dev, LYS_IN_YANG), NULL);
+    assert_int_equal(lys_features_enable(mod, "f2"), 0);
+    assert_int_equal(lys_features_enable(mod, "f1"), 0);
+
+    /* a clone and a clone of the clone */
+    ctx2 = ly_ctx_clone(ctx1);
+    assert_ptr_not_equal(ctx2, NULL);
+    ctx3 = ly_ctx_clone(ctx2);
+    assert_ptr_not_equal(ctx3, NULL);
+
+    /* the deviations are applied exactly once */
+    mod = ly_ctx_get_module(ctx3, "x", NULL, 1);
+    assert_ptr_not_equal(mod, NULL);
+    assert_int_equal(mod->deviated, 1);
+    assert_ptr_equal(ly_ctx_get_node(ctx3, NULL, "/x:c/l1", 0), NULL);
+    assert_int_equal(((struct lys_node_leaf *)ly_ctx_get_node(ctx3, NULL, "/x:c/l2", 0))->type.base, LY_TYPE_UINT16);
+    assert_int_equal(ly_ctx_get_module(ctx3, "x-dev", NULL, 1)->implemented, 1);
+
+    /* the feature depending on the one declared after it is enabled as well */
+    assert_int_equal(lys_features_state(mod, "f1"), 1);
+    assert_int_equal(lys_features_state(mod, "f2"), 1);
+
+    ly_ctx_destroy(ctx3, NULL);
+    ly_ctx_destroy(ctx2, NULL);
+    ly_ctx_destroy(ctx1, NULL);
+}
+
+static void
+test_ly_ctx_freeze(void **state)
+{
+    (void) state; /* unused */
+    struct lyd_node *root2;
+    char *str, *str2;
+    int used;
+
+    assert_int_equal(ly_ctx_freeze(NULL), 1);
+    assert_int_equal(ly_ctx_freeze(ctx), 0);
+    assert_int_equal(ly_ctx_freeze(ctx), 0);
+
+    /* the data work as before */
+    root2 = lyd_parse_path(ctx, TESTS_DIR"/api/files/a.xml", LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(root2, NULL);
+    assert_int_equal(lyd_validate(&root2, LYD_OPT_CONFIG, NULL), 0);
+    assert_int_equal(lyd_print_mem(&str, root, LYD_XML, LYP_WITHSIBLINGS), 0);
+    assert_int_equal(lyd_print_mem(&str2, root2, LYD_XML, LYP_WITHSIBLINGS), 0);
+    assert_string_equal(str, str2);
+    free(str);
+    free(str2);
+    lyd_free_withsiblings(root2);
+
+    /* but the schemas cannot be changed */
+    used = ctx->models.used;
+    assert_ptr_equal(lys_parse_mem(ctx, "module m {namespace urn:m; prefix m;}", LYS_IN_YANG), NULL);
+    assert_ptr_equal(ly_ctx_load_module(ctx, "c", NULL), NULL);
+    assert_int_not_equal(lys_features_enable(module, "foo"), 0);
+    assert_int_not_equal(lys_set_disabled(module), 0);
+    assert_int_not_equal(ly_ctx_remove_module(module, NULL), 0);
+    ly_ctx_clean(ctx, NULL);
+    assert_int_equal(ctx->models.used, used);
+    assert_int_equal(module->disabled, 0);
+    assert_int_equal(lys_features_state(module, "foo"), 0);
+}
+
+static void
+test_ly_ctx_freeze_grouping(void **state)
+{
+    (void) state; /* unused */
+    struct ly_ctx *tctx;
+    const struct lys_node_leaf *leaf;
+    struct lyd_node *data;
+    const char *yang =
+    "module g {"
+    "  namespace urn:g;"
+    "  prefix g;"
+    "  grouping grp {"
+    "    typedef code { type string { pattern '[A-Z]+'; } }"
+    "    container c {"
+    "      typedef num { type string { pattern '[0-9]+'; } }"
+    "      leaf n { type num; }"
+    "    }"
+    "    leaf code { type code; }"
+    "  }"
+    "  container top { uses grp; }"
+    "}";
+
+    /* trusted schemas compile their patterns only on demand */
+    tctx = ly_ctx_new(NULL, LY_CTX_TRUSTED);
+    assert_ptr_not_equal(tctx, NULL);
+    assert_ptr_not_equal(lys_parse_mem(tctx, yang, LYS_IN_YANG), NULL);
+    assert_int_equal(ly_ctx_freeze(tctx), 0);
+
+#ifdef LY_ENABLED_CACHE
+    /* the typedefs in the grouping are used by its instances, so they were compiled as well */
+    leaf = (const struct lys_node_leaf *)ly_ctx_get_node(tctx, NULL, "/g:top/code", 0);
+    assert_ptr_not_equal(leaf, NULL);
+    assert_ptr_not_equal(leaf->type.der->type.info.str.patterns_pcre, NULL);
+    leaf = (const struct lys_node_leaf *)ly_ctx_get_node(tctx, NULL, "/g:top/c/n", 0);
+    assert_ptr_not_equal(leaf, NULL);
+    assert_ptr_not_equal(leaf->type.der->type.info.str.patterns_pcre, NULL);
+#else
+    (void)leaf;
+#endif
+
+    data = lyd_parse_mem(tctx, "<top xmlns=\"urn:g\"><code>AB</code><c><n>12</n></c></top>", LYD_XML,
+                         LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(data, NULL);
+    lyd_free_withsiblings(data);
+
+    ly_ctx_destroy(tctx, NULL);
+}
+
 static void
 test_ly_ctx_get_module_older(void **state)
 {
@@ -450,6 +799,51 @@ test_ly_ctx_load_module(void **state)
     assert_string_equal("b", module->name);
 }
 
+static void
+test_ly_ctx_load_modules(void **state)
+{
+    (void) state; /* unused */
+    struct ly_ctx *ctx;
+    const struct lys_module *mods[4];
+    const char *names[] = {"y", "b-dev", "c", "INVALID_NAME"};
+    const char *revisions[] = {NULL, "", NULL, NULL};
+    const struct lys_submodule *submod;
+
+    ctx = ly_ctx_new(TESTS_DIR"/api/files/", 0);
+    assert_ptr_not_equal(ctx, NULL);
+
+    assert_int_equal(ly_ctx_load_modules(NULL, names, revisions, 3, mods), EXIT_FAILURE);
+    assert_int_equal(ly_ctx_load_modules(ctx, NULL, NULL, 3, mods), EXIT_FAILURE);
+
+    assert_int_equal(ly_ctx_load_modules(ctx, names, revisions, 3, mods), EXIT_SUCCESS);
+    assert_string_equal(mods[0]->name, "y");
+    assert_string_equal(mods[1]->name, "b-dev");
+    assert_string_equal(mods[2]->name, "c");
+    assert_ptr_not_equal(mods[0]->filepath, NULL);
+
+    /* imports were loaded as well, with the correct revisions */
+    assert_ptr_not_equal(ly_ctx_get_module(ctx, "x", NULL, 0), NULL);
+    assert_ptr_equal(ly_ctx_get_module(ctx, "x", NULL, 1), NULL);
+    assert_ptr_not_equal(ly_ctx_get_module(ctx, "a", "2015-01-01", 0), NULL);
+    assert_ptr_not_equal(ly_ctx_get_module(ctx, "b", "2015-01-01", 0), NULL);
+    assert_ptr_not_equal(ly_ctx_get_module(ctx, "b", "2016-03-01", 0), NULL);
+
+    /* including the submodules */
+    submod = ly_ctx_get_submodule(ctx, "b", "2016-03-01", "btop", NULL);
+    assert_ptr_not_equal(submod, NULL);
+    assert_ptr_not_equal(strstr(submod->filepath, "btop.yang"), NULL);
+
+    /* loading already loaded modules */
+    assert_int_equal(ly_ctx_load_modules(ctx, names, NULL, 1, NULL), EXIT_SUCCESS);
+
+    /* failure */
+    assert_int_equal(ly_ctx_load_modules(ctx, &names[2], NULL, 2, mods), EXIT_FAILURE);
+    assert_string_equal(mods[0]->name, "c");
+    assert_ptr_equal(mods[1], NULL);
+
+    ly_ctx_destroy(ctx, NULL);
+}
+
 static void
 test_ly_ctx_clean(void **state)
 {
@@ -1563,6 +1957,48 @@ test_ly_set_contains(void **state)
     }
 }
 
+void
+test_ly_set_hashed(void **state)
+{
+    (void) state;
+    struct ly_set_hashed *set;
+    char items[100];
+    int i;
+
+    set = ly_set_hashed_new();
+    assert_ptr_not_equal(set, NULL);
+
+    for (i = 0; i < 100; ++i) {
+        assert_int_equal(ly_set_hashed_add(set, &items[i]), i);
+    }
+    assert_int_equal(set->set.number, 100);
+    assert_true(set->set.size >= 100);
+    assert_ptr_equal(set->set.set.g[42], &items[42]);
+
+    /* no duplicities */
+    assert_int_equal(ly_set_hashed_add(set, &items[42]), 42);
+    assert_int_equal(set->set.number, 100);
+    assert_int_equal(ly_set_hashed_contains(set, &items[99]), 99);
+    assert_int_equal(ly_set_hashed_contains(set, NULL), -1);
+
+    /* the last item takes the place of the removed one */
+    assert_int_equal(ly_set_hashed_rm(set, &items[10]), 0);
+    assert_int_equal(set->set.number, 99);
+    assert_int_equal(ly_set_hashed_contains(set, &items[10]), -1);
+    assert_int_equal(ly_set_hashed_contains(set, &items[99]), 10);
+    assert_int_equal(ly_set_hashed_rm(set, &items[98]), 0);
+    assert_int_equal(ly_set_hashed_contains(set, &items[99]), 10);
+    assert_int_not_equal(ly_set_hashed_rm(set, &items[98]), 0);
+    assert_int_equal(ly_set_hashed_add(set, &items[10]), 98);
+
+    assert_int_equal(ly_set_hashed_clean(set), 0);
+    assert_int_equal(set->set.number, 0);
+    assert_int_equal(ly_set_hashed_contains(set, &items[10]), -1);
+    assert_int_equal(ly_set_hashed_add(set, &items[10]), 0);
+
+    ly_set_hashed_free(set);
+}
+
 void
 test_ly_vecode(void **state)
 {
@@ -1613,7 +2049,14 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_ly_ctx_module_clb, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_ctx_get_module, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_ctx_get_module_older, setup_f, teardown_f),
+        cmocka_unit_test(test_ly_ctx_get_module_revisions),
+        cmocka_unit_test_setup_teardown(test_ly_ctx_bundle, setup_keep_sources_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_ly_ctx_clone, setup_keep_sources_f, teardown_f),
+        cmocka_unit_test(test_ly_ctx_clone_deviated),
+        cmocka_unit_test_setup_teardown(test_ly_ctx_freeze, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_ly_ctx_freeze_grouping, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_ctx_load_module, setup_f, teardown_f),
+        cmocka_unit_test(test_ly_ctx_load_modules),
         cmocka_unit_test_teardown(test_ly_ctx_remove_module, teardown_f),
         cmocka_unit_test_teardown(test_ly_ctx_remove_module2, teardown_f),
         cmocka_unit_test_teardown(test_lys_set_enabled, teardown_f),
@@ -1644,6 +2087,7 @@ int main(void)
         cmocka_unit_test(test_ly_ctx_destroy),
         cmocka_unit_test_setup_teardown(test_ly_path_xml2json, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_set_dup, setup_f, teardown_f),
+        cmocka_unit_test(test_ly_set_hashed),
         cmocka_unit_test_setup_teardown(test_ly_vecode, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_errmsg, setup_f, teardown_f),
     };
@@ -278,6 +278,20 @@ test_advanced(void **state)
     ly_set_free(st->set);
     st->set = NULL;
 
+    st->set = lyd_find_path(st->dt, "/ietf-interfaces:interfaces/interface/ietf-ip:ipv4/ietf-ip:address[2]/ietf-ip:ip");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 2);
+    assert_string_equal(((struct lyd_node_leaf_list *)st->set->set.d[0])->value_str, "172.0.0.1");
+    assert_string_equal(((struct lyd_node_leaf_list *)st->set->set.d[1])->value_str, "172.0.0.5");
+    ly_set_free(st->set);
+    st->set = NULL;
+
+    st->set = lyd_find_path(st->dt, "/ietf-interfaces:interfaces/interface[3]");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 0);
+    ly_set_free(st->set);
+    st->set = NULL;
+
     st->set = lyd_find_path(st->dt, "//interface[name='iface1']/ietf-ip:ipv4//*");
     assert_ptr_not_equal(st->set, NULL);
     assert_int_equal(st->set->number, 12);
@@ -361,6 +375,87 @@ test_functions_operators(void **state)
     st->set = NULL;
 }
 
+static void
+test_typed_comparison(void **state)
+{
+    struct state *st = (struct state *)*state;
+
+    st->set = lyd_find_path(st->dt, "//ietf-ip:mtu[. >= 68]");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 2);
+    ly_set_free(st->set);
+    st->set = NULL;
+
+    st->set = lyd_find_path(st->dt, "//ietf-ip:ipv4[ietf-ip:mtu < 100]/ietf-ip:address[ietf-ip:prefix-length = 16.0]/ietf-ip:ip");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 1);
+    assert_string_equal(((struct lyd_node_leaf_list *)st->set->set.d[0])->value_str, "172.0.0.1");
+    ly_set_free(st->set);
+    st->set = NULL;
+
+    st->set = lyd_find_path(st->dt, "//ietf-ip:address[64 = ietf-ip:prefix-length]/ietf-ip:ip");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 2);
+    ly_set_free(st->set);
+    st->set = NULL;
+
+    st->set = lyd_find_path(st->dt, "/ietf-interfaces:interfaces/interface[enabled != 'true']/name");
+    assert_ptr_not_equal(st->set, NULL);
+    assert_int_equal(st->set->number, 1);
+    assert_string_equal(((struct lyd_node_leaf_list *)st->set->set.d[0])->value_str, "iface2");
+    ly_set_free(st->set);
+    st->set = NULL;
+}
+
+static void
+test_iter(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct lyd_find_iter *iter;
+    struct lyd_node *node;
+    unsigned int i, j;
+    const char *paths[] = {
+        "/ietf-interfaces:interfaces/interface/name",
+        "/ietf-interfaces:interfaces/interface[name='iface2']/ietf-ip:ipv4/ietf-ip:address/ietf-ip:ip",
+        "/ietf-interfaces:interfaces/interface/ietf-ip:ipv4/ietf-ip:address[2]/*",
+        "/ietf-interfaces:interfaces/interface/ietf-ip:ipv6/ietf-ip:address[ietf-ip:prefix-length > 10][1]",
+        "/ietf-interfaces:interfaces//ietf-ip:ip",
+        "//ietf-ip:ip[position() mod 2 = 1]",
+        "//*",
+        "/ietf-interfaces:interfaces/interface[last()]",
+        "//ietf-ip:ip | //name",
+        "/ietf-interfaces:interfaces/nonexisting"
+    };
+
+    for (i = 0; i < sizeof paths / sizeof *paths; ++i) {
+        st->set = lyd_find_path(st->dt, paths[i]);
+        assert_ptr_not_equal(st->set, NULL);
+        iter = lyd_find_path_iter(st->dt, paths[i]);
+        assert_ptr_not_equal(iter, NULL);
+
+        for (j = 0; (node = lyd_find_path_next(iter)); ++j) {
+            assert_true(j < st->set->number);
+            assert_ptr_equal(node, st->set->set.d[j]);
+        }
+        assert_int_equal(j, st->set->number);
+
+        lyd_find_path_iter_free(iter);
+        ly_set_free(st->set);
+        st->set = NULL;
+    }
+
+    /* stop early */
+    iter = lyd_find_path_iter(st->dt, "//ietf-ip:ip");
+    assert_ptr_not_equal(iter, NULL);
+    node = lyd_find_path_next(iter);
+    assert_ptr_not_equal(node, NULL);
+    assert_string_equal(((struct lyd_node_leaf_list *)node)->value_str, "10.0.0.1");
+    lyd_find_path_iter_free(iter);
+
+    iter = lyd_find_path_iter(st->dt, "/interface/name[./]");
+    assert_ptr_equal(iter, NULL);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -368,6 +463,8 @@ int main(void)
                     cmocka_unit_test_setup_teardown(test_simple, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_advanced, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_functions_operators, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_typed_comparison, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_iter, setup_f, teardown_f),
                     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
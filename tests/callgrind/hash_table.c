@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <valgrind/callgrind.h>
+
+#include "tests/config.h"
+#include "libyang.h"
+#include "hash_table.h"
+
+#define COUNT 100000
+
+static int
+val_equal(void *val1_p, void *val2_p, int UNUSED(mod), void *UNUSED(cb_data))
+{
+    return *(uint64_t *)val1_p == *(uint64_t *)val2_p;
+}
+
+static uint32_t
+val_hash(uint64_t val)
+{
+    return dict_hash_multi(dict_hash_multi(0, (char *)&val, sizeof val), NULL, 0);
+}
+
+static double
+now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void
+phase_print(const char *name, double start)
+{
+    printf("%-16s %8.2f ms\n", name, now() - start);
+}
+
+/*
+ * Each phase is dumped separately by callgrind, the time is printed for runs without it.
+ */
+int
+main(void)
+{
+    struct hash_table *ht;
+    uint64_t i, val;
+    int ret = 0;
+    double start;
+
+    ht = lyht_new(8, sizeof val, val_equal, NULL, 1);
+    if (!ht) {
+        return 1;
+    }
+
+    /* growing the table from the smallest size */
+    CALLGRIND_START_INSTRUMENTATION;
+    start = now();
+    for (i = 0; i < COUNT; ++i) {
+        ret |= lyht_insert(ht, &i, val_hash(i), NULL);
+    }
+    phase_print("insert", start);
+    CALLGRIND_DUMP_STATS_AT("insert");
+
+    start = now();
+    for (i = 0; i < COUNT; ++i) {
+        ret |= lyht_find(ht, &i, val_hash(i), NULL);
+    }
+    phase_print("find", start);
+    CALLGRIND_DUMP_STATS_AT("find");
+
+    start = now();
+    for (i = COUNT; i < 2 * COUNT; ++i) {
+        ret |= !lyht_find(ht, &i, val_hash(i), NULL);
+    }
+    phase_print("find missing", start);
+    CALLGRIND_DUMP_STATS_AT("find missing");
+
+    /* the same number of values, but many removed ones in between */
+    start = now();
+    for (i = 0; i < COUNT; ++i) {
+        ret |= lyht_remove(ht, &i, val_hash(i));
+        val = i + COUNT;
+        ret |= lyht_insert(ht, &val, val_hash(val), NULL);
+    }
+    phase_print("remove/insert", start);
+    CALLGRIND_DUMP_STATS_AT("remove/insert");
+
+    start = now();
+    for (i = COUNT; i < 2 * COUNT; ++i) {
+        ret |= lyht_find(ht, &i, val_hash(i), NULL);
+    }
+    phase_print("find after mix", start);
+    CALLGRIND_DUMP_STATS_AT("find after mix");
+
+    start = now();
+    for (i = 0; i < COUNT; ++i) {
+        ret |= !lyht_find(ht, &i, val_hash(i), NULL);
+    }
+    phase_print("find removed", start);
+    CALLGRIND_DUMP_STATS_AT("find removed");
+
+    /* shrinking the table back */
+    start = now();
+    for (i = COUNT; i < 2 * COUNT; ++i) {
+        ret |= lyht_remove(ht, &i, val_hash(i));
+    }
+    phase_print("remove", start);
+    CALLGRIND_STOP_INSTRUMENTATION;
+
+    lyht_free(ht);
+    return ret ? 1 : 0;
+}
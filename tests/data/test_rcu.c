@@ -0,0 +1,266 @@
+/**
+ * @file test_rcu.c
+ * @brief Cmocka tests for publishing data tree versions to lock-free readers.
+ *
+ * Copyright (c) 2018 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <cmocka.h>
+
+#include "tests/config.h"
+#include "libyang.h"
+
+#define THREAD_COUNT 4
+#define VERSION_COUNT 50
+
+struct state {
+    struct ly_ctx *ctx;
+    const struct lys_module *mod;
+    struct lyd_rcu *rcu;
+};
+
+static const char *rcu_yang =
+"module rcu {"
+"  namespace urn:rcu;"
+"  prefix r;"
+"  container cont {"
+"    leaf ver { type uint32; }"
+"    leaf dflt { type string; default \"d\"; }"
+"    list item {"
+"      key name;"
+"      leaf name { type string; }"
+"    }"
+"  }"
+"}";
+
+static int
+setup_f(void **state)
+{
+    struct state *st;
+    struct lyd_node *root;
+
+    (*state) = st = calloc(1, sizeof *st);
+    if (!st) {
+        fprintf(stderr, "Memory allocation error");
+        return -1;
+    }
+
+    st->ctx = ly_ctx_new(NULL, 0);
+    if (!st->ctx) {
+        fprintf(stderr, "Failed to create context.\n");
+        goto error;
+    }
+
+    st->mod = lys_parse_mem(st->ctx, rcu_yang, LYS_IN_YANG);
+    if (!st->mod) {
+        fprintf(stderr, "Failed to load data module.\n");
+        goto error;
+    }
+
+    root = lyd_parse_mem(st->ctx, "<cont xmlns=\"urn:rcu\"><ver>0</ver></cont>", LYD_XML,
+                         LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    if (!root) {
+        fprintf(stderr, "Failed to parse data.\n");
+        goto error;
+    }
+
+    st->rcu = lyd_rcu_new(root);
+    if (!st->rcu) {
+        fprintf(stderr, "Failed to create RCU holder.\n");
+        lyd_free_withsiblings(root);
+        goto error;
+    }
+
+    return 0;
+
+error:
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st);
+    (*state) = NULL;
+
+    return -1;
+}
+
+static int
+teardown_f(void **state)
+{
+    struct state *st = (*state);
+
+    lyd_rcu_free(st->rcu);
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st);
+    (*state) = NULL;
+
+    return 0;
+}
+
+static uint32_t
+tree_version(const struct lyd_node *root)
+{
+    const struct lyd_node *node;
+
+    LY_TREE_FOR(root->child, node) {
+        if (!strcmp(node->schema->name, "ver")) {
+            return ((struct lyd_node_leaf_list *)node)->value.uint32;
+        }
+    }
+
+    /* called also by the reader threads, cannot fail() */
+    return UINT32_MAX;
+}
+
+static int
+publish_version(struct state *st, uint32_t ver)
+{
+    struct lyd_node *root, *node;
+    char buf[16];
+
+    if (lyd_rcu_dup(st->rcu, &root) || !root) {
+        return -1;
+    }
+
+    sprintf(buf, "%u", ver);
+    LY_TREE_FOR(root->child, node) {
+        if (!strcmp(node->schema->name, "ver")) {
+            break;
+        }
+    }
+    if (!node || lyd_change_leaf((struct lyd_node_leaf_list *)node, buf)) {
+        lyd_free_withsiblings(root);
+        return -1;
+    }
+
+    node = lyd_new(root, st->mod, "item");
+    if (!node || !lyd_new_leaf(node, st->mod, "name", buf)) {
+        lyd_free_withsiblings(root);
+        return -1;
+    }
+
+    if (lyd_rcu_publish(st->rcu, root)) {
+        lyd_free_withsiblings(root);
+        return -1;
+    }
+    return 0;
+}
+
+static void
+test_publish(void **state)
+{
+    struct state *st = (*state);
+    const struct lyd_node *old, *cur;
+    struct ly_set *set;
+    int ticket, ticket2;
+
+    /* the default nodes are there */
+    old = lyd_rcu_read_lock(st->rcu, &ticket);
+    assert_ptr_not_equal(old, NULL);
+    set = lyd_find_path(old, "/rcu:cont/dflt");
+    assert_ptr_not_equal(set, NULL);
+    assert_int_equal(set->number, 1);
+    ly_set_free(set);
+    assert_int_equal(tree_version(old), 0);
+
+    /* the reader keeps its version */
+    assert_int_equal(publish_version(st, 1), 0);
+    assert_int_equal(publish_version(st, 2), 0);
+    assert_int_equal(tree_version(old), 0);
+
+    cur = lyd_rcu_read_lock(st->rcu, &ticket2);
+    assert_ptr_not_equal(cur, old);
+    assert_int_equal(tree_version(cur), 2);
+    set = lyd_find_path(cur, "/rcu:cont/item");
+    assert_ptr_not_equal(set, NULL);
+    assert_int_equal(set->number, 2);
+    ly_set_free(set);
+    lyd_rcu_read_unlock(st->rcu, ticket2);
+
+    lyd_rcu_read_unlock(st->rcu, ticket);
+    lyd_rcu_synchronize(st->rcu);
+
+    /* empty tree */
+    assert_int_equal(lyd_rcu_publish(st->rcu, NULL), 0);
+    assert_ptr_equal(lyd_rcu_read_lock(st->rcu, &ticket), NULL);
+    lyd_rcu_read_unlock(st->rcu, ticket);
+    assert_int_equal(lyd_rcu_dup(st->rcu, (struct lyd_node **)&cur), 0);
+    assert_ptr_equal(cur, NULL);
+}
+
+static void *
+read_thread(void *arg)
+{
+    struct state *st = arg;
+    const struct lyd_node *root;
+    struct ly_set *set;
+    uint32_t ver, last = 0;
+    int i, ticket;
+
+    for (i = 0; i < 200; ++i) {
+        root = lyd_rcu_read_lock(st->rcu, &ticket);
+        if (!root) {
+            return (void *)1;
+        }
+
+        /* versions are published in order and every one is consistent */
+        ver = tree_version(root);
+        set = lyd_find_path(root, "/rcu:cont/item");
+        if ((ver < last) || !set || (set->number != ver)) {
+            ly_set_free(set);
+            lyd_rcu_read_unlock(st->rcu, ticket);
+            return (void *)1;
+        }
+        last = ver;
+
+        ly_set_free(set);
+        lyd_rcu_read_unlock(st->rcu, ticket);
+    }
+
+    return NULL;
+}
+
+static void
+test_threads(void **state)
+{
+    struct state *st = (*state);
+    pthread_t threads[THREAD_COUNT];
+    void *ret;
+    uint32_t ver;
+    int i;
+
+    for (i = 0; i < THREAD_COUNT; ++i) {
+        assert_int_equal(pthread_create(&threads[i], NULL, read_thread, st), 0);
+    }
+
+    /* the writer never waits for the readers */
+    for (ver = 1; ver <= VERSION_COUNT; ++ver) {
+        assert_int_equal(publish_version(st, ver), 0);
+    }
+
+    for (i = 0; i < THREAD_COUNT; ++i) {
+        assert_int_equal(pthread_join(threads[i], &ret), 0);
+        assert_ptr_equal(ret, NULL);
+    }
+    lyd_rcu_synchronize(st->rcu);
+}
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_publish, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_threads, setup_f, teardown_f),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
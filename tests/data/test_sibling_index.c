@@ -0,0 +1,191 @@
+/**
+ * @file test_sibling_index.c
+ * @brief Cmocka tests for finding data nodes in the schema among many siblings.
+ *
+ * Copyright (c) 2016 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <cmocka.h>
+
+#include "tests/config.h"
+#include "libyang.h"
+
+struct state {
+    struct ly_ctx *ctx;
+    const struct lys_module *mod;
+    struct lyd_node *dt;
+};
+
+static const char *wide_yang =
+"module wide {"
+"  namespace urn:wide;"
+"  prefix w;"
+"  feature f;"
+"  grouping g {"
+"    leaf gl { type string; }"
+"  }"
+"  leaf t0 { type string; } leaf t1 { type string; } leaf t2 { type string; } leaf t3 { type string; }"
+"  leaf t4 { type string; } leaf t5 { type string; } leaf t6 { type string; } leaf t7 { type string; }"
+"  container top {"
+"    leaf l0 { type string; } leaf l1 { type string; } leaf l2 { type string; } leaf l3 { type string; }"
+"    leaf l4 { type string; } leaf l5 { type string; } leaf l6 { type string; } leaf l7 { type string; }"
+"    choice ch {"
+"      case a {"
+"        leaf ca { type string; }"
+"      }"
+"      leaf cb { type string; }"
+"    }"
+"    uses g;"
+"    leaf feat { if-feature f; type string; }"
+"  }"
+"}";
+
+static const char *wide_aug_yang =
+"module wide-aug {"
+"  namespace urn:wide-aug;"
+"  prefix wa;"
+"  import wide { prefix w; }"
+"  augment /w:top {"
+"    leaf l0 { type string; }"
+"  }"
+"}";
+
+static int
+setup_f(void **state)
+{
+    struct state *st;
+
+    (*state) = st = calloc(1, sizeof *st);
+    if (!st) {
+        fprintf(stderr, "Memory allocation error");
+        return -1;
+    }
+
+    /* libyang context */
+    st->ctx = ly_ctx_new(NULL, 0);
+    if (!st->ctx) {
+        fprintf(stderr, "Failed to create context.\n");
+        goto error;
+    }
+
+    st->mod = lys_parse_mem(st->ctx, wide_yang, LYS_IN_YANG);
+    if (!st->mod) {
+        fprintf(stderr, "Failed to load data module.\n");
+        goto error;
+    }
+
+    return 0;
+
+error:
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st);
+    (*state) = NULL;
+
+    return -1;
+}
+
+static int
+teardown_f(void **state)
+{
+    struct state *st = (*state);
+
+    lyd_free_withsiblings(st->dt);
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st);
+    (*state) = NULL;
+
+    return 0;
+}
+
+static void
+test_parse(void **state)
+{
+    struct state *st = (struct state *)*state;
+    const char *xml = "<top xmlns=\"urn:wide\"><l7>a</l7><ca>b</ca><gl>c</gl></top><t7 xmlns=\"urn:wide\">d</t7>";
+    const char *json = "{\"wide:top\":{\"l7\":\"a\",\"cb\":\"b\",\"gl\":\"c\"},\"wide:t6\":\"d\"}";
+
+    st->dt = lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_string_equal(st->dt->child->next->schema->name, "ca");
+    assert_string_equal(st->dt->next->schema->name, "t7");
+    lyd_free_withsiblings(st->dt);
+
+    st->dt = lyd_parse_mem(st->ctx, json, LYD_JSON, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_string_equal(st->dt->child->next->schema->name, "cb");
+    assert_string_equal(st->dt->child->next->next->schema->name, "gl");
+    lyd_free_withsiblings(st->dt);
+    st->dt = NULL;
+
+    /* unknown node */
+    assert_ptr_equal(lyd_parse_mem(st->ctx, "<top xmlns=\"urn:wide\"><l8>a</l8></top>", LYD_XML,
+                                   LYD_OPT_CONFIG | LYD_OPT_STRICT), NULL);
+    assert_ptr_equal(lyd_parse_mem(st->ctx, "{\"wide:top\":{\"l8\":\"a\"}}", LYD_JSON, LYD_OPT_CONFIG | LYD_OPT_STRICT), NULL);
+}
+
+static void
+test_feature(void **state)
+{
+    struct state *st = (struct state *)*state;
+
+    st->dt = lyd_new(NULL, st->mod, "top");
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_ptr_not_equal(lyd_new_leaf(st->dt, st->mod, "l3", "a"), NULL);
+    assert_ptr_equal(lyd_new_leaf(st->dt, st->mod, "feat", "a"), NULL);
+
+    assert_int_equal(lys_features_enable(st->mod, "f"), 0);
+    assert_ptr_not_equal(lyd_new_leaf(st->dt, st->mod, "feat", "a"), NULL);
+
+    assert_int_equal(lys_features_disable(st->mod, "f"), 0);
+    assert_ptr_equal(lyd_new_leaf(st->dt, st->mod, "feat", "b"), NULL);
+}
+
+static void
+test_schema_change(void **state)
+{
+    struct state *st = (struct state *)*state;
+    const char *xml = "<top xmlns=\"urn:wide\"><l0>a</l0><l0 xmlns=\"urn:wide-aug\">b</l0></top>";
+    const struct lys_module *aug;
+
+    assert_ptr_not_equal(ly_ctx_get_node(st->ctx, NULL, "/wide:top/l0", 0), NULL);
+    assert_ptr_equal(ly_ctx_get_node(st->ctx, NULL, "/wide:top/wide-aug:l0", 0), NULL);
+    assert_ptr_equal(lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT), NULL);
+
+    /* the augment adds a node with the same name from another module */
+    aug = lys_parse_mem(st->ctx, wide_aug_yang, LYS_IN_YANG);
+    assert_ptr_not_equal(aug, NULL);
+    assert_ptr_not_equal(ly_ctx_get_node(st->ctx, NULL, "/wide:top/wide-aug:l0", 0), NULL);
+
+    st->dt = lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_ptr_equal(lyd_node_module(st->dt->child->next), aug);
+    assert_ptr_not_equal(lyd_new_leaf(st->dt, aug, "l0", "c"), NULL);
+    lyd_free_withsiblings(st->dt);
+    st->dt = NULL;
+
+    /* and it is gone again */
+    assert_int_equal(ly_ctx_remove_module(aug, NULL), 0);
+    assert_ptr_equal(ly_ctx_get_node(st->ctx, NULL, "/wide:top/wide-aug:l0", 0), NULL);
+    assert_ptr_equal(lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT), NULL);
+}
+
+int main(void)
+{
+    const struct CMUnitTest tests[] = {
+                    cmocka_unit_test_setup_teardown(test_parse, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_feature, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_schema_change, setup_f, teardown_f)
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
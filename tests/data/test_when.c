@@ -305,6 +305,64 @@ test_action(void **state)
     assert_non_null(st->act);
 }
 
+static void
+test_augment_shared(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct ly_set *set;
+    const char *yang =
+    "module when-shared {"
+    "  namespace urn:libyang:tests:when-shared;"
+    "  prefix ws;"
+    "  container top {"
+    "    list item {"
+    "      key name;"
+    "      leaf name { type string; }"
+    "      leaf type { type string; }"
+    "    }"
+    "  }"
+    "  augment /top/item {"
+    "    when \"type = 'a'\";"
+    "    leaf x { type string; }"
+    "    leaf y { type string; }"
+    "    leaf z { type string; }"
+    "  }"
+    "}";
+    const char *xml =
+    "<top xmlns=\"urn:libyang:tests:when-shared\">"
+      "<item><name>1</name><type>a</type><x>x</x><y>y</y><z>z</z></item>"
+      "<item><name>2</name><type>b</type></item>"
+      "<item><name>3</name><type>a</type><x>x</x><z>z</z></item>"
+    "</top>";
+
+    st->mod2 = lys_parse_mem(st->ctx, yang, LYS_IN_YANG);
+    assert_ptr_not_equal(st->mod2, NULL);
+
+    /* the condition is evaluated for every list instance separately */
+    st->dt = lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_ptr_not_equal(lyd_new_path(st->dt, NULL, "/when-shared:top/item[name='2']/y", "y", 0, 0), NULL);
+    assert_int_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 1);
+    assert_int_equal(ly_vecode(st->ctx), LYVE_NOWHEN);
+
+    /* all the nodes of the augment are deleted */
+    set = lyd_find_path(st->dt, "/when-shared:top/item[name='2']/y");
+    assert_ptr_not_equal(set, NULL);
+    assert_int_equal(set->number, 1);
+    lyd_free(set->set.d[0]);
+    ly_set_free(set);
+    assert_int_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 0);
+    assert_int_equal(lyd_change_leaf((struct lyd_node_leaf_list *)st->dt->child->child->next, "b"), 0);
+    assert_int_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG | LYD_OPT_WHENAUTODEL, NULL), 0);
+
+    set = lyd_find_path(st->dt, "/when-shared:top/item/*[local-name() != 'name' and local-name() != 'type']");
+    assert_ptr_not_equal(set, NULL);
+    assert_int_equal(set->number, 2);
+    assert_string_equal(set->set.d[0]->parent->child->schema->name, "name");
+    assert_string_equal(((struct lyd_node_leaf_list *)set->set.d[0]->parent->child)->value_str, "3");
+    ly_set_free(set);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -316,6 +374,7 @@ int main(void)
                     cmocka_unit_test_setup_teardown(test_value_prefix, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_augment_choice, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_action, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_augment_shared, setup_f, teardown_f),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -15,12 +15,14 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <setjmp.h>
 #include <cmocka.h>
 
 #include "tests/config.h"
 #include "libyang.h"
 #include "hash_table.h"
+#include "context.h"
 
 static struct hash_table *ht;
 
@@ -175,6 +177,8 @@ test_resize(void **state)
 
 #define GET_REC_VAL(rec) (*((int *)&(rec)->val))
 
+#ifndef LY_ENABLED_HT_ROBIN_HOOD
+
 static void
 test_collisions(void **state)
 {
@@ -310,6 +314,85 @@ test_invalid_move(void **state)
     assert_int_equal(rec->hits, 1);
 }
 
+#else
+
+static void
+check_recs(const int *vals, const int *hits)
+{
+    struct ht_rec *rec;
+    uint32_t i;
+
+    for (i = 0; i < ht->size; ++i) {
+        rec = lyht_get_rec(ht->recs, ht->rec_size, i);
+        assert_int_equal(rec->hits, hits[i]);
+        if (hits[i]) {
+            assert_int_equal(GET_REC_VAL(rec), vals[i]);
+        }
+    }
+}
+
+static void
+test_collisions(void **state)
+{
+    int i;
+    (void)state;
+
+    for (i = 2; i < 6; ++i) {
+        assert_int_equal(lyht_insert(ht, &i, 2, NULL), 0);
+    }
+    check_recs((int []){0, 0, 2, 3, 4, 5, 0, 0}, (int []){0, 0, 1, 2, 3, 4, 0, 0});
+
+    /* the value with the next hash is stored after all the ones with hash 2 */
+    i = 6;
+    assert_int_equal(lyht_insert(ht, &i, 3, NULL), 0);
+    check_recs((int []){0, 0, 2, 3, 4, 5, 6, 0}, (int []){0, 0, 1, 2, 3, 4, 4, 0});
+
+    /* and it is moved by another value with hash 2 */
+    i = 7;
+    assert_int_equal(lyht_insert(ht, &i, 2, NULL), 0);
+    check_recs((int []){0, 0, 2, 3, 4, 5, 7, 6}, (int []){0, 0, 1, 2, 3, 4, 5, 5});
+
+    for (i = 2; i < 8; ++i) {
+        assert_int_equal(lyht_find(ht, &i, (i == 6) ? 3 : 2, NULL), 0);
+    }
+    i = 6;
+    assert_int_equal(lyht_find(ht, &i, 2, NULL), 1);
+
+    /* removal moves all the following records back */
+    i = 3;
+    assert_int_equal(lyht_remove(ht, &i, 2), 0);
+    check_recs((int []){0, 0, 2, 4, 5, 7, 6, 0}, (int []){0, 0, 1, 2, 3, 4, 4, 0});
+    assert_int_equal(lyht_find(ht, &i, 2, NULL), 1);
+    i = 6;
+    assert_int_equal(lyht_find(ht, &i, 3, NULL), 0);
+
+    for (i = 2; i < 8; ++i) {
+        assert_int_equal(lyht_remove(ht, &i, (i == 6) ? 3 : 2), (i == 3) ? 1 : 0);
+    }
+    check_recs((int []){0, 0, 0, 0, 0, 0, 0, 0}, (int []){0, 0, 0, 0, 0, 0, 0, 0});
+}
+
+static void
+test_wrap(void **state)
+{
+    int i;
+    (void)state;
+
+    for (i = 0; i < 3; ++i) {
+        assert_int_equal(lyht_insert(ht, &i, 7, NULL), 0);
+    }
+    check_recs((int []){1, 2, 0, 0, 0, 0, 0, 0}, (int []){2, 3, 0, 0, 0, 0, 0, 1});
+
+    i = 0;
+    assert_int_equal(lyht_remove(ht, &i, 7), 0);
+    check_recs((int []){2, 0, 0, 0, 0, 0, 0, 1}, (int []){2, 0, 0, 0, 0, 0, 0, 1});
+
+    i = 2;
+    assert_int_equal(lyht_find(ht, &i, 7, NULL), 0);
+}
+
+#endif
+
 static void
 test_invalid_move2(void **state)
 {
@@ -353,6 +436,118 @@ test_invalid_move2(void **state)
     assert_int_equal(lyht_find(ht, &a[8 + 3], 3, NULL), 0);
 }
 
+static void
+test_dict_str(void **state)
+{
+    struct ly_ctx *ctx;
+    const char *str1, *str2, *str3;
+    char *buf;
+    (void)state;
+
+    ctx = ly_ctx_new(NULL, 0);
+    assert_non_null(ctx);
+
+    /* the hash and length are stored with the string */
+    str1 = lydict_insert(ctx, "interface-name", 9);
+    assert_string_equal(str1, "interface");
+    assert_int_equal(lydict_len(str1), 9);
+    assert_int_equal(lydict_hash_multi(0, str1), dict_hash_multi_str(0, "interface-name", 9));
+    str2 = lydict_insert(ctx, "interface", 0);
+    assert_ptr_equal(str1, str2);
+
+    /* a prefix is a different string */
+    str3 = lydict_insert(ctx, "inter", 0);
+    assert_ptr_not_equal(str1, str3);
+    assert_int_equal(lydict_len(str3), 5);
+    assert_int_not_equal(lydict_hash(str1), lydict_hash(str3));
+
+    /* zerocopy strings get them, too */
+    buf = strdup("zerocopy");
+    assert_non_null(buf);
+    str2 = lydict_insert_zc(ctx, buf);
+    assert_string_equal(str2, "zerocopy");
+    assert_int_equal(lydict_len(str2), 8);
+    assert_int_equal(lydict_hash(str2), lydict_hash(lydict_insert(ctx, "zerocopy", 0)));
+    buf = strdup("zerocopy");
+    assert_non_null(buf);
+    assert_ptr_equal(lydict_insert_zc(ctx, buf), str2);
+
+    lydict_remove(ctx, str1);
+    lydict_remove(ctx, str1);
+    lydict_remove(ctx, str3);
+    lydict_remove(ctx, str2);
+    lydict_remove(ctx, str2);
+    lydict_remove(ctx, str2);
+    ly_ctx_destroy(ctx, NULL);
+}
+
+static uint32_t
+dict_refcount(struct ly_ctx *ctx, const char *value)
+{
+    struct dict_rec rec, *match = NULL;
+    size_t len = strlen(value);
+
+    rec.value = (char *)value;
+    rec.refcount = 0;
+    lyht_set_cb_data(ctx->dict.hash_tab, &len);
+    if (lyht_find(ctx->dict.hash_tab, &rec, dict_hash_multi(dict_hash_multi(0, value, len), NULL, 0), (void **)&match)) {
+        return 0;
+    }
+    return match->refcount;
+}
+
+static void
+test_dict_batch(void **state)
+{
+    struct ly_ctx *ctx, *ctx2;
+    struct dict_batch batch, batch2;
+    const char *str1, *str2;
+    (void)state;
+
+    ctx = ly_ctx_new(NULL, 0);
+    assert_non_null(ctx);
+    ctx2 = ly_ctx_new(NULL, 0);
+    assert_non_null(ctx2);
+
+    str1 = lydict_insert(ctx, "batched", 0);
+    str2 = lydict_insert(ctx2, "batched", 0);
+    assert_int_equal(dict_refcount(ctx, "batched"), 1);
+
+    /* the changes are postponed until the outermost batch ends */
+    lydict_batch_start(ctx, &batch);
+    assert_ptr_equal(lydict_ref(ctx, str1), str1);
+    assert_int_equal(dict_refcount(ctx, "batched"), 1);
+    lydict_batch_start(ctx, &batch2);
+    lydict_remove(ctx, str1);
+    lydict_remove(ctx, str1);
+    lydict_batch_end(ctx);
+    assert_int_equal(dict_refcount(ctx, "batched"), 1);
+    assert_string_equal(str1, "batched");
+
+    /* inserting is never postponed */
+    assert_ptr_equal(lydict_insert(ctx, "batched", 0), str1);
+    assert_int_equal(dict_refcount(ctx, "batched"), 2);
+
+    /* other contexts are not batched */
+    lydict_batch_start(ctx2, &batch2);
+    lydict_remove(ctx2, str2);
+    assert_int_equal(dict_refcount(ctx2, "batched"), 0);
+    lydict_batch_end(ctx2);
+
+    lydict_batch_end(ctx);
+    assert_int_equal(dict_refcount(ctx, "batched"), 1);
+
+    /* the string is freed when the batch ends */
+    lydict_batch_start(ctx, &batch);
+    lydict_remove(ctx, str1);
+    assert_int_equal(dict_refcount(ctx, "batched"), 1);
+    lydict_batch_end(ctx);
+    assert_int_equal(dict_refcount(ctx, "batched"), 0);
+
+    ly_ctx_destroy(ctx2, NULL);
+    ly_ctx_destroy(ctx, NULL);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -360,8 +555,14 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_half_full, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_resize, setup_f_resize, teardown_f),
         cmocka_unit_test_setup_teardown(test_collisions, setup_f, teardown_f),
+#ifndef LY_ENABLED_HT_ROBIN_HOOD
         cmocka_unit_test_setup_teardown(test_invalid_move, setup_f, teardown_f),
+#else
+        cmocka_unit_test_setup_teardown(test_wrap, setup_f, teardown_f),
+#endif
         cmocka_unit_test_setup_teardown(test_invalid_move2, setup_f, teardown_f),
+        cmocka_unit_test(test_dict_str),
+        cmocka_unit_test(test_dict_batch),
     };
 
     //ly_verb(LY_LLDBG);
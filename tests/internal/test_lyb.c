@@ -658,6 +658,228 @@ test_leafrefs(void **state)
     check_data_tree(st->dt1, st->dt2);
 }
 
+static void
+test_module_set_change(void **state)
+{
+    struct state *st = (*state);
+    int ret;
+
+    ly_ctx_set_searchdir(st->ctx, TESTS_DIR"/data/files");
+    assert_non_null(ly_ctx_load_module(st->ctx, "augment-target", NULL));
+
+    st->dt1 = lyd_parse_mem(st->ctx, "<cont xmlns=\"urn:augment\"><cont-leaf>str</cont-leaf></cont>", LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt1, NULL);
+
+    ret = lyd_print_mem(&st->mem, st->dt1, LYD_LYB, LYP_WITHSIBLINGS);
+    assert_int_equal(ret, 0);
+
+    st->dt2 = lyd_parse_mem(st->ctx, st->mem, LYD_LYB, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(st->dt2, NULL);
+
+    check_data_tree(st->dt1, st->dt2);
+    lyd_free_withsiblings(st->dt1);
+    lyd_free_withsiblings(st->dt2);
+    free(st->mem);
+    st->mem = NULL;
+
+    /* the augments add new siblings, the sibling hashes must not be reused */
+    assert_non_null(ly_ctx_load_module(st->ctx, "augment0", NULL));
+    assert_non_null(ly_ctx_load_module(st->ctx, "augment1", NULL));
+
+    st->dt1 = lyd_parse_path(st->ctx, TESTS_DIR"/data/files/augment.xml", LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt1, NULL);
+
+    ret = lyd_print_mem(&st->mem, st->dt1, LYD_LYB, LYP_WITHSIBLINGS);
+    assert_int_equal(ret, 0);
+
+    st->dt2 = lyd_parse_mem(st->ctx, st->mem, LYD_LYB, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(st->dt2, NULL);
+
+    check_data_tree(st->dt1, st->dt2);
+}
+
+static void
+test_stream(void **state)
+{
+    struct state *st = (*state);
+    const struct lys_module *mod;
+    struct lyd_node *node;
+    char value[1001];
+    int ret;
+    const char *test_stream =
+    "module test-stream {"
+    "   namespace \"urn:test-stream\";"
+    "   prefix ts;"
+    ""
+    "   feature f;"
+    ""
+    "   container cont {"
+    "       leaf long {"
+    "           type string;"
+    "       }"
+    "       anydata any;"
+    "       list l {"
+    "           if-feature f;"
+    "           key k;"
+    "           leaf k {"
+    "               type uint32;"
+    "           }"
+    "       }"
+    "   }"
+    "}";
+
+    ly_ctx_set_searchdir(st->ctx, TESTS_DIR"/data/files");
+    assert_non_null(ly_ctx_load_module(st->ctx, "annotations", NULL));
+
+    /* attributes */
+    st->dt1 = lyd_parse_path(st->ctx, TESTS_DIR"/data/files/annotations.xml", LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt1, NULL);
+
+    ret = lyd_print_mem(&st->mem, st->dt1, LYD_LYB, LYP_WITHSIBLINGS | LYP_STREAM);
+    assert_int_equal(ret, 0);
+    assert_int_equal(st->mem[3] & LYB_HEADER_STREAM, LYB_HEADER_STREAM);
+
+    st->dt2 = lyd_parse_mem(st->ctx, st->mem, LYD_LYB, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(st->dt2, NULL);
+
+    check_data_tree(st->dt1, st->dt2);
+    lyd_free_withsiblings(st->dt1);
+    lyd_free_withsiblings(st->dt2);
+    free(st->mem);
+    st->mem = NULL;
+
+    /* values and subtrees larger than a single data segment */
+    mod = lys_parse_mem(st->ctx, test_stream, LYS_YANG);
+    assert_non_null(mod);
+    assert_int_equal(lys_features_enable(mod, "f"), 0);
+
+    memset(value, 'a', 1000);
+    value[1000] = '\0';
+    st->dt1 = lyd_new(NULL, mod, "cont");
+    assert_non_null(st->dt1);
+    assert_non_null(lyd_new_leaf(st->dt1, mod, "long", value));
+    assert_non_null(lyd_new_anydata(st->dt1, mod, "any", value, LYD_ANYDATA_CONSTSTRING));
+    for (ret = 0; ret < 300; ++ret) {
+        sprintf(value, "%d", ret);
+        node = lyd_new(st->dt1, mod, "l");
+        assert_non_null(node);
+        assert_non_null(lyd_new_leaf(node, mod, "k", value));
+    }
+    assert_int_equal(lyd_validate(&st->dt1, LYD_OPT_CONFIG, NULL), 0);
+
+    ret = lyd_print_mem(&st->mem, st->dt1, LYD_LYB, LYP_WITHSIBLINGS | LYP_STREAM);
+    assert_int_equal(ret, 0);
+
+    st->dt2 = lyd_parse_mem(st->ctx, st->mem, LYD_LYB, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(st->dt2, NULL);
+
+    check_data_tree(st->dt1, st->dt2);
+
+    /* the length is known without parsing the data */
+    ret = lyd_lyb_data_length(st->mem);
+    assert_int_not_equal(ret, -1);
+    assert_int_equal(st->mem[ret - 1], 0);
+
+    /* unknown subtrees are skipped */
+    lyd_free_withsiblings(st->dt2);
+    assert_int_equal(lys_features_disable(mod, "f"), 0);
+    st->dt2 = lyd_parse_mem(st->ctx, st->mem, LYD_LYB, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt2, NULL);
+    assert_string_equal(st->dt2->child->prev->schema->name, "any");
+}
+
+static void
+test_str_table(void **state)
+{
+    struct state *st = (*state);
+    const struct lys_module *mod;
+    struct lyd_node *node;
+    char key[16];
+    char *mem;
+    int ret, len, i;
+    const char *test_strtable =
+    "module test-strtable {"
+    "   namespace \"urn:test-strtable\";"
+    "   prefix ts;"
+    ""
+    "   list l {"
+    "       key k;"
+    "       leaf k {"
+    "           type string;"
+    "       }"
+    "       leaf state {"
+    "           type string;"
+    "       }"
+    "       leaf u {"
+    "           type union {"
+    "               type uint8;"
+    "               type string;"
+    "           }"
+    "       }"
+    "   }"
+    "}";
+
+    ly_ctx_set_searchdir(st->ctx, TESTS_DIR"/data/files");
+    assert_non_null(ly_ctx_load_module(st->ctx, "annotations", NULL));
+
+    /* attributes, in both variants */
+    st->dt1 = lyd_parse_path(st->ctx, TESTS_DIR"/data/files/annotations.xml", LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt1, NULL);
+
+    ret = lyd_print_mem(&st->mem, st->dt1, LYD_LYB, LYP_WITHSIBLINGS | LYP_STRTABLE);
+    assert_int_equal(ret, 0);
+    st->dt2 = lyd_parse_mem(st->ctx, st->mem, LYD_LYB, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(st->dt2, NULL);
+    check_data_tree(st->dt1, st->dt2);
+    lyd_free_withsiblings(st->dt2);
+    free(st->mem);
+
+    ret = lyd_print_mem(&st->mem, st->dt1, LYD_LYB, LYP_WITHSIBLINGS | LYP_STRTABLE | LYP_STREAM);
+    assert_int_equal(ret, 0);
+    st->dt2 = lyd_parse_mem(st->ctx, st->mem, LYD_LYB, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(st->dt2, NULL);
+    check_data_tree(st->dt1, st->dt2);
+    lyd_free_withsiblings(st->dt1);
+    lyd_free_withsiblings(st->dt2);
+    free(st->mem);
+    st->mem = NULL;
+
+    /* many repeated values */
+    mod = lys_parse_mem(st->ctx, test_strtable, LYS_YANG);
+    assert_non_null(mod);
+
+    st->dt1 = NULL;
+    for (i = 0; i < 100; ++i) {
+        sprintf(key, "key%d", i);
+        node = lyd_new(NULL, mod, "l");
+        assert_non_null(node);
+        assert_non_null(lyd_new_leaf(node, mod, "k", key));
+        assert_non_null(lyd_new_leaf(node, mod, "state", (i % 2) ? "up-and-running" : "down"));
+        assert_non_null(lyd_new_leaf(node, mod, "u", (i % 3) ? "unknown" : "42"));
+        if (st->dt1) {
+            assert_int_equal(lyd_insert_after(st->dt1->prev, node), 0);
+        } else {
+            st->dt1 = node;
+        }
+    }
+    assert_int_equal(lyd_validate(&st->dt1, LYD_OPT_CONFIG, NULL), 0);
+
+    ret = lyd_print_mem(&mem, st->dt1, LYD_LYB, LYP_WITHSIBLINGS);
+    assert_int_equal(ret, 0);
+    len = lyd_lyb_data_length(mem);
+    free(mem);
+
+    ret = lyd_print_mem(&st->mem, st->dt1, LYD_LYB, LYP_WITHSIBLINGS | LYP_STRTABLE);
+    assert_int_equal(ret, 0);
+    ret = lyd_lyb_data_length(st->mem);
+    assert_int_not_equal(ret, -1);
+    assert_true(ret < len);
+
+    st->dt2 = lyd_parse_mem(st->ctx, st->mem, LYD_LYB, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(st->dt2, NULL);
+    check_data_tree(st->dt1, st->dt2);
+}
+
 int
 main(void)
 {
@@ -676,6 +898,9 @@ main(void)
         cmocka_unit_test_setup_teardown(test_submodule_feature, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_coliding_augments, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_leafrefs, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_module_set_change, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_stream, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_str_table, setup_f, teardown_f),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -0,0 +1,394 @@
+/**
+ * @file test_patterns.c
+ * @brief Cmocka tests for compiling the string type patterns on demand and sharing them.
+ *
+ * Copyright (c) 2018 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <cmocka.h>
+
+#include "libyang.h"
+#include "tree_internal.h"
+#include "parser.h"
+#include "context.h"
+#include "tests/config.h"
+
+#define THREAD_COUNT 4
+
+struct state {
+    struct ly_ctx *ctx;
+    const struct lys_module *mod;
+};
+
+static const char *pat_yang =
+"module pat {"
+"  namespace urn:pat;"
+"  prefix p;"
+"  grouping g {"
+"    leaf gl { type string { pattern '[a-z]+'; } }"
+"  }"
+"  container c1 { uses g; }"
+"  container c2 { uses g; }"
+"  leaf l { type string { pattern '[0-9]+'; } }"
+"}";
+
+#ifdef LY_ENABLED_CACHE
+
+static const char *multi_yang =
+"module multi {"
+"  yang-version 1.1;"
+"  namespace urn:multi;"
+"  prefix m;"
+"  typedef base { type string { pattern '[a-z0-9]+'; } }"
+"  typedef der { type base { pattern '[a-z].*'; } }"
+"  leaf d1 { type der { pattern '.*[0-9]' { modifier invert-match; } } }"
+"  leaf d2 { type der; }"
+"  leaf d3 { type der; }"
+"  leaf u { type union { type der; type string { pattern '[0-9]+'; } type int8; type string; } }"
+"  leaf u2 { type union { type int8; type der; } }"
+"}";
+
+#endif
+
+static const char *pat_xml =
+"<c1 xmlns=\"urn:pat\"><gl>abc</gl></c1>"
+"<c2 xmlns=\"urn:pat\"><gl>def</gl></c2>"
+"<l xmlns=\"urn:pat\">42</l>";
+
+static int
+setup_ctx(void **state, int options)
+{
+    struct state *st;
+
+    (*state) = st = calloc(1, sizeof *st);
+    if (!st) {
+        fprintf(stderr, "Memory allocation error");
+        return -1;
+    }
+
+    st->ctx = ly_ctx_new(NULL, options);
+    if (!st->ctx) {
+        fprintf(stderr, "Failed to create context.\n");
+        goto error;
+    }
+
+    st->mod = lys_parse_mem(st->ctx, pat_yang, LYS_IN_YANG);
+    if (!st->mod) {
+        fprintf(stderr, "Failed to load data module.\n");
+        goto error;
+    }
+
+    return 0;
+
+error:
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st);
+    (*state) = NULL;
+
+    return -1;
+}
+
+static int
+setup_f(void **state)
+{
+    return setup_ctx(state, 0);
+}
+
+static int
+setup_trusted_f(void **state)
+{
+    return setup_ctx(state, LY_CTX_TRUSTED);
+}
+
+static int
+setup_multi_f(void **state)
+{
+    return setup_ctx(state, LY_CTX_MULTI_PATTERN);
+}
+
+static int
+teardown_f(void **state)
+{
+    struct state *st = (*state);
+
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st);
+    (*state) = NULL;
+
+    return 0;
+}
+
+#ifdef LY_ENABLED_CACHE
+
+static void **
+pat_pcre(struct state *st, const char *path)
+{
+    const struct lys_node *node;
+
+    node = ly_ctx_get_node(st->ctx, NULL, path, 0);
+    assert_ptr_not_equal(node, NULL);
+    return ((struct lys_node_leaf *)node)->type.info.str.patterns_pcre;
+}
+
+static void *
+pat_multi(struct state *st, const char *path)
+{
+    const struct lys_node *node;
+
+    node = ly_ctx_get_node(st->ctx, NULL, path, 0);
+    assert_ptr_not_equal(node, NULL);
+    return lyp_multi_pattern_find(st->ctx, &((struct lys_node_leaf *)node)->type);
+}
+
+static void
+test_uses(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *root;
+
+    /* patterns of the grouping instances are not compiled when loading the schema */
+    assert_ptr_equal(pat_pcre(st, "/pat:c1/gl"), NULL);
+    assert_ptr_equal(pat_pcre(st, "/pat:c2/gl"), NULL);
+    assert_ptr_not_equal(pat_pcre(st, "/pat:l"), NULL);
+
+    /* only when used */
+    root = lyd_parse_mem(st->ctx, "<c1 xmlns=\"urn:pat\"><gl>abc</gl></c1>", LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(root, NULL);
+    assert_ptr_not_equal(pat_pcre(st, "/pat:c1/gl"), NULL);
+    assert_ptr_equal(pat_pcre(st, "/pat:c2/gl"), NULL);
+    lyd_free_withsiblings(root);
+
+    root = lyd_parse_mem(st->ctx, pat_xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(root, NULL);
+    assert_ptr_not_equal(pat_pcre(st, "/pat:c2/gl"), NULL);
+    lyd_free_withsiblings(root);
+
+    /* patterns are combined only on request */
+    assert_ptr_equal(pat_multi(st, "/pat:c2/gl"), NULL);
+}
+
+static void
+test_trusted(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *root;
+
+    /* trusted schema patterns are not compiled at all */
+    assert_ptr_equal(pat_pcre(st, "/pat:c1/gl"), NULL);
+    assert_ptr_equal(pat_pcre(st, "/pat:l"), NULL);
+
+    root = lyd_parse_mem(st->ctx, pat_xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(root, NULL);
+    assert_ptr_not_equal(pat_pcre(st, "/pat:c1/gl"), NULL);
+    assert_ptr_not_equal(pat_pcre(st, "/pat:l"), NULL);
+    lyd_free_withsiblings(root);
+}
+
+static void
+test_shared(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *root;
+    const char *pat2_yang =
+    "module pat2 {"
+    "  yang-version 1.1;"
+    "  namespace urn:pat2;"
+    "  prefix p2;"
+    "  leaf l { type string { pattern '[0-9]+'; } }"
+    "  leaf inv { type string { pattern '[0-9]+' { modifier invert-match; } } }"
+    "}";
+
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, pat2_yang, LYS_IN_YANG), NULL);
+
+    /* the same pattern is compiled only once for all the modules */
+    assert_ptr_equal(pat_pcre(st, "/pat:l")[0], pat_pcre(st, "/pat2:l")[0]);
+    assert_ptr_equal(pat_pcre(st, "/pat:l")[1], pat_pcre(st, "/pat2:l")[1]);
+    assert_ptr_equal(pat_pcre(st, "/pat:l")[0], pat_pcre(st, "/pat2:inv")[0]);
+
+    /* and for all the grouping instances */
+    root = lyd_parse_mem(st->ctx, pat_xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(root, NULL);
+    assert_ptr_equal(pat_pcre(st, "/pat:c1/gl")[0], pat_pcre(st, "/pat:c2/gl")[0]);
+    assert_ptr_not_equal(pat_pcre(st, "/pat:c1/gl")[0], pat_pcre(st, "/pat:l")[0]);
+    lyd_free_withsiblings(root);
+
+    /* removing a module does not affect the others */
+    assert_int_equal(ly_ctx_remove_module(ly_ctx_get_module(st->ctx, "pat2", NULL, 0), NULL), 0);
+    root = lyd_parse_mem(st->ctx, pat_xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(root, NULL);
+    lyd_free_withsiblings(root);
+}
+
+static void
+test_remove(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *root;
+    uint32_t used, multi_used;
+    const char *rm_yang =
+    "module rm {"
+    "  namespace urn:rm;"
+    "  prefix r;"
+    "  leaf own { type string { pattern '[x-z]+'; } }"
+    "  leaf u { type union { type string { pattern '[x-z]+'; } type string { pattern '[0-9]+'; } } }"
+    "  leaf shared { type string { pattern '[a-z]+'; } }"
+    "}";
+
+    root = lyd_parse_mem(st->ctx, pat_xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(root, NULL);
+    lyd_free_withsiblings(root);
+    used = st->ctx->pattern_cache->hash_tab->used;
+    multi_used = st->ctx->pattern_cache->multi_tab->used;
+
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, rm_yang, LYS_IN_YANG), NULL);
+    root = lyd_parse_mem(st->ctx, "<u xmlns=\"urn:rm\">42</u>", LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(root, NULL);
+    lyd_free_withsiblings(root);
+    assert_int_not_equal(st->ctx->pattern_cache->hash_tab->used, used);
+
+    /* only the patterns no other module uses are dropped with the module */
+    assert_int_equal(ly_ctx_remove_module(ly_ctx_get_module(st->ctx, "rm", NULL, 0), NULL), 0);
+    assert_int_equal(st->ctx->pattern_cache->hash_tab->used, used);
+    assert_int_equal(st->ctx->pattern_cache->multi_tab->used, multi_used);
+
+    root = lyd_parse_mem(st->ctx, pat_xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(root, NULL);
+    lyd_free_withsiblings(root);
+}
+
+static void
+test_multi(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *root, *node;
+    const char *xml =
+    "<d1 xmlns=\"urn:multi\">abc</d1>"
+    "<d2 xmlns=\"urn:multi\">abc</d2>"
+    "<d3 xmlns=\"urn:multi\">a1</d3>"
+    "<u xmlns=\"urn:multi\">42</u>"
+    "<u2 xmlns=\"urn:multi\">5</u2>";
+
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, multi_yang, LYS_IN_YANG), NULL);
+    assert_ptr_equal(pat_multi(st, "/multi:d1"), NULL);
+
+    root = lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(root, NULL);
+    LY_TREE_FOR(root, node) {
+        if (!strcmp(node->schema->name, "u")) {
+            assert_int_equal(((struct lyd_node_leaf_list *)node)->value_type, LY_TYPE_STRING);
+        } else if (!strcmp(node->schema->name, "u2")) {
+            assert_int_equal(((struct lyd_node_leaf_list *)node)->value_type, LY_TYPE_INT8);
+        }
+    }
+    lyd_free_withsiblings(root);
+
+    /* the patterns of a type and of its typedefs are combined, the same patterns only once */
+    assert_ptr_not_equal(pat_multi(st, "/multi:d1"), NULL);
+    assert_ptr_not_equal(pat_multi(st, "/multi:d2"), NULL);
+    assert_ptr_not_equal(pat_multi(st, "/multi:d1"), pat_multi(st, "/multi:d2"));
+    assert_ptr_equal(pat_multi(st, "/multi:d2"), pat_multi(st, "/multi:d3"));
+
+    /* and so are the patterns of the union members */
+    assert_ptr_not_equal(pat_multi(st, "/multi:u"), NULL);
+    assert_ptr_not_equal(pat_multi(st, "/multi:u"), pat_multi(st, "/multi:d2"));
+}
+
+static void
+test_multi_freeze(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *root;
+    uint32_t used, multi_used;
+
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, multi_yang, LYS_IN_YANG), NULL);
+    assert_ptr_equal(pat_multi(st, "/multi:d1"), NULL);
+
+    /* freezing the context combines the patterns right away */
+    assert_int_equal(ly_ctx_freeze(st->ctx), 0);
+    assert_ptr_not_equal(pat_multi(st, "/multi:d1"), NULL);
+    assert_ptr_not_equal(pat_multi(st, "/multi:u"), NULL);
+    used = st->ctx->pattern_cache->hash_tab->used;
+    multi_used = st->ctx->pattern_cache->multi_tab->used;
+
+    /* so that the data do not change the cache */
+    root = lyd_parse_mem(st->ctx, "<d1 xmlns=\"urn:multi\">abc</d1><u xmlns=\"urn:multi\">42</u>", LYD_XML,
+                         LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(root, NULL);
+    lyd_free_withsiblings(root);
+    root = lyd_parse_mem(st->ctx, pat_xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(root, NULL);
+    lyd_free_withsiblings(root);
+    assert_int_equal(st->ctx->pattern_cache->hash_tab->used, used);
+    assert_int_equal(st->ctx->pattern_cache->multi_tab->used, multi_used);
+}
+
+#endif
+
+static void *
+parse_thread(void *arg)
+{
+    struct state *st = arg;
+    struct lyd_node *root;
+    int i;
+
+    for (i = 0; i < 10; ++i) {
+        root = lyd_parse_mem(st->ctx, pat_xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+        if (!root) {
+            return (void *)1;
+        }
+        lyd_free_withsiblings(root);
+    }
+
+    return NULL;
+}
+
+static void
+test_threads(void **state)
+{
+    struct state *st = (*state);
+    pthread_t threads[THREAD_COUNT];
+    void *ret;
+    int i;
+
+    /* the patterns are compiled by whichever thread needs them first */
+    for (i = 0; i < THREAD_COUNT; ++i) {
+        assert_int_equal(pthread_create(&threads[i], NULL, parse_thread, st), 0);
+    }
+    for (i = 0; i < THREAD_COUNT; ++i) {
+        assert_int_equal(pthread_join(threads[i], &ret), 0);
+        assert_ptr_equal(ret, NULL);
+    }
+}
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+#ifdef LY_ENABLED_CACHE
+        cmocka_unit_test_setup_teardown(test_uses, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_trusted, setup_trusted_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_shared, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_remove, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_remove, setup_multi_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_multi, setup_multi_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_multi_freeze, setup_multi_f, teardown_f),
+#endif
+        cmocka_unit_test_setup_teardown(test_threads, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_threads, setup_trusted_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_threads, setup_multi_f, teardown_f),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -57,14 +57,17 @@ lyd_hash_check(struct lyd_node *node)
         }
 
         if (i >= LY_CACHE_HT_MIN_CHILDREN) {
-            assert(node->ht && (node->ht->used == i));
+            assert(node->ht);
+        } else if (i < LY_CACHE_HT_FREE_CHILDREN) {
+            assert(!node->ht);
+        }
+        if (node->ht) {
+            assert(node->ht->used == i);
             LY_TREE_FOR(node->child, iter) {
                 if ((iter->schema->nodetype != LYS_LIST) || lyd_list_has_keys(iter)) {
                     assert(!lyht_find(node->ht, &iter, iter->hash, NULL));
                 }
             }
-        } else {
-            assert(!node->ht);
         }
 
         LY_TREE_FOR(node->child, iter) {
@@ -108,6 +111,40 @@ test_hash(void **state)
     lyd_hash_check(st->root1);
 }
 
+static void
+test_hash_threshold(void **state)
+{
+    struct lyd_node *root;
+    struct state *st = (*state);
+    char val[16];
+    int i;
+
+    root = lyd_new_path(NULL, st->ctx, "/state-lists:cont", NULL, 0, 0);
+    assert_non_null(root);
+
+    /* the hash table is created only for enough children */
+    for (i = 0; i < LY_CACHE_HT_MIN_CHILDREN - 1; ++i) {
+        sprintf(val, "v%d", i);
+        assert_non_null(lyd_new_leaf(root, NULL, "ll", val));
+    }
+    assert_null(root->ht);
+    assert_non_null(lyd_new_leaf(root, NULL, "ll", "last"));
+    assert_non_null(root->ht);
+    lyd_hash_check(root);
+
+    /* and it is kept until there are much fewer of them */
+    for (i = LY_CACHE_HT_MIN_CHILDREN; i > LY_CACHE_HT_FREE_CHILDREN; --i) {
+        lyd_free(root->child);
+    }
+    assert_non_null(root->ht);
+    lyd_hash_check(root);
+    lyd_free(root->child);
+    assert_null(root->ht);
+    lyd_hash_check(root);
+
+    lyd_free(root);
+}
+
 #endif
 
 static int
@@ -475,6 +512,7 @@ int main(void)
     const struct CMUnitTest tests[] = {
 #ifdef LY_ENABLED_CACHE
                     cmocka_unit_test_setup_teardown(test_hash, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_hash_threshold, setup_f, teardown_f),
 #endif
                     cmocka_unit_test_setup_teardown(test_merge_same, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_merge_equal_leaflist, setup_f, teardown_f),
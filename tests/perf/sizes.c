@@ -2,8 +2,10 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "../../src/tree_schema.h"
-#include "../../src/tree_data.h"
+/* generated libyang.h from the build directory, it includes the tree headers from the sources */
+#include "libyang.h"
+
+#define MSIZE(type, member) sizeof(((type *)0)->member)
 
 int main(int argc, char *argv[])
 {
@@ -62,6 +64,28 @@ int main(int argc, char *argv[])
     fprintf(stdout, "%8lu struct lyd_difflist\n", x = sizeof(struct lyd_difflist)); suma += x;
     fprintf(stdout, "DATA TREE SUM %8lu\n\n", suma);
 
+    /* members of the common data node header (the flag bitfields share a single byte) */
+    suma = MSIZE(struct lyd_node, schema) + MSIZE(struct lyd_node, validity) + 1
+           + MSIZE(struct lyd_node, attr) + MSIZE(struct lyd_node, next) + MSIZE(struct lyd_node, prev)
+           + MSIZE(struct lyd_node, parent);
+#ifdef LY_ENABLED_LYD_PRIV
+    suma += MSIZE(struct lyd_node, priv);
+#endif
+#ifdef LY_ENABLED_CACHE
+    suma += MSIZE(struct lyd_node, hash);
+#endif
+    fprintf(stdout, "%8lu struct lyd_node padding\n", sizeof(struct lyd_node) - suma - MSIZE(struct lyd_node, child)
+#ifdef LY_ENABLED_CACHE
+            - MSIZE(struct lyd_node, ht)
+#endif
+            );
+    fprintf(stdout, "%8lu struct lyd_node_leaf_list padding\n", sizeof(struct lyd_node_leaf_list) - suma
+            - MSIZE(struct lyd_node_leaf_list, value_str) - MSIZE(struct lyd_node_leaf_list, value)
+            - MSIZE(struct lyd_node_leaf_list, value_type) - MSIZE(struct lyd_node_leaf_list, value_flags));
+    fprintf(stdout, "%8lu struct lyd_node_anyxml padding\n", sizeof(struct lyd_node_anydata) - suma
+            - MSIZE(struct lyd_node_anydata, value_type) - MSIZE(struct lyd_node_anydata, value));
+    fprintf(stdout, "%8lu bytes per 1000 leaves\n\n", 1000 * sizeof(struct lyd_node_leaf_list));
+
 	return 0;
 }
 